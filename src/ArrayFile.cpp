@@ -0,0 +1,114 @@
+/**
+ *		@file 		ArrayFile.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Loading arrays of input values from binary or CSV files
+ */
+
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+#include "ArrayFile.hpp"
+#include "BlockEditorException.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  /**
+   * @brief Checks whether file holds values as text (by extension .csv/.txt)
+   * @param fileName Name of file
+   * @return true if file is CSV, false if it is binary
+   */
+  bool isCsvFile(const std::string& fileName)
+  {
+    auto dot = fileName.rfind('.');
+    if (dot == std::string::npos)
+    {
+      return false;
+    }
+
+    std::string ext = fileName.substr(dot + 1);
+    for (auto& c : ext)
+      c = tolower(c);
+
+    return ext == "csv" || ext == "txt";
+  }
+
+  /**
+   * @brief Loads array of values from file. CSV files hold numbers separated
+   *        by commas, semicolons or whitespace, other files are read as raw
+   *        doubles in native byte order.
+   * @param fileName Name of file with values
+   * @return Loaded array
+   */
+  PortArrayPtr loadArrayFile(const std::string& fileName)
+  {
+    auto pa = std::make_shared<PortArray>();
+    std::ifstream fd;
+
+    if (isCsvFile(fileName))
+    {
+      fd.open(fileName);
+      if (!fd.is_open())
+      {
+        throw CBlockEditorException(std::string("Could not open file with values " + fileName), EErrorCode::E_UI_BAD_FILE);
+      }
+
+      std::stringstream ss;
+      ss << fd.rdbuf();
+      std::string content = ss.str();
+
+      const char *it = content.c_str();
+      const char *end = it + content.size();
+      while (it < end)
+      {
+        if (*it == ',' || *it == ';' || isspace(static_cast<unsigned char>(*it)))
+        {
+          it++;
+          continue;
+        }
+
+        char *next;
+        PortValue pv = strtod(it, &next);
+        if (next == it)
+        {
+          throw CBlockEditorException(std::string("Bad value in file " + fileName + " at offset "
+                    + std::to_string(it - content.c_str())), EErrorCode::E_UI_BAD_FILE);
+        }
+        pa->push_back(pv);
+        it = next;
+      }
+    }
+    else
+    {
+      fd.open(fileName, std::ios::binary | std::ios::ate);
+      if (!fd.is_open())
+      {
+        throw CBlockEditorException(std::string("Could not open file with values " + fileName), EErrorCode::E_UI_BAD_FILE);
+      }
+
+      std::streamsize size = fd.tellg();
+      if (size % sizeof(PortValue) != 0)
+      {
+        throw CBlockEditorException(std::string("Size of binary file " + fileName
+                  + " is not multiple of value size"), EErrorCode::E_UI_BAD_FILE);
+      }
+
+      pa->resize(size / sizeof(PortValue));
+      fd.seekg(0);
+      fd.read(reinterpret_cast<char*>(pa->data()), size);
+    }
+
+    fd.close();
+
+    if (pa->empty())
+    {
+      throw CBlockEditorException(std::string("File " + fileName + " contains no values"), EErrorCode::E_UI_BAD_FILE);
+    }
+
+    return pa;
+  }
+}
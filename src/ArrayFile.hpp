@@ -0,0 +1,21 @@
+/**
+ *		@file 		ArrayFile.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Loading arrays of input values from binary or CSV files
+ */
+
+#pragma once
+
+#include <string>
+
+#include "Port.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  PortArrayPtr  loadArrayFile(const std::string&);
+  bool          isCsvFile(const std::string&);
+}
@@ -0,0 +1,418 @@
+/**
+ *		@file 		ArrayOperation.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Operations of blocks over values and element-wise over arrays of values
+ */
+
+#include <math.h>
+#include <algorithm>
+#include <sstream>
+
+#include "ArrayOperation.hpp"
+#include "BlockEditorException.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  ///
+  /// Kernels are kept as plain loops over contiguous memory with the switch
+  /// hoisted out of them, so the compiler can vectorize each of them.
+  /// Null operand array means the operand is scalar and it's broadcast.
+  ///
+  namespace
+  {
+    template <typename Op>
+    void applyKernel(const PortValue *a, PortValue sa, const PortValue *b,
+                     PortValue sb, PortValue *out, std::size_t n, Op op)
+    {
+      if (a && b)
+      {
+        for (std::size_t i = 0; i < n; i++)
+          out[i] = op(a[i], b[i]);
+      }
+      else if (a)
+      {
+        for (std::size_t i = 0; i < n; i++)
+          out[i] = op(a[i], sb);
+      }
+      else
+      {
+        for (std::size_t i = 0; i < n; i++)
+          out[i] = op(sa, b[i]);
+      }
+    }
+
+    ///
+    /// Reductions go left to right, so SUM of a chain of ADD blocks gives
+    /// the very same result as the chain. Only MIN and MAX, whose result
+    /// doesnt depend on order, keep independent partial results which
+    /// the compiler can put to vector lanes. Arrays are reduced one input
+    /// at a time over all elements, which vectorizes for any operation.
+    ///
+    const std::size_t LANES = 4;
+
+    /// Inputs summed left to right at the bottom of pairwise summation
+    const std::size_t PAIRWISE_BLOCK = 8;
+
+    auto opAdd = [](PortValue x, PortValue y) { return x + y; };
+    auto opMul = [](PortValue x, PortValue y) { return x * y; };
+    auto opMin = [](PortValue x, PortValue y) { return y < x ? y : x; };
+    auto opMax = [](PortValue x, PortValue y) { return y > x ? y : x; };
+
+    template <typename Op>
+    PortValue fold(const PortValue *v, std::size_t n, Op op)
+    {
+      PortValue acc = v[0];
+      for (std::size_t i = 1; i < n; i++)
+        acc = op(acc, v[i]);
+      return acc;
+    }
+
+    template <typename Op>
+    PortValue foldLanes(const PortValue *v, std::size_t n, Op op)
+    {
+      PortValue lane[LANES] = {v[0], v[0], v[0], v[0]};
+      std::size_t i = 0;
+      for (; i + LANES <= n; i += LANES)
+      {
+        for (std::size_t l = 0; l < LANES; l++)
+          lane[l] = op(lane[l], v[i + l]);
+      }
+      for (; i < n; i++)
+        lane[0] = op(lane[0], v[i]);
+      return op(op(lane[0], lane[1]), op(lane[2], lane[3]));
+    }
+
+    PortValue sumKahan(const PortValue *v, std::size_t n)
+    {
+      PortValue sum = .0, c = .0;
+      for (std::size_t i = 0; i < n; i++)
+      {
+        PortValue y = v[i] - c;
+        PortValue t = sum + y;
+        c = (t - sum) - y;
+        sum = t;
+      }
+      return sum;
+    }
+
+    PortValue sumPairwise(const PortValue *v, std::size_t n)
+    {
+      if (n <= PAIRWISE_BLOCK)
+      {
+        return fold(v, n, opAdd);
+      }
+      std::size_t half = n / 2;
+      return sumPairwise(v, half) + sumPairwise(v + half, n - half);
+    }
+
+    /// Sets all elements to the operand
+    void assign(PortValue *out, const ReduceOperand& a, std::size_t n)
+    {
+      if (a.m_array)
+        std::copy(a.m_array->begin(), a.m_array->end(), out);
+      else
+        std::fill(out, out + n, a.m_value);
+    }
+
+    /// Combines each element with the operand
+    template <typename Op>
+    void accumulate(PortValue *out, const ReduceOperand& b, std::size_t n, Op op)
+    {
+      if (b.m_array)
+      {
+        const PortValue *p = b.m_array->data();
+        for (std::size_t i = 0; i < n; i++)
+          out[i] = op(out[i], p[i]);
+      }
+      else
+      {
+        PortValue v = b.m_value;
+        for (std::size_t i = 0; i < n; i++)
+          out[i] = op(out[i], v);
+      }
+    }
+
+    /// Adds operand to each element, c keeps lost low bits of each element
+    void accumulateKahan(PortValue *out, PortValue *c, const ReduceOperand& b, std::size_t n)
+    {
+      if (b.m_array)
+      {
+        const PortValue *p = b.m_array->data();
+        for (std::size_t i = 0; i < n; i++)
+        {
+          PortValue y = p[i] - c[i];
+          PortValue t = out[i] + y;
+          c[i] = (t - out[i]) - y;
+          out[i] = t;
+        }
+      }
+      else
+      {
+        for (std::size_t i = 0; i < n; i++)
+        {
+          PortValue y = b.m_value - c[i];
+          PortValue t = out[i] + y;
+          c[i] = (t - out[i]) - y;
+          out[i] = t;
+        }
+      }
+    }
+
+    /// Pairwise summation of operands, element-wise
+    void sumPairwise(const ReduceOperand *ops, std::size_t count, PortValue *out, std::size_t n)
+    {
+      if (count <= PAIRWISE_BLOCK)
+      {
+        assign(out, ops[0], n);
+        for (std::size_t k = 1; k < count; k++)
+          accumulate(out, ops[k], n, opAdd);
+        return;
+      }
+
+      std::size_t half = count / 2;
+      PortArray rest(n);
+      sumPairwise(ops, half, out, n);
+      sumPairwise(ops + half, count - half, rest.data(), n);
+      accumulate(out, ReduceOperand{&rest, .0}, n, opAdd);
+    }
+  }
+
+  /**
+   * @brief Length of arrays of binary operation, checks they are equal
+   * @param a1 Operand #1 array, nullptr if operand is scalar
+   * @param a2 Operand #2 array, nullptr if operand is scalar
+   * @return Length of the arrays
+   */
+  std::size_t arrayLength(const PortArrayPtr& a1, const PortArrayPtr& a2)
+  {
+    if (!a1 && !a2)
+    {
+      throw CBlockEditorException("Array operation without array operand", EErrorCode::E_INTERN);
+    }
+    if (a1 && a2 && a1->size() != a2->size())
+    {
+      throw CBlockEditorException(std::string("Arrays on input ports differ in length (")
+                + std::to_string(a1->size()) + " and " + std::to_string(a2->size()) + ")",
+                EErrorCode::E_UI_BAD_SIZE);
+    }
+    return a1 ? a1->size() : a2->size();
+  }
+
+  /**
+   * @brief Length of arrays of reduction, checks they are equal
+   * @param ops Inputs of reduction, at least one of them is array
+   * @return Length of the arrays
+   */
+  std::size_t arrayLength(const std::vector<ReduceOperand>& ops)
+  {
+    const PortArray *first = nullptr;
+    for (auto& op : ops)
+    {
+      if (!op.m_array)
+      {
+        continue;
+      }
+      if (!first)
+      {
+        first = op.m_array;
+      }
+      else if (op.m_array->size() != first->size())
+      {
+        throw CBlockEditorException(std::string("Arrays on input ports differ in length (")
+                  + std::to_string(first->size()) + " and " + std::to_string(op.m_array->size()) + ")",
+                  EErrorCode::E_UI_BAD_SIZE);
+      }
+    }
+    if (!first)
+    {
+      throw CBlockEditorException("Array operation without array operand", EErrorCode::E_INTERN);
+    }
+    return first->size();
+  }
+
+  /**
+   * @brief Performs operation due to type of block
+   * @param bt Type of block
+   * @param pv1 Operand #1
+   * @param pv2 Operand #2
+   * @return Result of operation
+   */
+  PortValue performScalarOperation(EBlockType bt, PortValue pv1, PortValue pv2)
+  {
+    switch (bt)
+    {
+      case BT_ADD:
+        return pv1 + pv2;
+      case BT_SUB:
+        return pv1 - pv2;
+      case BT_MUL:
+        return pv1 * pv2;
+      case BT_DIV:
+        return pv1 / pv2;
+      case BT_POW:
+        return pow(pv1, pv2);
+      default:
+        throw CBlockEditorException("Unknown type of block", EErrorCode::E_INTERN);
+    }
+  }
+
+  /**
+   * @brief Performs operation due to type of block element-wise
+   * @param bt Type of block
+   * @param a1 Operand #1 array, nullptr if operand is scalar
+   * @param v1 Operand #1 scalar value
+   * @param a2 Operand #2 array, nullptr if operand is scalar
+   * @param v2 Operand #2 scalar value
+   * @return Array of results
+   */
+  PortArrayPtr performArrayOperation(EBlockType bt, const PortArrayPtr& a1, PortValue v1,
+                                     const PortArrayPtr& a2, PortValue v2)
+  {
+    std::size_t n = arrayLength(a1, a2);
+    const PortValue *p1 = a1 ? a1->data() : nullptr;
+    const PortValue *p2 = a2 ? a2->data() : nullptr;
+    auto result = std::make_shared<PortArray>(n);
+    PortValue *out = result->data();
+
+    switch (bt)
+    {
+      case BT_ADD:
+        applyKernel(p1, v1, p2, v2, out, n, [](PortValue x, PortValue y) { return x + y; });
+        break;
+      case BT_SUB:
+        applyKernel(p1, v1, p2, v2, out, n, [](PortValue x, PortValue y) { return x - y; });
+        break;
+      case BT_MUL:
+        applyKernel(p1, v1, p2, v2, out, n, [](PortValue x, PortValue y) { return x * y; });
+        break;
+      case BT_DIV:
+        applyKernel(p1, v1, p2, v2, out, n, [](PortValue x, PortValue y) { return x / y; });
+        break;
+      case BT_POW:
+        applyKernel(p1, v1, p2, v2, out, n, [](PortValue x, PortValue y) { return pow(x, y); });
+        break;
+      default:
+        throw CBlockEditorException("Unknown type of block", EErrorCode::E_INTERN);
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Reduces values of all inputs of reduction block
+   * @param bt Type of block
+   * @param v Values of inputs in order of ports
+   * @param n Count of inputs
+   * @param mode Order of summation, used by SUM only
+   * @return Result of reduction
+   */
+  PortValue performScalarReduction(EBlockType bt, const PortValue *v, std::size_t n, EReduceMode mode)
+  {
+    if (n == 0)
+    {
+      throw CBlockEditorException("Reduction without inputs", EErrorCode::E_INTERN);
+    }
+
+    switch (bt)
+    {
+      case BT_SUM:
+        if (mode == RM_KAHAN)
+          return sumKahan(v, n);
+        if (mode == RM_PAIRWISE)
+          return sumPairwise(v, n);
+        return fold(v, n, opAdd);
+      case BT_PRODUCT:
+        return fold(v, n, opMul);
+      case BT_MIN:
+        return foldLanes(v, n, opMin);
+      case BT_MAX:
+        return foldLanes(v, n, opMax);
+      default:
+        throw CBlockEditorException("Unknown type of block", EErrorCode::E_INTERN);
+    }
+  }
+
+  /**
+   * @brief Reduces inputs of reduction block element-wise
+   * @param bt Type of block
+   * @param ops Inputs in order of ports, at least one of them is array
+   * @param mode Order of summation, used by SUM only
+   * @return Array of results
+   */
+  PortArrayPtr performArrayReduction(EBlockType bt, const std::vector<ReduceOperand>& ops,
+                                     EReduceMode mode)
+  {
+    std::size_t n = arrayLength(ops);
+    auto result = std::make_shared<PortArray>(n);
+    PortValue *out = result->data();
+
+    auto reduce = [&ops, out, n](auto op) {
+      assign(out, ops[0], n);
+      for (std::size_t k = 1; k < ops.size(); k++)
+        accumulate(out, ops[k], n, op);
+    };
+
+    switch (bt)
+    {
+      case BT_SUM:
+        if (mode == RM_KAHAN)
+        {
+          PortArray c(n, .0);
+          assign(out, ops[0], n);
+          for (std::size_t k = 1; k < ops.size(); k++)
+            accumulateKahan(out, c.data(), ops[k], n);
+        }
+        else if (mode == RM_PAIRWISE)
+        {
+          sumPairwise(ops.data(), ops.size(), out, n);
+        }
+        else
+        {
+          reduce(opAdd);
+        }
+        break;
+      case BT_PRODUCT:
+        reduce(opMul);
+        break;
+      case BT_MIN:
+        reduce(opMin);
+        break;
+      case BT_MAX:
+        reduce(opMax);
+        break;
+      default:
+        throw CBlockEditorException("Unknown type of block", EErrorCode::E_INTERN);
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Creates short description of array, used instead of the full array in UI
+   * @param pa Array to describe
+   * @return Summary eg. "[1000] min: 0, max: 999, mean: 499.5"
+   */
+  std::string summarizeArray(const PortArray& pa)
+  {
+    std::ostringstream os;
+
+    os << "[" << pa.size() << "]";
+    if (pa.empty())
+    {
+      return os.str();
+    }
+
+    auto mm = std::minmax_element(pa.begin(), pa.end());
+    PortValue sum = .0;
+    for (auto v : pa)
+      sum += v;
+
+    os << " min: " << *mm.first << ", max: " << *mm.second
+       << ", mean: " << sum / pa.size();
+    return os.str();
+  }
+}
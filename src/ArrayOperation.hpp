@@ -0,0 +1,41 @@
+/**
+ *		@file 		ArrayOperation.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Operations of blocks over values and element-wise over arrays of values
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "BlockType.hpp"
+#include "Port.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  ///
+  /// Input of reduction, array or scalar broadcast to length of the arrays
+  ///
+  struct ReduceOperand
+  {
+    const PortArray *m_array = nullptr;
+    PortValue       m_value = .0;
+    PortInt         m_integer = 0;    /**< Scalar of INT & HEX block, see IntegerOperation.hpp */
+  };
+
+  std::size_t   arrayLength(const PortArrayPtr&, const PortArrayPtr&);
+  std::size_t   arrayLength(const std::vector<ReduceOperand>&);
+
+  PortValue     performScalarOperation(EBlockType, PortValue, PortValue);
+  PortArrayPtr  performArrayOperation(EBlockType, const PortArrayPtr&, PortValue,
+                                      const PortArrayPtr&, PortValue);
+  PortValue     performScalarReduction(EBlockType, const PortValue*, std::size_t, EReduceMode);
+  PortArrayPtr  performArrayReduction(EBlockType, const std::vector<ReduceOperand>&, EReduceMode);
+
+  std::string   summarizeArray(const PortArray&);
+}
@@ -7,6 +7,8 @@
  */
 
 #include "Block.hpp"
+#include "IntegerOperation.hpp"
+#include "SchemeMemory.hpp"
 
 ///
 /// Namespace with implementation of logic of an application
@@ -57,14 +59,32 @@ namespace BlockEditorLogic
     os << "Position X:"  << block.m_x << std::endl;
     os << "Position Y:"  << block.m_y << std::endl;
     os << "Type name:" << block.m_name << std::endl;
-    os << "Input value:" << ((block.getType() == BT_INPUT) ?
+    if (block.m_macro)
+    {
+      os << "Macro:"     << block.m_macro->getName() << std::endl;
+    }
+    os << "Input value:" << ((block.getType() == BT_INPUT && !block.hasArray()) ?
           std::to_string(block.getValue()) : "None") << std::endl;
+    if (block.hasArray())
+    {
+      os << "Input file:" << block.getSource() << std::endl;
+    }
     os << "Input 1 ID:"  << ((block.hasPort(Ports::P_INPUT1)) ?
           std::to_string(block.getPortID(Ports::P_INPUT1)) :
           "None") <<  std::endl;
     os << "Input 2 ID:"  << ((block.hasPort(Ports::P_INPUT2)) ?
           std::to_string(block.getPortID(Ports::P_INPUT2)) :
           "None") <<  std::endl;
+    for (size_t n = 3; n <= block.getInputCount(); n++)
+    {
+      os << "Input " << n << " ID:" << ((block.hasPort(inputPort(n))) ?
+            std::to_string(block.getPortID(inputPort(n))) :
+            "None") << std::endl;
+    }
+    if (block.m_mode != RM_PLAIN)
+    {
+      os << "Reduction:" << (block.m_mode == RM_KAHAN ? "kahan" : "pairwise") << std::endl;
+    }
     os << "Output ID:"   << ((block.hasPort(Ports::P_OUTPUT)) ?
           std::to_string(block.getPortID(Ports::P_OUTPUT)) :
           "None") <<  std::endl;
@@ -86,9 +106,64 @@ namespace BlockEditorLogic
          return m_inputPort2;
        case Ports::P_OUTPUT:
          return m_outputPort;
+       default:
+         return moreInput(whichPort);
      }
    }
 
+  /**
+   * @brief Input port past the second
+   * @param whichPort Input port from P_INPUT3 on
+   * @return The port, nullptr if it isnt connected or block hasnt it
+   */
+  CPort* CBlock::moreInput(Ports whichPort) const
+  {
+    size_t k = inputNumber(whichPort) - 3;
+    return k < m_moreInputs.size() ? m_moreInputs[k] : nullptr;
+  }
+
+  /**
+   * @brief Count of input ports, connected or not
+   * @return 2 for all blocks but reductions and macros
+   */
+  size_t CBlock::getInputCount() const
+  {
+    return m_macro ? m_macro->getInputCount() : 2 + m_moreInputs.size();
+  }
+
+  /**
+   * @brief Sets count of input ports of reduction block, dropped ports
+   *        are forgotten, caller disconnects them first
+   * @param count Count of input ports, 2 at least
+   */
+  void CBlock::setInputCount(size_t count)
+  {
+    m_moreInputs.resize(count > 2 ? count - 2 : 0, nullptr);
+  }
+
+  /**
+   * @brief Checks if blocks of the type have the input port
+   * @param bt Type of block
+   * @param whichPort Which port
+   * @return Yes or not
+   */
+  bool CBlock::acceptsInput(EBlockType bt, Ports whichPort)
+  {
+    size_t n = inputNumber(whichPort);
+    return bt != BT_INPUT && n >= 1 && (n <= 2 || ((isReduction(bt) || bt == BT_MACRO) && n <= MAX_INPUTS));
+  }
+
+  /**
+   * @brief Checks if the block has the input port, macro block has as
+   *        many inputs as its definition
+   * @param whichPort Which port
+   * @return Yes or not
+   */
+  bool CBlock::acceptsInput(Ports whichPort) const
+  {
+    return acceptsInput(m_bt, whichPort) && (!m_macro || inputNumber(whichPort) <= m_macro->getInputCount());
+  }
+
    /**
     * @brief Get function
     * @return Name of type of block
@@ -106,21 +181,31 @@ namespace BlockEditorLogic
     */
    PortValue CBlock::performOperation(PortValue&& pv1, PortValue&& pv2)
    {
-     switch(this->m_bt)
+     if (m_name == TN_INTEGER || m_name == TN_HEXA)
      {
-       case BT_ADD:
-         return pv1 + pv2;
-       case BT_SUB:
-         return pv1 - pv2;
-       case BT_MUL:
-         return pv1 * pv2;
-       case BT_DIV:
-         return pv1 / pv2;
-       case BT_POW:
-          return pow(pv1, pv2);
-        default:
-          throw CBlockEditorException("Unknown type of block", EErrorCode::E_INTERN);
+       return static_cast<PortValue>(performIntegerOperation(this->m_bt, toInteger(pv1), toInteger(pv2)));
      }
+     return performScalarOperation(this->m_bt, pv1, pv2);
+   }
+
+   /**
+    * @brief Function performs operation due to type of block element-wise,
+    *        at least one of operands has to be array, the other is broadcast
+    * @param pa1 Operand #1 array or nullptr
+    * @param pv1 Operand #1 if it isnt array
+    * @param pa2 Operand #2 array or nullptr
+    * @param pv2 Operand #2 if it isnt array
+    * @return Array of results
+    */
+   PortArrayPtr CBlock::performOperation(const PortArrayPtr& pa1, PortValue pv1,
+                                         const PortArrayPtr& pa2, PortValue pv2)
+   {
+     if (m_name == TN_INTEGER || m_name == TN_HEXA)
+     {
+       return performIntegerArrayOperation(this->m_bt, pa1, pa1 ? 0 : toInteger(pv1),
+                                           pa2, pa2 ? 0 : toInteger(pv2));
+     }
+     return performArrayOperation(this->m_bt, pa1, pv1, pa2, pv2);
    }
 
   /**
@@ -141,6 +226,44 @@ namespace BlockEditorLogic
     return this->m_bt;
   }
 
+  /**
+   * @brief Get function
+   * @return Order of summation of SUM block
+   */
+  EReduceMode CBlock::getReduceMode() const
+  {
+    return this->m_mode;
+  }
+
+  /**
+   * @brief Set function
+   * @param mode Order of summation, used by SUM blocks
+   */
+  void CBlock::setReduceMode(EReduceMode mode)
+  {
+    this->m_mode = mode;
+  }
+
+  /**
+   * @brief Get function
+   * @return Definition of macro block, nullptr for other blocks
+   */
+  MacroPtr CBlock::getMacro() const
+  {
+    return this->m_macro;
+  }
+
+  /**
+   * @brief Makes the block instance of macro, ports past the count of
+   *        inputs of definition are forgotten, caller disconnects them first
+   * @param macro Definition of macro
+   */
+  void CBlock::setMacro(MacroPtr macro)
+  {
+    this->m_macro = std::move(macro);
+    setInputCount(m_macro->getInputCount());
+  }
+
   /**
    * @brief Get function
    * @return Position of the block
@@ -160,6 +283,17 @@ namespace BlockEditorLogic
      this->m_y = coords.second;
    }
 
+  /**
+   * @brief Memory of names and port list owned by block, array and ports
+   *        are not included
+   * @return Bytes allocated by block
+   */
+  uint64_t CBlock::getHeapBytes() const
+  {
+    return CMemoryCounter::stringBytes(m_name) + CMemoryCounter::stringBytes(m_source)
+         + CMemoryCounter::vectorBytes(m_moreInputs);
+  }
+
   /**
    * @brief Creates output port
    * @return New port
@@ -180,6 +314,17 @@ namespace BlockEditorLogic
     this->m_value = value;
   }
 
+  /**
+   * @brief Inits input block array of values
+   * @param pa Array of values to assign
+   * @param source File the values were loaded from
+   */
+  void CBlock::setInputArray(PortArrayPtr pa, std::string source)
+  {
+    this->m_array = std::move(pa);
+    this->m_source = std::move(source);
+  }
+
   /**
    * @brief Get function
    * @return Value of input block
@@ -190,7 +335,35 @@ namespace BlockEditorLogic
   }
 
   /**
-   * @brief Assigns input port
+   * @brief Get function
+   * @return Array of values of input block, nullptr if block holds single value
+   */
+  PortArrayPtr CBlock::getArray() const
+  {
+    return this->m_array;
+  }
+
+  /**
+   * @brief Get function
+   * @return File which array of values of input block was loaded from
+   */
+  std::string CBlock::getSource() const
+  {
+    return this->m_source;
+  }
+
+  /**
+   * @brief Checks if input block holds array of values
+   * @return Yes or not
+   */
+  bool CBlock::hasArray() const
+  {
+    return this->m_array != nullptr;
+  }
+
+  /**
+   * @brief Assigns input port, reduction block gets more inputs if it
+   *        hasnt the port yet
    * @param whichPort Which of the input ports
    * @param port Port to assign
    */
@@ -200,10 +373,19 @@ namespace BlockEditorLogic
     {
       m_inputPort1 = port;
     }
-    else
+    else if (whichPort == Ports::P_INPUT2)
     {
       m_inputPort2 = port;
     }
+    else
+    {
+      size_t k = inputNumber(whichPort) - 3;
+      if (k >= m_moreInputs.size())
+      {
+        m_moreInputs.resize(k + 1, nullptr);
+      }
+      m_moreInputs[k] = port;
+    }
   }
 
   /**
@@ -224,6 +406,9 @@ namespace BlockEditorLogic
         delete m_outputPort;
         m_outputPort = nullptr;
         break;
+      default:
+        setPort(whichPort);
+        break;
     }
   }
 
@@ -243,6 +428,15 @@ namespace BlockEditorLogic
       case Ports::P_OUTPUT:
         m_outputPort = static_cast<CPort*>(ptr);
         break;
+      default:
+      {
+        size_t k = inputNumber(whichPort) - 3;
+        if (k < m_moreInputs.size())
+        {
+          m_moreInputs[k] = static_cast<CPort*>(ptr);
+        }
+        break;
+      }
     }
   }
 
@@ -267,6 +461,8 @@ namespace BlockEditorLogic
         if (m_outputPort == nullptr)
           return false;
         return true;
+      default:
+        return moreInput(whichPort) != nullptr;
     }
   }
 
@@ -285,6 +481,8 @@ namespace BlockEditorLogic
         return m_inputPort2->getPortID();
       case Ports::P_OUTPUT:
         return m_outputPort->getPortID();
+      default:
+        return moreInput(whichPort)->getPortID();
     }
   }
 }
\ No newline at end of file
@@ -8,11 +8,14 @@
 
 #include <iostream>
 #include <math.h>
+#include <vector>
 
 #include "BlockType.hpp"
 #include "Port.hpp"
+#include "ArrayOperation.hpp"
 #include "TypeName.hpp"
 #include "BlockEditorException.hpp"
+#include "MacroDefinition.hpp"
 
 ///
 /// Namespace with implementation of logic of an application
@@ -40,31 +43,53 @@ namespace BlockEditorLogic
 		void     setPort(Ports whichPort, void *ptr = nullptr);
 		bool     hasPort(Ports whichPort) const;
 		CPort*   getPort(Ports whichPort) const;
+		size_t   getInputCount() const;
+		void     setInputCount(size_t);
+		static bool acceptsInput(EBlockType, Ports whichPort);
+		bool     acceptsInput(Ports whichPort) const;
 
 		virtual
 		PortValue   performOperation(PortValue&& pv1, PortValue&& pv2);
+		virtual
+		PortArrayPtr performOperation(const PortArrayPtr& pa1, PortValue pv1,
+		                              const PortArrayPtr& pa2, PortValue pv2);
 
 		void        setInputValue(PortValue);
+		void        setInputArray(PortArrayPtr, std::string);
 		PortValue   getValue() const;
+		PortArrayPtr getArray() const;
+		std::string getSource() const;
+		bool        hasArray() const;
 		TypeName    getTypeName() const;
 		ID          getPortID(Ports whichPort) const;
 		ID          getID() const;
 		EBlockType  getType() const;
 		std::pair<int, int> getPosition() const;
 		void        setPosition(std::pair<int, int>);
+		EReduceMode getReduceMode() const;
+		void        setReduceMode(EReduceMode);
+		MacroPtr    getMacro() const;
+		void        setMacro(MacroPtr);
+		uint64_t    getHeapBytes() const;
 
 	protected:
 		ID          m_blockID;         /**< Unique ID */
 		EBlockType  m_bt;              /**< Type of block {ADD|SUB|etc.} */
 		int         m_x, m_y;          /**< Position of block in scheme */
 		PortValue   m_value = .0;      /**< Value of input port */
+		PortArrayPtr m_array;          /**< Values of input port, if it carries array */
+		std::string m_source;          /**< File the array of values was loaded from */
 
 		CPort       *m_inputPort1;
 		CPort       *m_inputPort2;     /**< Input ports */
 		CPort       *m_outputPort;     /**< Output port */
+		std::vector<CPort*> m_moreInputs; /**< Inputs past the second, reduction blocks only */
+		EReduceMode m_mode = RM_PLAIN; /**< Order of summation of SUM block */
+		MacroPtr    m_macro;           /**< Definition of macro block, shared by its instances */
 
 		TypeName    m_name;            /**< Name of type of this block */
 	private:
+		CPort*      moreInput(Ports whichPort) const;
 
 	};
 }
\ No newline at end of file
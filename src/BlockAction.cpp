@@ -15,18 +15,62 @@ namespace BlockEditorLogic
 {
   CBlockAction::CBlockAction(ID id, PortValue pv)
     : m_id{id}
+    , m_integer{false}
     , m_pv{pv}
   {
 
   }
 
+  CBlockAction::CBlockAction(ID id, PortArrayPtr pa)
+    : m_id{id}
+    , m_integer{false}
+    , m_pv{.0}
+    , m_pa{std::move(pa)}
+  {
+
+  }
+
+  CBlockAction::CBlockAction(ID id, PortInt pi)
+    : m_id{id}
+    , m_integer{true}
+    , m_pi{pi}
+  {
+
+  }
+
   ID CBlockAction::getID() const
   {
     return this->m_id;
   }
 
+  /**
+   * @return Value, result of INT & HEX block is rounded above 2^53
+   */
   PortValue CBlockAction::getValue() const
   {
-    return this->m_pv;
+    return this->m_integer ? static_cast<PortValue>(this->m_pi) : this->m_pv;
+  }
+
+  /**
+   * @return Exact value of INT & HEX block, truncated value otherwise
+   */
+  PortInt CBlockAction::getInteger() const
+  {
+    return this->m_integer ? this->m_pi : static_cast<PortInt>(this->m_pv);
+  }
+
+  PortArrayPtr CBlockAction::getArray() const
+  {
+    return this->m_pa;
+  }
+
+  bool CBlockAction::hasArray() const
+  {
+    return this->m_pa != nullptr;
+  }
+
+  bool CBlockAction::isInteger() const
+  {
+    return this->m_integer;
   }
 }
\ No newline at end of file
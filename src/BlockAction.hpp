@@ -23,13 +23,25 @@ namespace BlockEditorLogic
   public:
     CBlockAction() = delete;
     CBlockAction(ID, PortValue pv = 0.0);
+    CBlockAction(ID, PortArrayPtr);
+    CBlockAction(ID, PortInt);
     ~CBlockAction() = default;
 
     ID              getID() const;
     PortValue       getValue() const;
+    PortInt         getInteger() const;
+    PortArrayPtr    getArray() const;
+    bool            hasArray() const;
+    bool            isInteger() const;
 
   private:
-    ID            m_id; /**< ID of block */
-    PortValue     m_pv; /**< In some cases we need value */
+    ID            m_id;         /**< ID of block */
+    bool          m_integer;    /**< Value is exact integer of INT & HEX block */
+    union
+    {
+      PortValue   m_pv;         /**< In some cases we need value */
+      PortInt     m_pi;         /**< The same of INT & HEX block */
+    };
+    PortArrayPtr  m_pa;         /**< Values, if block computed array */
   };
 }
\ No newline at end of file
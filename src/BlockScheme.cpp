@@ -8,6 +8,7 @@
  */
 
 #include "BlockScheme.hpp"
+#include "SchemeTrace.hpp"
 
 
 ///
@@ -20,7 +21,8 @@ namespace BlockEditorLogic
    *            id's to 0
    */
   CBlockScheme::CBlockScheme() : m_blockCounter{0}, m_portCounter{0},
-      m_blocksInScheme{0}
+      m_blocksInScheme{0}, m_version{0}, m_slotCount{0},
+      m_stats{std::make_shared<CSchemeStats>()}
   {
 
   }
@@ -41,6 +43,44 @@ namespace BlockEditorLogic
    * @return ID of new block
    */
   ID CBlockScheme::addBlock(EBlockType type, TypeName tn)
+  {
+    if (type == BT_MACRO)
+    {
+      throw CBlockEditorException("Macro blocks are added by addMacroBlock", EErrorCode::E_INTERN);
+    }
+    ID id = createBlock(type, tn);
+
+    JournalRecord r;
+    r.m_op = JO_ADD_BLOCK;
+    r.m_blockID = id;
+    r.m_type = type;
+    r.m_text = tn;
+    journal(r);
+
+    return id;
+  }
+
+  /**
+   * @brief Searches block by scanning all blocks, scans are counted
+   * @param blockID ID of the block
+   * @return The block, end of m_blocks if it doesnt exist
+   */
+  CBlockScheme::BlockBuffer::iterator CBlockScheme::findBlock(ID blockID)
+  {
+    auto it = std::find_if(m_blocks.begin(), m_blocks.end(),
+                [blockID](const CBlock& b) { return b.getID() == blockID; });
+
+    m_stats->add(SC_SCAN_LOOKUPS);
+    m_stats->add(SC_SCAN_STEPS, std::distance(m_blocks.begin(), it));
+    return it;
+  }
+
+  /**
+   * @brief Adds block without recording it to journal
+   * @param type Type of new block
+   * @return ID of new block
+   */
+  ID CBlockScheme::createBlock(EBlockType type, TypeName tn)
   {
     CBlock newBlock(m_blockCounter, type, tn);
     m_blockCounter++;
@@ -50,6 +90,7 @@ namespace BlockEditorLogic
 
     // Increment counter of blocks in scheme
     m_blocksInScheme++;
+    takeSlot(m_blockCounter-1);
 
     // Return ID of new block
     return m_blockCounter-1;
@@ -77,22 +118,175 @@ namespace BlockEditorLogic
       throw CBlockEditorException("Cannot assign value to non-input port");
     }*/
 
+    CBlock *input = addInputBlock(blockID, whichPort);
+    if (input)
+    {
+      input->setInputValue(value);
+      touch(input->getID());
+
+      JournalRecord r;
+      r.m_op = JO_INPUT_VALUE;
+      r.m_blockID = blockID;
+      r.m_otherID = input->getID();
+      r.m_port = whichPort;
+      r.m_value = value;
+      journal(r);
+    }
+  }
+
+  /**
+   * @brief Function assigns array of values loaded from file to port of the block
+   * @param ID id of block with port to assign
+   * @param fileName binary or CSV file with values
+   * @param whichPort input port
+   */
+  void CBlockScheme::addInputArray(ID blockID, const std::string& fileName, Ports whichPort)
+  {
+    // Load first, so bad file doesnt leave half connected input
+    PortArrayPtr pa = loadArrayFile(fileName);
+
+    CBlock *input = addInputBlock(blockID, whichPort);
+    if (input)
+    {
+      input->setInputArray(std::move(pa), fileName);
+      touch(input->getID());
+
+      JournalRecord r;
+      r.m_op = JO_INPUT_ARRAY;
+      r.m_blockID = blockID;
+      r.m_otherID = input->getID();
+      r.m_port = whichPort;
+      r.m_text = fileName;
+      journal(r);
+    }
+  }
+
+  /**
+   * @brief Creates input block and connects it to port of the block
+   * @param ID id of block with port to assign
+   * @param whichPort input port
+   * @return New input block, nullptr if block with ID doesnt exist
+   */
+  CBlock* CBlockScheme::addInputBlock(ID blockID, Ports whichPort)
+  {
+    auto it = findBlock(blockID);
+    if (it == m_blocks.end())
+    {
+      return nullptr;
+    }
+    if (it->hasPort(whichPort))
+    {
+      throw CBlockEditorException("Input port is already connected", EErrorCode::E_INTERN);
+    }
+    if (!it->acceptsInput(whichPort))
+    {
+      throw CBlockEditorException("Block hasnt input port " + std::to_string(inputNumber(whichPort)), EErrorCode::E_INTERN);
+    }
+
+    ID id = createBlock(BT_INPUT, TN_INPUT);
+    connectPort(id, blockID, whichPort);
+
+    // Input block was appended last
+    return &m_blocks.back();
+  }
+
+  /**
+   * @brief Replaces values of input port which already has value assigned,
+   *        used to feed new values to scheme without rebuilding it
+   * @param blockID id of block with port
+   * @param whichPort which of input ports
+   * @param pa New array of values
+   */
+  void CBlockScheme::setInputArray(ID blockID, Ports whichPort, PortArrayPtr pa)
+  {
     for (auto& it : m_blocks)
     {
       if (it.getID() == blockID)
       {
-        ID id = addBlock(BT_INPUT, TN_INPUT);
+        if (!it.hasPort(whichPort))
+        {
+          throw CBlockEditorException("Selected block hasnt selected input port", EErrorCode::E_INTERN);
+        }
+
+        ID portID = it.getPortID(whichPort);
         for (auto& it2 : m_blocks)
         {
-          if (it2.getID() == id)
+          if (it2.getType() == BT_INPUT && it2.hasPort(Ports::P_OUTPUT)
+                && it2.getPortID(Ports::P_OUTPUT) == portID)
           {
-            it2.setInputValue(value);
-            break;
+            it2.setInputArray(std::move(pa), it2.getSource());
+            touch(it2.getID());
+            return;
+          }
+        }
+        throw CBlockEditorException("Port hasnt value assigned", EErrorCode::E_INTERN);
+      }
+    }
+
+    throw CBlockEditorException("Block with specified ID doesn't exist", EErrorCode::E_INTERN);
+  }
+
+  /**
+   * @brief Finds blocks whose output port isnt connected, results of
+   *        those blocks are results of the whole scheme
+   * @return IDs of output blocks in order of blocks in scheme
+   */
+  std::vector<ID> CBlockScheme::getOutputBlocks() const
+  {
+    std::vector<ID> out;
+
+    for (auto& it : m_blocks)
+    {
+      if (it.getType() != BT_INPUT && !it.hasPort(Ports::P_OUTPUT))
+      {
+        out.push_back(it.getID());
+      }
+    }
+
+    return out;
+  }
+
+  /**
+   * @param blockID ID of block
+   * @return True if block with the ID is in the scheme
+   */
+  bool CBlockScheme::hasBlock(ID blockID) const
+  {
+    m_stats->add(SC_INDEX_LOOKUPS);
+    return m_slots.find(blockID) != m_slots.end();
+  }
+
+  /**
+   * @brief Describes value assigned to input port, arrays are summarized
+   * @param blockID ID of block with port
+   * @param whichPort which of input ports
+   * @return Description of value
+   */
+  std::string CBlockScheme::getInputSummary(ID blockID, Ports whichPort) const
+  {
+    for (auto& it : m_blocks)
+    {
+      if (it.getID() == blockID)
+      {
+        if (!it.hasPort(whichPort))
+        {
+          throw CBlockEditorException("Selected block hasnt selected input port", EErrorCode::E_INTERN);
+        }
+
+        std::pair<ID, Ports> p = findBlockByPortID(it.getPortID(whichPort), blockID);
+        for (auto& it2 : m_blocks)
+        {
+          if (it2.getID() == p.first && it2.getType() == BT_INPUT)
+          {
+            return it2.hasArray() ? summarizeArray(*it2.getArray())
+                                  : std::to_string(it2.getValue());
           }
         }
-        addPort(id, blockID, whichPort);
+        throw CBlockEditorException("Port hasnt value assigned", EErrorCode::E_INTERN);
       }
     }
+
+    throw CBlockEditorException("Block with specified ID doesn't exist", EErrorCode::E_INTERN);
   }
 
   /**
@@ -114,15 +308,24 @@ namespace BlockEditorLogic
         }
         p = it->getPort(whichPort);
         it->removePort(whichPort);
+        touch(blockID);
         for (auto it2 = m_blocks.begin(); it2 != m_blocks.end(); it2++)
         {
           if (it2->getType() == BT_INPUT)
           {
             if (p->getPortID() == it2->getPort(Ports::P_OUTPUT)->getPortID())
             {
+              releaseSlot(it2->getID());
+              m_portOwner.erase(p->getPortID());
               m_blocks.erase(it2);
               m_blocksInScheme--;
               delete p;
+
+              JournalRecord r;
+              r.m_op = JO_REMOVE_INPUT;
+              r.m_blockID = blockID;
+              r.m_port = whichPort;
+              journal(r);
               return ;
             }
           }
@@ -142,37 +345,283 @@ namespace BlockEditorLogic
     // Decrement counter of blocks in scheme
     m_blocksInScheme--;
 
-    for (auto it = m_blocks.begin(); it != m_blocks.end(); it++)
+    auto it = findBlock(blockID);
+    if (it != m_blocks.end())
     {
-      if (it->getID() == blockID)
+      // Get portID of output port of this block
+      if (it->hasPort(Ports::P_OUTPUT))
       {
-        // Get portID of output port of this block
-        if (it->hasPort(Ports::P_OUTPUT))
+        CPort *op = it->getPort(Ports::P_OUTPUT);
+        // Find Block with input port with portID
+        // Set pointer to port of that Block to nullptr
+        for (auto& it2 : m_blocks)
         {
-          CPort *op = it->getPort(Ports::P_OUTPUT);
-          // Find Block with input port with portID
-          // Set pointer to port of that Block to nullptr
-          for (auto& it2 : m_blocks)
+          for (size_t n = 1; n <= it2.getInputCount(); n++)
           {
-            CPort *ip1 = it2.getPort(Ports::P_INPUT1);
-            CPort *ip2 = it2.getPort(Ports::P_INPUT2);
-            if (ip1 && (ip1->getPortID() == op->getPortID()))
+            CPort *ip = it2.getPort(inputPort(n));
+            if (ip && (ip->getPortID() == op->getPortID()))
             {
-              it2.setPort(Ports::P_INPUT1);
-            }
-            else if (ip2 && (ip2->getPortID() == op->getPortID()))
-            {
-              it2.setPort(Ports::P_INPUT2);
+              it2.setPort(inputPort(n));
+              touch(it2.getID());
+              break;
             }
           }
         }
-        m_blocks.erase(it);
-        return;
+        m_portOwner.erase(op->getPortID());
       }
+      releaseSlot(blockID);
+      m_blocks.erase(it);
+
+      JournalRecord r;
+      r.m_op = JO_REMOVE_BLOCK;
+      r.m_blockID = blockID;
+      journal(r);
+      return;
     }
     throw CBlockEditorException(std::string("Block with ID ") + std::to_string(blockID) + " doesnt exist", EErrorCode::E_INTERN);
   }
 
+  /**
+   * @brief Removes many blocks at once, in time linear to size of the
+   *        scheme instead of scanning it for every removed block.
+   *        Values assigned to the removed blocks are removed with them,
+   *        blocks which stay lose connections to the removed ones.
+   * @param blockIDs IDs of blocks to remove, nothing is removed if any
+   *        of them doesnt exist
+   */
+  void CBlockScheme::removeBlocks(const std::vector<ID>& blockIDs)
+  {
+    TRACE_SPAN("removeBlocks");
+    std::unordered_set<ID> removed;
+    for (ID blockID : blockIDs)
+    {
+      if (m_slots.find(blockID) == m_slots.end())
+      {
+        throw CBlockEditorException(std::string("Block with ID ") + std::to_string(blockID) + " doesnt exist", EErrorCode::E_INTERN);
+      }
+      removed.insert(blockID);
+    }
+    if (removed.empty())
+    {
+      return;
+    }
+
+    // Ports feeding the removed blocks
+    std::unordered_set<ID> fed;
+    for (auto& it : m_blocks)
+    {
+      if (removed.count(it.getID()))
+      {
+        for (size_t n = 1; n <= it.getInputCount(); n++)
+        {
+          Ports p = inputPort(n);
+          if (it.hasPort(p))
+          {
+            fed.insert(it.getPort(p)->getPortID());
+          }
+        }
+      }
+    }
+
+    // Input blocks holding their values go too
+    for (auto& it : m_blocks)
+    {
+      if (it.getType() == BT_INPUT && it.hasPort(Ports::P_OUTPUT)
+            && fed.count(it.getPort(Ports::P_OUTPUT)->getPortID()))
+      {
+        removed.insert(it.getID());
+      }
+    }
+
+    // Disconnect blocks which stay, before owners of the ports delete them
+    for (auto& it : m_blocks)
+    {
+      if (removed.count(it.getID()))
+      {
+        continue;
+      }
+      for (size_t n = 1; n <= it.getInputCount(); n++)
+      {
+        Ports p = inputPort(n);
+        if (it.hasPort(p))
+        {
+          auto owner = m_portOwner.find(it.getPort(p)->getPortID());
+          if (owner != m_portOwner.end() && removed.count(owner->second))
+          {
+            it.setPort(p);
+            touch(it.getID());
+          }
+        }
+      }
+      if (it.hasPort(Ports::P_OUTPUT) && fed.count(it.getPort(Ports::P_OUTPUT)->getPortID()))
+      {
+        m_portOwner.erase(it.getPort(Ports::P_OUTPUT)->getPortID());
+        it.removePort(Ports::P_OUTPUT);
+        touch(it.getID());
+      }
+    }
+
+    // Every port is deleted once, by the block it is output of
+    for (auto& it : m_blocks)
+    {
+      if (removed.count(it.getID()))
+      {
+        if (it.hasPort(Ports::P_OUTPUT))
+        {
+          m_portOwner.erase(it.getPort(Ports::P_OUTPUT)->getPortID());
+          it.removePort(Ports::P_OUTPUT);
+        }
+        releaseSlot(it.getID());
+      }
+    }
+    m_blocks.erase(std::remove_if(m_blocks.begin(), m_blocks.end(),
+                                  [&removed](const CBlock& b) { return removed.count(b.getID()) != 0; }),
+                   m_blocks.end());
+    m_blocksInScheme -= removed.size();
+
+    JournalRecord r;
+    r.m_op = JO_REMOVE_BLOCKS;
+    for (ID blockID : blockIDs)
+    {
+      r.m_text += std::to_string(blockID) + " ";
+    }
+    journal(r);
+  }
+
+  /**
+   * @brief Removes all blocks. Unlike clearScheme the removal is journaled
+   *        and IDs of removed blocks are not given to new blocks.
+   */
+  void CBlockScheme::removeAllBlocks()
+  {
+    TRACE_SPAN("removeAllBlocks");
+    unsigned long blockCounter = m_blockCounter;
+    unsigned long portCounter = m_portCounter;
+
+    for (auto& it : m_blocks)
+    {
+      it.removePort(Ports::P_OUTPUT);
+    }
+    clearScheme();
+
+    m_blockCounter = blockCounter;
+    m_portCounter = portCounter;
+
+    JournalRecord r;
+    r.m_op = JO_CLEAR;
+    journal(r);
+  }
+
+  /**
+   * @return Values of all counters and timers
+   */
+  SchemeStats CBlockScheme::getStats() const
+  {
+    return m_stats->get();
+  }
+
+  /**
+   * @brief Sets all counters and timers to zero
+   */
+  void CBlockScheme::resetStats()
+  {
+    m_stats->reset();
+  }
+
+  /**
+   * @brief Writes counters and timers in Prometheus text format
+   * @param fileName File to write, replaced at once
+   */
+  void CBlockScheme::exportStats(const std::string& fileName) const
+  {
+    CSchemeStats::writePrometheus(m_stats->get(), getMemory(), fileName);
+  }
+
+  /**
+   * @brief Counts memory of all parts of the scheme, each shared array once
+   * @return Bytes by part, with peaks of load and run since stats were reset
+   */
+  SchemeMemory CBlockScheme::getMemory() const
+  {
+    CMemoryCounter c;
+    SchemeMemory m;
+    countMemory(c, m);
+
+    SchemeStats s = m_stats->get();
+    m.m_loadPeak = s.m_peaks[SP_LOAD_BYTES];
+    m.m_runPeak = s.m_peaks[SP_RUN_BYTES];
+    return m;
+  }
+
+  /**
+   * @brief Adds memory of the scheme to the report
+   * @param c Counter of the report, arrays it counted already are skipped
+   * @param m Report to add to
+   */
+  void CBlockScheme::countMemory(CMemoryCounter& c, SchemeMemory& m) const
+  {
+    m.m_bytes[MP_BLOCKS] += CMemoryCounter::dequeBytes(m_blocks);
+    for (auto& it : m_blocks)
+    {
+      m.m_blocks++;
+      if (it.getType() == BT_INPUT)
+      {
+        m.m_inputBlocks++;
+      }
+      m.m_bytes[MP_STRINGS] += it.getHeapBytes();
+      m.m_bytes[MP_ARRAYS] += c.arrayBytes(it.getArray());
+
+      // Port is owned by the block with it on output
+      if (it.hasPort(Ports::P_OUTPUT))
+      {
+        const CPort *p = it.getPort(Ports::P_OUTPUT);
+        m.m_ports++;
+        m.m_bytes[MP_PORTS] += sizeof(CPort);
+        m.m_bytes[MP_STRINGS] += p->getHeapBytes();
+      }
+    }
+
+    m.m_bytes[MP_INDEXES] += CMemoryCounter::hashBytes(m_slots)
+                           + CMemoryCounter::vectorBytes(m_freeSlots)
+                           + CMemoryCounter::hashBytes(m_portOwner)
+                           + m_dirtyPages.capacity() / 8;
+
+    // Definitions are stored once, however many instances they have. Node
+    // of the map holds three links and color besides the name and pointer.
+    for (auto& it : m_macros)
+    {
+      m.m_bytes[MP_MACROS] += 4 * sizeof(void*) + sizeof(it) + CMemoryCounter::stringBytes(it.first)
+                            + c.sharedBytes(it.second) + it.second->getHeapBytes(c);
+    }
+
+    m.m_bytes[MP_ACTIONS] += CMemoryCounter::dequeBytes(m_actions);
+    for (auto& it : m_actions)
+    {
+      m.m_bytes[MP_ARRAYS] += c.arrayBytes(it.getArray());
+    }
+
+    // The last snapshot holds a copy of the page list, pages are shared
+    m.m_bytes[MP_SNAPSHOTS] += CMemoryCounter::vectorBytes(m_pages);
+    uint64_t snapshot = c.sharedBytes(m_snapshot);
+    if (snapshot)
+    {
+      m.m_bytes[MP_SNAPSHOTS] += snapshot + m_pages.size() * sizeof(CSchemeSnapshot::PagePtr);
+    }
+    for (auto& it : m_pages)
+    {
+      uint64_t bytes = c.sharedBytes(it);
+      if (bytes)
+      {
+        m.m_bytes[MP_SNAPSHOTS] += bytes + CMemoryCounter::vectorBytes(*it);
+        for (auto& node : *it)
+        {
+          m.m_bytes[MP_ARRAYS] += c.arrayBytes(node.m_array);
+          m.m_bytes[MP_SNAPSHOTS] += CMemoryCounter::vectorBytes(node.m_more);
+        }
+      }
+    }
+  }
+
   /**
    * @brief Debugging function - prints all blocks with ports
    */
@@ -187,6 +636,9 @@ namespace BlockEditorLogic
         std::cout << "    Has input 1 ID:" << it.getPortID(Ports::P_INPUT1) <<  std::endl;
       if (it.hasPort(Ports::P_INPUT2))
         std::cout << "    Has input 2 ID:" << it.getPortID(Ports::P_INPUT2) <<  std::endl;
+      for (size_t n = 3; n <= it.getInputCount(); n++)
+        if (it.hasPort(inputPort(n)))
+          std::cout << "    Has input " << n << " ID:" << it.getPortID(inputPort(n)) << std::endl;
       if (it.hasPort(Ports::P_OUTPUT))
         std::cout << "    Has output ID:" << it.getPortID(Ports::P_OUTPUT) <<  std::endl;
     }
@@ -200,107 +652,1067 @@ namespace BlockEditorLogic
    */
   void CBlockScheme::addPort(ID blockID_out, ID blockID_in, Ports whichPort)
   {
-    CPort* port;
-    TypeName tn;
-    auto pit = m_blocks.begin();
-
-    for ( ; pit != m_blocks.end(); pit++)
-    {
-      if (pit->getID() == blockID_out)
-      {
-        if (pit->hasPort(Ports::P_OUTPUT))
-        {
-          throw CBlockEditorException("Block already has output port", EErrorCode::E_INTERN);
-        }
-        tn = pit->getTypeName();
-        break;
-      }
-    }
-
-    for (auto& it : m_blocks)
-    {
-      if (it.getID() == blockID_in)
-      {
-        if (it.getType() == BT_INPUT)
-        {
-          throw CBlockEditorException("Input block hasnt any input ports", EErrorCode::E_INTERN);
-        }
-        if (tn != it.getTypeName()
-              && tn != TN_INPUT)
-        {
-          throw CBlockEditorException("Types of blocks differ -> cannot connect them", EErrorCode::E_UI_BAD_TYPES);
-        }
-        port = pit->addOutputPort(this->m_portCounter);
-        port->setPortName(tn);
-        it.addInputPort(whichPort, port);
-        break;
-      }
-    }
-    this->m_portCounter++;
+    connectPort(blockID_out, blockID_in, whichPort);
+
+    JournalRecord r;
+    r.m_op = JO_ADD_PORT;
+    r.m_blockID = blockID_out;
+    r.m_otherID = blockID_in;
+    r.m_port = whichPort;
+    journal(r);
   }
 
   /**
-   * @brief Function removes port between blockID_out & blockID_in (first/second)
+   * @brief Creates port between blocks without recording it to journal
    * @param blockID_out Which block output port is
    * @param blockID_int Which block input port is
-   * @param firstSecond Which port it is
+   * @param wchiPort Which port it is
    */
-  void CBlockScheme::removePort(ID blockID_out, ID blockID_in, Ports whichPort)
+  void CBlockScheme::connectPort(ID blockID_out, ID blockID_in, Ports whichPort)
   {
-    for (auto& it : m_blocks)
+    auto pit = findBlock(blockID_out);
+    auto it = findBlock(blockID_in);
+    if (pit == m_blocks.end() || it == m_blocks.end())
     {
-      if (it.getID() == blockID_out)
-      {
-        if (!it.hasPort(Ports::P_OUTPUT))
-        {
-          throw CBlockEditorException(std::string("Removing port -- Block " + std::to_string(blockID_out) + " hasnt output port"), EErrorCode::E_INTERN);
-        }
-        it.removePort(Ports::P_OUTPUT);
-        break;
-      }
+      throw CBlockEditorException("Block with specified ID doesn't exist", EErrorCode::E_INTERN);
     }
 
-    for (auto& it : m_blocks)
+    if (pit->hasPort(Ports::P_OUTPUT))
+    {
+      throw CBlockEditorException("Block already has output port", EErrorCode::E_INTERN);
+    }
+    TypeName tn = pit->getTypeName();
+
+    if (it->getType() == BT_INPUT)
     {
-      if (it.getID() == blockID_in)
+      throw CBlockEditorException("Input block hasnt any input ports", EErrorCode::E_INTERN);
+    }
+    if (!it->acceptsInput(whichPort))
+    {
+      throw CBlockEditorException("Block hasnt input port " + std::to_string(inputNumber(whichPort)), EErrorCode::E_INTERN);
+    }
+    if (it->hasPort(whichPort))
+    {
+      throw CBlockEditorException("Input port is already connected", EErrorCode::E_INTERN);
+    }
+    if (tn != it->getTypeName()
+          && tn != TN_INPUT)
+    {
+      throw CBlockEditorException("Types of blocks differ -> cannot connect them", EErrorCode::E_UI_BAD_TYPES);
+    }
+    linkPorts(*pit, *it, whichPort);
+  }
+
+  /**
+   * @brief Connects output port of one block to input port of other,
+   *        checks were done by the caller
+   * @param out Block the new port is output of
+   * @param in Block the new port is input of
+   * @param whichPort Which input port
+   */
+  void CBlockScheme::linkPorts(CBlock& out, CBlock& in, Ports whichPort)
+  {
+    CPort *port = out.addOutputPort(this->m_portCounter);
+    port->setPortName(out.getTypeName());
+    in.addInputPort(whichPort, port);
+    m_portOwner[m_portCounter] = out.getID();
+    touch(in.getID());
+    this->m_portCounter++;
+  }
+
+  /**
+   * @brief Starts batch of edits, see applyBatch
+   * @return Empty batch giving IDs from the current block counter
+   */
+  CSchemeBatch CBlockScheme::batch() const
+  {
+    return CSchemeBatch(m_blockCounter);
+  }
+
+  /**
+   * @brief Applies all edits of batch or none of them. Edits are checked
+   *        the same way addPort/addInputValue check them, and connections
+   *        making a cycle are refused, before the scheme is changed. Blocks
+   *        are looked up once, so the batch takes time linear to its size
+   *        and the size of the scheme.
+   * @param b Batch started by batch() with no other block added since
+   */
+  void CBlockScheme::applyBatch(const CSchemeBatch& b)
+  {
+    TRACE_SPAN("applyBatch");
+    if (b.getFirstID() != m_blockCounter)
+    {
+      throw CBlockEditorException("Scheme was edited since the batch was started", EErrorCode::E_INTERN);
+    }
+
+    ///
+    /// Block touched by batch, as it will be after the batch
+    ///
+    struct BatchBlock
+    {
+      CBlock       *m_block = nullptr;    /**< Block once it exists */
+      bool          m_exists = false;
+      EBlockType    m_bt = BT_INPUT;
+      TypeName      m_tn;
+      size_t        m_inputs = 0;         /**< Inputs of macro block */
+      std::vector<bool> m_ports = std::vector<bool>(3, false);  /**< By port, reductions have more */
+    };
+    auto index = [](Ports p) { return static_cast<size_t>(p) - 1; };
+    auto has = [&index](const BatchBlock& bb, Ports p) {
+      return index(p) < bb.m_ports.size() && bb.m_ports[index(p)];
+    };
+    auto take = [&index](BatchBlock& bb, Ports p) {
+      if (index(p) >= bb.m_ports.size())
+      {
+        bb.m_ports.resize(index(p) + 1, false);
+      }
+      bb.m_ports[index(p)] = true;
+    };
+
+    // Blocks of the scheme used by batch, found in one pass
+    std::unordered_map<ID, BatchBlock> blocks;
+    blocks.reserve(b.getRecords().size());
+    for (auto& r : b.getRecords())
+    {
+      if (r.m_blockID < b.getFirstID() && r.m_op != BO_ADD_BLOCK && r.m_op != BO_ADD_MACRO)
+      {
+        blocks[r.m_blockID];
+      }
+      if (r.m_otherID < b.getFirstID() && r.m_op == BO_ADD_PORT)
+      {
+        blocks[r.m_otherID];
+      }
+    }
+    if (!blocks.empty())
+    {
+      for (auto& it : m_blocks)
+      {
+        auto bb = blocks.find(it.getID());
+        if (bb != blocks.end())
+        {
+          bb->second.m_block = &it;
+          bb->second.m_exists = true;
+          bb->second.m_bt = it.getType();
+          bb->second.m_tn = it.getTypeName();
+          bb->second.m_inputs = it.getInputCount();
+          for (size_t n = 0; n <= it.getInputCount(); n++)
+          {
+            Ports p = n == 0 ? Ports::P_OUTPUT : inputPort(n);
+            if (it.hasPort(p))
+            {
+              take(bb->second, p);
+            }
+          }
+        }
+      }
+    }
+
+    auto find = [&blocks](ID id) -> BatchBlock& {
+      auto bb = blocks.find(id);
+      if (bb == blocks.end() || !bb->second.m_exists)
+      {
+        throw CBlockEditorException(std::string("Block with ID ") + std::to_string(id) + " doesnt exist", EErrorCode::E_INTERN);
+      }
+      return bb->second;
+    };
+    auto takeInput = [&has, &take](BatchBlock& in, Ports whichPort) {
+      if (whichPort == Ports::P_OUTPUT)
+      {
+        throw CBlockEditorException("Cannot assign value to non-input port", EErrorCode::E_INTERN);
+      }
+      if (in.m_bt == BT_INPUT)
+      {
+        throw CBlockEditorException("Input block hasnt any input ports", EErrorCode::E_INTERN);
+      }
+      if (!CBlock::acceptsInput(in.m_bt, whichPort)
+            || (in.m_bt == BT_MACRO && inputNumber(whichPort) > in.m_inputs))
+      {
+        throw CBlockEditorException("Block hasnt input port " + std::to_string(inputNumber(whichPort)), EErrorCode::E_INTERN);
+      }
+      if (has(in, whichPort))
+      {
+        throw CBlockEditorException("Input port is already connected", EErrorCode::E_INTERN);
+      }
+      take(in, whichPort);
+    };
+
+    // Check edits in order, on the scheme as it will be
+    std::vector<ID> linked;       // Producers of new connections
+    for (auto& r : b.getRecords())
+    {
+      switch (r.m_op)
+      {
+        case BO_ADD_BLOCK:
+        {
+          if (r.m_type == BT_MACRO)
+          {
+            throw CBlockEditorException("Macro blocks are added by addMacroBlock", EErrorCode::E_INTERN);
+          }
+          BatchBlock& bb = blocks[r.m_blockID];
+          bb.m_exists = true;
+          bb.m_bt = r.m_type;
+          bb.m_tn = r.m_tn;
+          break;
+        }
+        case BO_ADD_MACRO:
+        {
+          auto macro = m_macros.find(r.m_macro);
+          if (macro == m_macros.end())
+          {
+            throw CBlockEditorException("Macro " + r.m_macro + " isnt defined", EErrorCode::E_INTERN);
+          }
+          BatchBlock& bb = blocks[r.m_blockID];
+          bb.m_exists = true;
+          bb.m_bt = BT_MACRO;
+          bb.m_tn = macro->second->getTypeName();
+          bb.m_inputs = macro->second->getInputCount();
+          break;
+        }
+        case BO_ADD_PORT:
+        {
+          BatchBlock& out = find(r.m_blockID);
+          BatchBlock& in = find(r.m_otherID);
+          if (has(out, Ports::P_OUTPUT))
+          {
+            throw CBlockEditorException("Block already has output port", EErrorCode::E_INTERN);
+          }
+          takeInput(in, r.m_port);
+          if (out.m_tn != in.m_tn && out.m_tn != TN_INPUT)
+          {
+            throw CBlockEditorException("Types of blocks differ -> cannot connect them", EErrorCode::E_UI_BAD_TYPES);
+          }
+          take(out, Ports::P_OUTPUT);
+          linked.push_back(r.m_blockID);
+          break;
+        }
+        case BO_INPUT_VALUE:
+        case BO_INPUT_ARRAY:
+        {
+          takeInput(find(r.m_blockID), r.m_port);
+          BatchBlock& input = blocks[r.m_otherID];
+          input.m_exists = true;
+          input.m_tn = TN_INPUT;
+          take(input, Ports::P_OUTPUT);
+          break;
+        }
+      }
+    }
+
+    // Every block has one consumer at most, so cycle made by the new
+    // connections is found by following consumers from their producers
+    if (!linked.empty())
+    {
+      std::unordered_map<ID, ID> consumer;
+      consumer.reserve(m_portOwner.size() + linked.size());
+      for (auto& it : m_blocks)
+      {
+        for (size_t n = 1; n <= it.getInputCount(); n++)
+        {
+          Ports p = inputPort(n);
+          if (it.hasPort(p))
+          {
+            auto owner = m_portOwner.find(it.getPortID(p));
+            if (owner != m_portOwner.end())
+            {
+              consumer[owner->second] = it.getID();
+            }
+          }
+        }
+      }
+      std::unordered_set<ID> fresh(linked.begin(), linked.end());
+      for (auto& r : b.getRecords())
+      {
+        if (r.m_op == BO_ADD_PORT)
+        {
+          consumer[r.m_blockID] = r.m_otherID;
+        }
+      }
+
+      // Walk of each producer stops at blocks visited by previous walks
+      std::unordered_map<ID, size_t> walk;
+      for (size_t i = 0; i < linked.size(); i++)
+      {
+        ID id = linked[i];
+        while (true)
+        {
+          auto w = walk.find(id);
+          if (w != walk.end())
+          {
+            // Back on this walk, the cycle is refused if a new connection is part of it
+            if (w->second == i)
+            {
+              ID c = id;
+              do
+              {
+                if (fresh.count(c))
+                {
+                  throw CBlockEditorException("Connection would make a cycle in the scheme", EErrorCode::E_UI_CYCLE);
+                }
+                c = consumer[c];
+              } while (c != id);
+            }
+            break;
+          }
+          walk[id] = i;
+
+          auto next = consumer.find(id);
+          if (next == consumer.end())
+          {
+            break;
+          }
+          id = next->second;
+        }
+      }
+    }
+
+    // Nothing can fail from here
+    m_slots.reserve(m_slots.size() + b.getBlockCount());
+    m_portOwner.reserve(m_portOwner.size() + b.getBlockCount());
+    for (auto& r : b.getRecords())
+    {
+      JournalRecord jr;
+      jr.m_blockID = r.m_blockID;
+      jr.m_otherID = r.m_otherID;
+      jr.m_port = r.m_port;
+
+      switch (r.m_op)
+      {
+        case BO_ADD_BLOCK:
+          createBlock(r.m_type, r.m_tn);
+          blocks[r.m_blockID].m_block = &m_blocks.back();
+          jr.m_op = JO_ADD_BLOCK;
+          jr.m_type = r.m_type;
+          jr.m_text = r.m_tn;
+          break;
+        case BO_ADD_MACRO:
+        {
+          MacroPtr macro = m_macros.at(r.m_macro);
+          createBlock(BT_MACRO, macro->getTypeName());
+          m_blocks.back().setMacro(macro);
+          blocks[r.m_blockID].m_block = &m_blocks.back();
+          jr.m_op = JO_ADD_MACRO;
+          jr.m_text = r.m_macro;
+          break;
+        }
+        case BO_ADD_PORT:
+          linkPorts(*blocks[r.m_blockID].m_block, *blocks[r.m_otherID].m_block, r.m_port);
+          jr.m_op = JO_ADD_PORT;
+          break;
+        case BO_INPUT_VALUE:
+        case BO_INPUT_ARRAY:
+        {
+          createBlock(BT_INPUT, TN_INPUT);
+          CBlock& input = m_blocks.back();
+          linkPorts(input, *blocks[r.m_blockID].m_block, r.m_port);
+          if (r.m_op == BO_INPUT_VALUE)
+          {
+            input.setInputValue(r.m_value);
+            jr.m_op = JO_INPUT_VALUE;
+            jr.m_value = r.m_value;
+          }
+          else
+          {
+            input.setInputArray(r.m_array, r.m_file);
+            jr.m_op = JO_INPUT_ARRAY;
+            jr.m_text = r.m_file;
+          }
+          break;
+        }
+      }
+      journal(jr);
+    }
+  }
+
+  /**
+   * @brief Function removes port between blockID_out & blockID_in (first/second)
+   * @param blockID_out Which block output port is
+   * @param blockID_int Which block input port is
+   * @param firstSecond Which port it is
+   */
+  void CBlockScheme::removePort(ID blockID_out, ID blockID_in, Ports whichPort)
+  {
+    auto out = findBlock(blockID_out);
+    if (out != m_blocks.end())
+    {
+      if (!out->hasPort(Ports::P_OUTPUT))
+      {
+        throw CBlockEditorException(std::string("Removing port -- Block " + std::to_string(blockID_out) + " hasnt output port"), EErrorCode::E_INTERN);
+      }
+      m_portOwner.erase(out->getPortID(Ports::P_OUTPUT));
+      out->removePort(Ports::P_OUTPUT);
+    }
+
+    auto in = findBlock(blockID_in);
+    if (in != m_blocks.end())
+    {
+      if (!in->hasPort(whichPort))
+      {
+        throw CBlockEditorException(std::string("Removing port -- Block " + std::to_string(blockID_in) + " hasnt input port"), EErrorCode::E_INTERN);
+      }
+      in->removePort(whichPort);
+      touch(blockID_in);
+    }
+
+    JournalRecord r;
+    r.m_op = JO_REMOVE_PORT;
+    r.m_blockID = blockID_out;
+    r.m_otherID = blockID_in;
+    r.m_port = whichPort;
+    journal(r);
+  }
+
+  /**
+   * @brief Moves block, position is stored in saved scheme
+   * @param blockID Block to move
+   * @param position New position of the block
+   */
+  void CBlockScheme::setPosition(ID blockID, std::pair<int, int> position)
+  {
+    auto it = findBlock(blockID);
+    if (it != m_blocks.end())
+    {
+      it->setPosition(position);
+
+      JournalRecord r;
+      r.m_op = JO_POSITION;
+      r.m_blockID = blockID;
+      r.m_x = position.first;
+      r.m_y = position.second;
+      journal(r);
+      return;
+    }
+
+    throw CBlockEditorException(std::string("Block with ID ") + std::to_string(blockID) + " doesnt exist", EErrorCode::E_INTERN);
+  }
+
+  /**
+   * @brief Sets count of input ports of reduction block, ports which are
+   *        dropped must not be connected
+   * @param blockID Reduction block
+   * @param count Count of inputs, 2 to MAX_INPUTS
+   */
+  void CBlockScheme::setInputCount(ID blockID, size_t count)
+  {
+    auto it = findBlock(blockID);
+    if (it == m_blocks.end())
+    {
+      throw CBlockEditorException(std::string("Block with ID ") + std::to_string(blockID) + " doesnt exist", EErrorCode::E_INTERN);
+    }
+    setReduction(*it, count, it->getReduceMode());
+  }
+
+  /**
+   * @brief Sets order in which SUM block adds its inputs
+   * @param blockID SUM block
+   * @param mode Order of summation
+   */
+  void CBlockScheme::setReduceMode(ID blockID, EReduceMode mode)
+  {
+    auto it = findBlock(blockID);
+    if (it == m_blocks.end())
+    {
+      throw CBlockEditorException(std::string("Block with ID ") + std::to_string(blockID) + " doesnt exist", EErrorCode::E_INTERN);
+    }
+    setReduction(*it, it->getInputCount(), mode);
+  }
+
+  /**
+   * @brief Checks and sets inputs and summation of reduction block, the
+   *        journal keeps both of them in one record
+   * @param block Reduction block
+   * @param count Count of inputs
+   * @param mode Order of summation, other than RM_PLAIN for SUM only
+   */
+  void CBlockScheme::setReduction(CBlock& block, size_t count, EReduceMode mode)
+  {
+    if (!isReduction(block.getType()))
+    {
+      throw CBlockEditorException("Only reduction blocks have any number of inputs", EErrorCode::E_INTERN);
+    }
+    if (count < 2 || count > MAX_INPUTS)
+    {
+      throw CBlockEditorException("Reduction block has 2 to " + std::to_string(MAX_INPUTS) + " inputs", EErrorCode::E_INTERN);
+    }
+    if (mode < RM_PLAIN || mode > RM_PAIRWISE || (mode != RM_PLAIN && block.getType() != BT_SUM))
+    {
+      throw CBlockEditorException("Order of summation is set only for SUM blocks", EErrorCode::E_INTERN);
+    }
+    for (size_t n = count + 1; n <= block.getInputCount(); n++)
+    {
+      if (block.hasPort(inputPort(n)))
+      {
+        throw CBlockEditorException("Input port " + std::to_string(n) + " is still connected", EErrorCode::E_INTERN);
+      }
+    }
+
+    block.setInputCount(count);
+    block.setReduceMode(mode);
+    touch(block.getID());
+
+    JournalRecord r;
+    r.m_op = JO_REDUCTION;
+    r.m_blockID = block.getID();
+    r.m_x = static_cast<int>(count);
+    r.m_y = mode;
+    journal(r);
+  }
+
+  /**
+   * @brief Replaces left-deep chains of ADD (MUL) blocks of floating point
+   *        values by one SUM (PRODUCT) block each, so summing n values takes
+   *        one block instead of n-1. Block joins the chain of the block below
+   *        it on input 1 only if its input 2 isnt connected to ADD (MUL)
+   *        block. Input 1 of the lowest block and inputs 2 of the others,
+   *        bottom up, become inputs of the new block, the plain left fold
+   *        of SUM (PRODUCT) then adds them in the same order and gives the
+   *        same results. Other shapes are kept, they would be re-associated.
+   *        Root of the chain keeps its ID, position and output, the other
+   *        blocks of the chain are removed. Only FLOAT blocks are collapsed.
+   * @return Count of removed blocks
+   */
+  size_t CBlockScheme::collapseReductions()
+  {
+    TRACE_SPAN("collapseReductions");
+    std::unordered_map<ID, CBlock*> blocks;
+
+    for (auto& it : m_blocks)
+    {
+      if ((it.getType() == BT_ADD || it.getType() == BT_MUL) && it.getTypeName() == TN_FLOAT)
+      {
+        blocks.emplace(it.getID(), &it);
+      }
+    }
+
+    // ADD (MUL) block of the same type connected to input, nullptr if input is a leaf
+    auto inner = [this, &blocks](const CBlock& b, Ports p) -> CBlock* {
+      if (!b.hasPort(p))
+      {
+        return nullptr;
+      }
+      auto owner = m_portOwner.find(b.getPortID(p));
+      if (owner == m_portOwner.end())
+      {
+        return nullptr;
+      }
+      auto it = blocks.find(owner->second);
+      return it != blocks.end() && it->second->getType() == b.getType() ? it->second : nullptr;
+    };
+
+    // Block below on input 1, if it continues the chain
+    auto below = [&inner](const CBlock& b) -> CBlock* {
+      return inner(b, Ports::P_INPUT2) ? nullptr : inner(b, Ports::P_INPUT1);
+    };
+
+    // Output of root doesnt continue other chain, blocks in cycle have no root
+    std::unordered_set<ID> consumed;
+    for (auto& it : blocks)
+    {
+      CBlock *in = below(*it.second);
+      if (in)
+      {
+        consumed.insert(in->getID());
+      }
+    }
+
+    std::unordered_set<ID> removed;
+    std::vector<CBlock*> tree;
+    std::vector<CPort*> leaves;
+    for (auto& it : m_blocks)
+    {
+      if (!blocks.count(it.getID()) || consumed.count(it.getID()))
+      {
+        continue;
+      }
+
+      // Root down to the lowest block, leaves are collected in reverse
+      tree.clear();
+      leaves.clear();
+      leaves.push_back(it.getPort(Ports::P_INPUT2));
+      CBlock *last = &it;
+      for (CBlock *in = below(it); in; in = below(*in))
+      {
+        tree.push_back(in);
+        leaves.push_back(in->getPort(Ports::P_INPUT2));
+        last = in;
+      }
+      leaves.push_back(last->getPort(Ports::P_INPUT1));
+      std::reverse(leaves.begin(), leaves.end());
+      if (tree.empty() || leaves.size() > MAX_INPUTS)
+      {
+        continue;
+      }
+
+      // Ports between blocks of the chain go with them, leaves keep theirs
+      for (CBlock *b : tree)
+      {
+        removed.insert(b->getID());
+        m_portOwner.erase(b->getPortID(Ports::P_OUTPUT));
+        b->removePort(Ports::P_OUTPUT);
+        releaseSlot(b->getID());
+      }
+
+      std::pair<int, int> position = it.getPosition();
+      it = CBlock(it.getID(), it.getType() == BT_ADD ? BT_SUM : BT_PRODUCT, position.first, position.second,
+                  it.getValue(), leaves[0], leaves[1], it.getPort(Ports::P_OUTPUT), it.getTypeName());
+      for (size_t k = 2; k < leaves.size(); k++)
+      {
+        it.addInputPort(inputPort(k + 1), leaves[k]);
+      }
+      touch(it.getID());
+    }
+
+    if (removed.empty())
+    {
+      return 0;
+    }
+    m_blocks.erase(std::remove_if(m_blocks.begin(), m_blocks.end(),
+                                  [&removed](const CBlock& b) { return removed.count(b.getID()) != 0; }),
+                   m_blocks.end());
+    m_blocksInScheme -= removed.size();
+
+    JournalRecord r;
+    r.m_op = JO_COLLAPSE;
+    journal(r);
+    return removed.size();
+  }
+
+  /**
+   * @brief Defines macro from blocks of the scheme, the blocks are kept.
+   *        Values assigned to their ports become constants of the body,
+   *        ports free or connected to other blocks become inputs of macro,
+   *        numbered in order of blocks and of their ports.
+   * @param name Name of macro, not used by other macro
+   * @param blockIDs Blocks of the body, one of them has output which isnt
+   *        connected to the others, it is the output of macro
+   * @return Count of inputs of macro
+   */
+  size_t CBlockScheme::defineMacro(const std::string& name, const std::vector<ID>& blockIDs)
+  {
+    TRACE_SPAN("defineMacro");
+    CMacroDefinition::checkName(name);
+    if (m_macros.count(name))
+    {
+      throw CBlockEditorException("Macro " + name + " is already defined", EErrorCode::E_INTERN);
+    }
+
+    // Blocks of the body and producers of their inputs, found in two passes
+    std::unordered_map<ID, const CBlock*> body;
+    std::unordered_map<ID, const CBlock*> producers;
+    for (ID id : blockIDs)
+    {
+      body[id] = nullptr;
+    }
+    for (auto& it : m_blocks)
+    {
+      auto b = body.find(it.getID());
+      if (b == body.end())
+      {
+        continue;
+      }
+      if (it.getType() == BT_INPUT || it.getType() == BT_MACRO)
+      {
+        throw CBlockEditorException("Block " + std::to_string(it.getID()) + " cant be part of macro", EErrorCode::E_INTERN);
+      }
+      b->second = &it;
+      for (size_t n = 1; n <= it.getInputCount(); n++)
+      {
+        if (it.hasPort(inputPort(n)))
+        {
+          producers[it.getPortID(inputPort(n))] = nullptr;
+        }
+      }
+    }
+    for (auto& it : m_blocks)
+    {
+      if (it.hasPort(Ports::P_OUTPUT))
+      {
+        auto p = producers.find(it.getPortID(Ports::P_OUTPUT));
+        if (p != producers.end())
+        {
+          p->second = &it;
+        }
+      }
+    }
+
+    // Records of the body get local IDs, input blocks follow the blocks
+    std::vector<SchemeRecord> records;
+    std::vector<SchemeRecord> inputs;
+    std::unordered_map<ID, size_t> local;
+    std::unordered_map<ID, ID> internal;        // Ports between blocks of the body
+    ID nextPort = 0;
+    size_t params = 0;
+    for (ID id : blockIDs)
+    {
+      auto b = body.find(id);
+      if (b->second == nullptr)
+      {
+        throw CBlockEditorException("Block with ID " + std::to_string(id) + " doesnt exist", EErrorCode::E_INTERN);
+      }
+      if (local.count(id))
+      {
+        continue;
+      }
+      local[id] = records.size();
+      const CBlock& block = *b->second;
+
+      SchemeRecord rec;
+      rec.m_bt = block.getType();
+      rec.m_blockID = records.size();
+      rec.m_x = block.getPosition().first;
+      rec.m_y = block.getPosition().second;
+      rec.m_tn = block.getTypeName();
+      rec.m_mode = block.getReduceMode();
+      rec.m_macro = name;
+
+      for (size_t n = 1; n <= block.getInputCount(); n++)
+      {
+        Ports p = inputPort(n);
+        ID port;
+        auto producer = block.hasPort(p) ? producers.find(block.getPortID(p)) : producers.end();
+        const CBlock *from = producer != producers.end() ? producer->second : nullptr;
+
+        if (from && body.count(from->getID()))
+        {
+          port = internal.emplace(block.getPortID(p), nextPort).first->second;
+          nextPort++;
+        }
+        else
+        {
+          // Input block holding the value, or input of macro
+          SchemeRecord in;
+          in.m_bt = BT_INPUT;
+          in.m_tn = TN_INPUT;
+          in.m_macro = name;
+          in.m_fields = RF_OUTPUT;
+          in.m_output = port = nextPort++;
+          if (from && from->getType() == BT_INPUT)
+          {
+            in.m_value = from->getValue();
+            in.m_array = from->getArray();
+            in.m_file = from->getSource();
+          }
+          else
+          {
+            in.m_param = ++params;
+          }
+          inputs.push_back(std::move(in));
+        }
+
+        if (n == 1)
+        {
+          rec.m_input1 = port;
+          rec.m_fields |= RF_INPUT1;
+        }
+        else if (n == 2)
+        {
+          rec.m_input2 = port;
+          rec.m_fields |= RF_INPUT2;
+        }
+        else
+        {
+          rec.m_more.emplace_back(n, port);
+        }
+      }
+      records.push_back(std::move(rec));
+    }
+
+    // Output of block connected inside the body, the output of macro has none
+    for (auto& it : local)
+    {
+      const CBlock& block = *body[it.first];
+      auto port = block.hasPort(Ports::P_OUTPUT) ? internal.find(block.getPortID(Ports::P_OUTPUT)) : internal.end();
+      if (port != internal.end())
+      {
+        records[it.second].m_output = port->second;
+        records[it.second].m_fields |= RF_OUTPUT;
+      }
+    }
+    for (auto& in : inputs)
+    {
+      in.m_blockID = records.size();
+      records.push_back(std::move(in));
+    }
+
+    auto macro = std::make_shared<const CMacroDefinition>(name, std::move(records));
+    m_macros[name] = macro;
+
+    JournalRecord r;
+    r.m_op = JO_DEFINE_MACRO;
+    r.m_text = name + "\n";
+    for (ID blockID : blockIDs)
+    {
+      r.m_text += std::to_string(blockID) + " ";
+    }
+    journal(r);
+
+    return macro->getInputCount();
+  }
+
+  /**
+   * @brief Adds instance of macro, it has the inputs and type of values
+   *        of the definition
+   * @param name Name of defined macro
+   * @return ID of new block
+   */
+  ID CBlockScheme::addMacroBlock(const std::string& name)
+  {
+    auto macro = m_macros.find(name);
+    if (macro == m_macros.end())
+    {
+      throw CBlockEditorException("Macro " + name + " isnt defined", EErrorCode::E_INTERN);
+    }
+
+    ID id = createBlock(BT_MACRO, macro->second->getTypeName());
+    m_blocks.back().setMacro(macro->second);
+
+    JournalRecord r;
+    r.m_op = JO_ADD_MACRO;
+    r.m_blockID = id;
+    r.m_text = name;
+    journal(r);
+
+    return id;
+  }
+
+  /**
+   * @brief Get function
+   * @return Definitions of macros in order of their names
+   */
+  std::vector<MacroPtr> CBlockScheme::getMacros() const
+  {
+    std::vector<MacroPtr> macros;
+    for (auto& it : m_macros)
+    {
+      macros.push_back(it.second);
+    }
+    return macros;
+  }
+
+  /**
+   * @brief Saves full scheme to the file, attachJournal then records
+   *        following edits to journal of the file
+   * @param fileName Name of file where scheme will be saved
+   */
+  void CBlockScheme::saveScheme(CBlockScheme::Coords c, std::string& fileName)
+  {
+    TRACE_SPAN("saveScheme");
+    CStatTimer timer(m_stats.get(), ST_SAVE);
+
+    for (auto& it : c)
+    {
+      auto it2 = findBlock(it.first);
+      if (it2 != m_blocks.end())
+      {
+        it2->setPosition(it.second);
+      }
+    }
+
+    std::string data = serialize();
+    CSchemeJournal::writeSnapshot(fileName, data);
+    m_stats->add(SC_SAVE_BYTES, data.size());
+
+    // Journal of previous file isnt needed, scheme is saved here
+    closeJournal();
+    m_journal.reset(new CSchemeJournal(fileName, data));
+  }
+
+  /**
+   * @brief Scheme in the save file format
+   */
+  std::string CBlockScheme::serialize() const
+  {
+    TRACE_SPAN("serialize");
+    std::ostringstream ss;
+
+    // Definitions first, so instances follow the macros they use
+    for (auto& it : m_macros)
+    {
+      ss << *it.second;
+    }
+    for (auto& it : m_blocks)
+    {
+      ss << it;
+    }
+
+    return ss.str();
+  }
+
+  /**
+   * @brief Starts recording edits to journal of the file the scheme was
+   *        opened from or saved to
+   * @param fileName File passed to openScheme or saveScheme
+   */
+  void CBlockScheme::attachJournal(std::string& fileName)
+  {
+    if (!m_journal || m_journal->getSchemeFile() != fileName)
+    {
+      throw CBlockEditorException("Scheme wasnt opened from " + fileName, EErrorCode::E_INTERN);
+    }
+    m_journal->open();
+  }
+
+  /**
+   * @return True if saving to fileName only commits the journal
+   */
+  bool CBlockScheme::isJournaled(const std::string& fileName) const
+  {
+    return m_journal && m_journal->isOpen() && m_journal->getSchemeFile() == fileName;
+  }
+
+  /**
+   * @brief Saves scheme by committing edits in journal. Journal which
+   *        outgrew the scheme is compacted to new full scheme file on
+   *        background.
+   */
+  void CBlockScheme::commitJournal()
+  {
+    if (!m_journal || !m_journal->isOpen())
+    {
+      throw CBlockEditorException("Scheme has no journal", EErrorCode::E_INTERN);
+    }
+
+    TRACE_SPAN("commitJournal");
+    CStatTimer timer(m_stats.get(), ST_SAVE);
+    m_journal->commit();
+    if (m_journal->needsCompaction())
+    {
+      m_journal->compact(serialize());
+    }
+  }
+
+  /**
+   * @brief Stops recording edits, edits made since the last save are
+   *        discarded from journal
+   */
+  void CBlockScheme::closeJournal()
+  {
+    if (m_journal)
+    {
+      m_journal->close(true);
+      m_journal.reset();
+    }
+  }
+
+  /**
+   * @return Count of edits left in journal after the last save, these
+   *         are edits lost by crash
+   */
+  size_t CBlockScheme::unsavedEdits() const
+  {
+    return m_journal ? m_journal->unsavedCount() : 0;
+  }
+
+  /**
+   * @brief Applies edits left in journal after the last save
+   * @return Count of recovered edits
+   */
+  size_t CBlockScheme::recoverEdits()
+  {
+    if (!m_journal)
+    {
+      return 0;
+    }
+    return m_journal->recover([this](const JournalRecord& r) { applyRecord(r); });
+  }
+
+  /**
+   * @brief Records edit if scheme is journaled
+   */
+  void CBlockScheme::journal(const JournalRecord& r)
+  {
+    if (m_journal && m_journal->isOpen())
+    {
+      m_journal->append(r);
+    }
+  }
+
+  /**
+   * @brief Repeats edit read from journal, blocks get the IDs they had
+   *        when edit was made
+   */
+  void CBlockScheme::applyRecord(const JournalRecord& r)
+  {
+    unsigned long counter = m_blockCounter;
+
+    switch (r.m_op)
+    {
+      case JO_ADD_BLOCK:
+        setID(r.m_blockID);
+        addBlock(r.m_type, r.m_text);
+        break;
+      case JO_REMOVE_BLOCK:
+        removeBlock(r.m_blockID);
+        break;
+      case JO_REMOVE_BLOCKS:
+      {
+        std::istringstream ss(r.m_text);
+        std::vector<ID> blockIDs;
+        ID blockID;
+        while (ss >> blockID)
+        {
+          blockIDs.push_back(blockID);
+        }
+        removeBlocks(blockIDs);
+        break;
+      }
+      case JO_CLEAR:
+        removeAllBlocks();
+        break;
+      case JO_ADD_PORT:
+        addPort(r.m_blockID, r.m_otherID, r.m_port);
+        break;
+      case JO_REMOVE_PORT:
+        removePort(r.m_blockID, r.m_otherID, r.m_port);
+        break;
+      case JO_INPUT_VALUE:
+        setID(r.m_otherID);
+        addInputValue(r.m_blockID, r.m_value, r.m_port);
+        break;
+      case JO_INPUT_ARRAY:
+        setID(r.m_otherID);
+        addInputArray(r.m_blockID, r.m_text, r.m_port);
+        break;
+      case JO_REMOVE_INPUT:
+        removeInputValue(r.m_blockID, r.m_port);
+        break;
+      case JO_POSITION:
+        setPosition(r.m_blockID, {r.m_x, r.m_y});
+        break;
+      case JO_REDUCTION:
       {
-        if (!it.hasPort(whichPort))
+        auto it = findBlock(r.m_blockID);
+        if (it == m_blocks.end())
         {
-          throw CBlockEditorException(std::string("Removing port -- Block " + std::to_string(blockID_in) + " hasnt input port"), EErrorCode::E_INTERN);
+          throw CBlockEditorException(std::string("Block with ID ") + std::to_string(r.m_blockID) + " doesnt exist", EErrorCode::E_INTERN);
         }
-        it.removePort(whichPort);
+        setReduction(*it, r.m_x, static_cast<EReduceMode>(r.m_y));
         break;
       }
-    }
-  }
-
-  /**
-   * @brief Saves scheme in TODO xml/json format to the file
-   * @param fileName Name of file where scheme will be saved
-   */
-  void CBlockScheme::saveScheme(CBlockScheme::Coords c, std::string& fileName)
-  {
-    std::ofstream fd;
-    fd.open(fileName);
-
-    for (auto& it : c)
-    {
-      for (auto& it2 : m_blocks)
+      case JO_COLLAPSE:
+        collapseReductions();
+        break;
+      case JO_DEFINE_MACRO:
       {
-        if (it2.getID() == it.first)
+        size_t end = r.m_text.find('\n');
+        std::istringstream ss(r.m_text.substr(end == std::string::npos ? r.m_text.size() : end));
+        std::vector<ID> blockIDs;
+        ID blockID;
+        while (ss >> blockID)
         {
-          it2.setPosition(it.second);
-          break;
+          blockIDs.push_back(blockID);
         }
+        defineMacro(r.m_text.substr(0, end), blockIDs);
+        break;
       }
+      case JO_ADD_MACRO:
+        setID(r.m_blockID);
+        addMacroBlock(r.m_text);
+        break;
+      default:
+        break;
     }
 
-    for (auto& it : m_blocks)
-    {
-      fd << it;
-    }
-
-    fd.close();
+    m_blockCounter = std::max(counter, m_blockCounter);
   }
 
   /**
@@ -309,10 +1721,20 @@ namespace BlockEditorLogic
   void CBlockScheme::clearScheme()
   {
     m_blocks.clear();
+    m_macros.clear();
     m_actions.clear();
     m_blocksInScheme = 0;
     m_portCounter = 0;
     m_blockCounter = 0;
+
+    // Snapshots already published stay valid, they own their pages
+    m_version++;
+    m_slots.clear();
+    m_freeSlots.clear();
+    m_slotCount = 0;
+    m_portOwner.clear();
+    m_pages.clear();
+    m_dirtyPages.clear();
   }
 
   /**
@@ -322,134 +1744,244 @@ namespace BlockEditorLogic
    */
   CBlockScheme::PartBuffer CBlockScheme::loadScheme(std::string& fileName)
   {
-    std::ifstream fd;
+    openScheme(fileName);
+
+    // Get parts
+    CBlockScheme::PartBuffer pb = getParts();
+
+    //Clear current scheme
+    clearScheme();
+
+    // Return parts
+    return std::move(pb);
+  }
+
+  /**
+   * @brief Load scheme saved in the file and keep it in this scheme,
+   *        used when scheme is evaluated without GUI. File is parsed in
+   *        chunks on multiple threads, chunks are merged in file order so
+   *        result is the same as if file was read line by line. Saved edits
+   *        from journal of the file are replayed on top of it.
+   * @param fileName Name of file where scheme is saved
+   * @param threads Count of parsing threads, 0 means count of hardware threads
+   */
+  void CBlockScheme::openScheme(std::string& fileName, unsigned threads)
+  {
+    TRACE_SPAN("openScheme");
+    CStatTimer timer(m_stats.get(), ST_LOAD);
+
+    // Journal of previously opened file stays as it is
+    m_journal.reset();
+
+    std::vector<SchemeChunk> chunks;
+    {
+      TRACE_SPAN("parseSchemeFile");
+      CStatTimer parse(m_stats.get(), ST_LOAD_PARSE);
+      chunks = parseSchemeFile(fileName, threads);
+    }
+    buildScheme(chunks);
+
+    // Saved edits which didnt make it to the file yet
+    m_journal.reset(new CSchemeJournal(fileName));
+    m_journal->replay([this](const JournalRecord& r) { applyRecord(r); });
+  }
+
+  /**
+   * @brief Load scheme in the save file format from memory and keep it in
+   *        this scheme, the same way as openScheme. There is no file, so
+   *        edits arent journaled.
+   * @param data Text of the scheme
+   * @param size Length of the text
+   */
+  void CBlockScheme::readScheme(const char *data, size_t size)
+  {
+    TRACE_SPAN("readScheme");
+    CStatTimer timer(m_stats.get(), ST_LOAD);
+
+    m_journal.reset();
+
+    std::vector<SchemeChunk> chunks;
+    {
+      TRACE_SPAN("parseSchemeText");
+      CStatTimer parse(m_stats.get(), ST_LOAD_PARSE);
+      chunks = parseSchemeText(data, size);
+    }
+    buildScheme(chunks);
+  }
+
+  /**
+   * @brief Replaces blocks of the scheme by the parsed ones
+   * @param chunks Records of the scheme in file order
+   */
+  void CBlockScheme::buildScheme(const std::vector<SchemeChunk>& chunks)
+  {
     std::unordered_map<ID, CPort*> ports;
-    std::string delimiter = ":";
-    std::string line, token1, token2;
-    EBlockType bt; ID bID, maxID = 0, maxIDport = 0; int x, y; PortValue pv = .0;
-    TypeName tn;
-    CPort *p1 = nullptr, *p2 = nullptr, *p3 = nullptr;
+    EBlockType bt = BT_INPUT; ID bID = 0, maxID = 0, maxIDport = 0; int x = 0, y = 0; PortValue pv = .0;
+    TypeName tn; std::string file; PortArrayPtr pa;
+    unsigned portFields = 0; ID in1 = 0, in2 = 0, out = 0;
+    std::vector<std::pair<size_t, ID>> more; EReduceMode mode = RM_PLAIN;
+    std::string macro; size_t param = 0;
 
-    fd.open(fileName);
+    // Blocks of bodies by macro, instances by index of block
+    std::map<std::string, std::vector<SchemeRecord>> bodies;
+    std::vector<std::pair<size_t, std::string>> instances;
 
     // Clear ports
     clearScheme();
 
-    while (std::getline(fd, line))
-    {
-      token1 = line.substr(0, line.find(delimiter));
-      token2 = line.substr(line.find(delimiter) + 1);
+    // Ports are shared by blocks, first record using port ID creates it
+    auto port = [&ports](ID id) {
+      CPort *&p = ports[id];
+      if (p == nullptr)
+      {
+        p = new CPort(id);
+      }
+      return p;
+    };
 
-      try
+    for (auto& chunk : chunks)
+    {
+      for (auto& rec : chunk.m_records)
       {
-        if (token1 == "Type")
-        {
-          bt = static_cast<EBlockType>(std::stoi(token2));
-        }
-        else if (token1 == "ID")
-        {
-          bID = std::stoul(token2, nullptr, 0);
-          if (bID > maxID) maxID = bID;
-        }
-        else if (token1 == "Position X")
-        {
-          x = std::stoi(token2);
-        }
-        else if (token1 == "Position Y")
-        {
-          y = std::stoi(token2);
-        }
-        else if (token1 == "Input value")
+        // Fields missing in record keep values of previous record
+        if (rec.m_fields & RF_TYPE)       bt = rec.m_bt;
+        if (rec.m_fields & RF_ID)         bID = rec.m_blockID;
+        if (rec.m_fields & RF_X)          x = rec.m_x;
+        if (rec.m_fields & RF_Y)          y = rec.m_y;
+        if (rec.m_fields & RF_TYPE_NAME)  tn = rec.m_tn;
+        if (rec.m_fields & RF_VALUE)      pv = rec.m_value;
+        if (rec.m_fields & RF_FILE)       { file = rec.m_file; pa = rec.m_array; }
+        if (rec.m_fields & RF_INPUT1)     in1 = rec.m_input1;
+        if (rec.m_fields & RF_INPUT2)     in2 = rec.m_input2;
+        if (rec.m_fields & RF_OUTPUT)     out = rec.m_output;
+        if (rec.m_fields & RF_MODE)       mode = rec.m_mode;
+        if (rec.m_fields & RF_MACRO)      macro = rec.m_macro;
+        if (rec.m_fields & RF_PARAM)      param = rec.m_param;
+        portFields |= rec.m_fields & (RF_INPUT1 | RF_INPUT2 | RF_OUTPUT);
+        more.insert(more.end(), rec.m_more.begin(), rec.m_more.end());
+
+        if (!rec.m_complete)
         {
-          if (token2 == "None") continue;
-          pv = stod(token2);
+          continue;
         }
-        else if (token1 == "Type name")
+
+        // Block of macro body, its ports are local to the body
+        if (!macro.empty() && bt != BT_MACRO)
         {
-          tn = std::string(token2);
+          SchemeRecord b;
+          b.m_fields = portFields;
+          b.m_bt = bt; b.m_blockID = bID; b.m_x = x; b.m_y = y; b.m_value = pv; b.m_tn = tn;
+          b.m_file = file; b.m_array = pa;
+          b.m_input1 = in1; b.m_input2 = in2; b.m_output = out;
+          b.m_more = std::move(more); b.m_mode = mode;
+          b.m_macro = macro; b.m_param = param;
+          bodies[macro].push_back(std::move(b));
         }
-        else if (token1 == "Input 1 ID")
+        else
         {
-          if (token2 == "None") continue;
-          ID id = std::stoi(token2);
-          if (ports.count(id) > 0)
-          {
-            p1 = ports[id];
-          }
-          else
+          CPort *p1 = (portFields & RF_INPUT1) ? port(in1) : nullptr;
+          CPort *p2 = (portFields & RF_INPUT2) ? port(in2) : nullptr;
+          CPort *p3 = (portFields & RF_OUTPUT) ? port(out) : nullptr;
+
+          // Save block
+          CBlock b(bID, bt, x, y, pv, p1, p2, p3, tn);
+          if (pa)
           {
-            p1 = new CPort(id);
-            ports[id] = p1;
+            b.setInputArray(pa, file);
           }
-        }
-        else if (token1 == "Input 2 ID")
-        {
-          if (token2 == "None") continue;
-          ID id = std::stoi(token2);
-          if (ports.count(id) > 0)
+          if (!more.empty() && !isReduction(bt) && bt != BT_MACRO)
           {
-            p2 = ports[id];
+            throw CBlockEditorException("Block " + std::to_string(bID) + " has more than two inputs,"
+                      " but it isnt reduction", EErrorCode::E_UI_BAD_FILE);
           }
-          else
+          for (auto& in : more)
           {
-            p2 = new CPort(id);
-            ports[id] = p2;
+            b.addInputPort(inputPort(in.first), in.second == NO_PORT ? nullptr : port(in.second));
           }
-        }
-        else if (token1 == "Output ID")
-        {
-          if (token2 != "None")
+          b.setReduceMode(mode);
+          if (bt == BT_MACRO)
           {
-            ID id = std::stoi(token2);
-            if (ports.count(id) > 0)
-            {
-              p3 = ports[id];
-            }
-            else
+            if (macro.empty())
             {
-              p3 = new CPort(id);
-              ports[id] = p3;
+              throw CBlockEditorException("Macro block " + std::to_string(bID) + " hasnt name of macro", EErrorCode::E_UI_BAD_FILE);
             }
+            instances.emplace_back(m_blocks.size(), macro);
           }
-
-          // Save block
-          CBlock b(bID, bt, x, y, pv, p1, p2, p3, tn);
           this->m_blocks.push_back(b);
+          takeSlot(bID);
+          if (p3)
+          {
+            m_portOwner[p3->getPortID()] = bID;
+          }
 
           b.setPort(Ports::P_OUTPUT);
-
-          // Reset values
-          pv = .0; p1 = nullptr; p2 = nullptr; p3 = nullptr;
-        }
-        else
-        {
-          throw CBlockEditorException("", EErrorCode::E_UI_BAD_FILE);
         }
-      } catch (std::exception& e)
+
+        // Reset values
+        pv = .0; portFields = 0;
+        pa.reset(); file.clear(); more.clear(); mode = RM_PLAIN;
+        macro.clear(); param = 0;
+      }
+
+      if (chunk.m_failed)
       {
         throw CBlockEditorException(std::string("Something went bad when"
-                  " laoding scheme (Probably wrong file format) -- " + std::string(e.what())), EErrorCode::E_UI_BAD_FILE);
+                  " laoding scheme (Probably wrong file format) -- " + chunk.m_error), EErrorCode::E_UI_BAD_FILE);
       }
+
+      // Find out max IDs (block; port) used in scheme
+      maxID = std::max(maxID, chunk.m_maxID);
+      maxIDport = std::max(maxIDport, chunk.m_maxPortID);
     }
 
-    // Find out max IDs (block; port) used in scheme
-    for (const auto &pair : ports)
+    // Definitions are compiled once all records were read, instances share them
+    for (auto& it : bodies)
     {
-      if (pair.first > maxIDport)
-        maxIDport = pair.first;
+      m_macros[it.first] = std::make_shared<const CMacroDefinition>(it.first, std::move(it.second));
+    }
+    for (auto& it : instances)
+    {
+      auto macro = m_macros.find(it.second);
+      if (macro == m_macros.end())
+      {
+        throw CBlockEditorException("Macro " + it.second + " isnt defined", EErrorCode::E_UI_BAD_FILE);
+      }
+      CBlock& b = m_blocks[it.first];
+      for (size_t n = macro->second->getInputCount() + 1; n <= b.getInputCount(); n++)
+      {
+        if (b.hasPort(inputPort(n)))
+        {
+          throw CBlockEditorException("Block " + std::to_string(b.getID()) + " has more inputs than macro "
+                    + it.second, EErrorCode::E_UI_BAD_FILE);
+        }
+      }
+      b.setMacro(macro->second);
     }
+
     m_blockCounter = maxID+1;
     m_portCounter = maxIDport+1;
-    fd.close();
-
-    // Get parts
-    CBlockScheme::PartBuffer pb = getParts();
+    m_blocksInScheme = m_blocks.size();
+    m_stats->add(SC_LOAD_BLOCKS, m_blocks.size());
 
-    //Clear current scheme
-    clearScheme();
+    // Parsed records are freed only now, so memory is the highest here
+    {
+      CMemoryCounter c;
+      SchemeMemory m;
+      countMemory(c, m);
 
-    // Return parts
-    return std::move(pb);
+      uint64_t bytes = m.getTotal() + CMemoryCounter::hashBytes(ports) + CMemoryCounter::vectorBytes(chunks);
+      for (auto& chunk : chunks)
+      {
+        bytes += CMemoryCounter::vectorBytes(chunk.m_records) + CMemoryCounter::stringBytes(chunk.m_error);
+        for (auto& rec : chunk.m_records)
+        {
+          bytes += CMemoryCounter::stringBytes(rec.m_tn) + CMemoryCounter::stringBytes(rec.m_file)
+                 + CMemoryCounter::stringBytes(rec.m_macro)
+                 + c.arrayBytes(rec.m_array) + CMemoryCounter::vectorBytes(rec.m_more);
+        }
+      }
+      m_stats->peak(SP_LOAD_BYTES, bytes);
+    }
   }
 
   /**
@@ -459,17 +1991,60 @@ namespace BlockEditorLogic
    */
   CBlockScheme::PartBuffer CBlockScheme::getParts() const
   {
+    TRACE_SPAN("getParts");
+    CStatTimer timer(m_stats.get(), ST_GET_PARTS);
     CBlockScheme::PartBuffer pb;
     EBlockType bt;
     ID id, idPort;
     std::pair<int, int> coords;
     PortValue vin1, vin2;
+    std::string fin1, fin2;
     ID in1, in2, out;
     Port p1, p2, p3;
     Ports which;
     CPort *p;
     TypeName tn;
 
+    // Index blocks & users of ports once, so lookups below dont scan
+    // whole scheme for every port (keeps order of blocks in scheme)
+    std::unordered_map<ID, const CBlock*> blocks;
+    std::unordered_map<ID, std::vector<std::pair<ID, Ports>>> portUsers;
+
+    blocks.reserve(m_blocks.size());
+    portUsers.reserve(m_blocks.size() * 2);
+    for (auto& it : m_blocks)
+    {
+      blocks.emplace(it.getID(), &it);
+      for (size_t n = 0; n <= it.getInputCount(); n++)
+      {
+        Ports w = n == 0 ? Ports::P_OUTPUT : inputPort(n);
+        if (it.hasPort(w))
+        {
+          portUsers[it.getPortID(w)].emplace_back(it.getID(), w);
+        }
+      }
+    }
+
+    auto findPortUser = [&portUsers](ID portID, ID blockID) {
+      for (auto& user : portUsers[portID])
+      {
+        if (user.first != blockID)
+        {
+          return user;
+        }
+      }
+      throw CBlockEditorException(std::string("Could not find block with port with specified ID " + std::to_string(portID) + " " + std::to_string(blockID)), EErrorCode::E_INTERN);
+    };
+
+    auto findBlock = [&blocks](ID blockID) -> const CBlock& {
+      auto it = blocks.find(blockID);
+      if (it == blocks.end())
+      {
+        throw CBlockEditorException("Couldnt find block", EErrorCode::E_INTERN);
+      }
+      return *it->second;
+    };
+
     for (auto& it : m_blocks)
     {
       bt = it.getType();
@@ -478,22 +2053,25 @@ namespace BlockEditorLogic
         id = it.getID();
         coords = it.getPosition();
         tn = it.getTypeName();
+        fin1.clear(); fin2.clear();
 
         // Input port 1
         if (it.hasPort(Ports::P_INPUT1))
         {
           p = it.getPort(Ports::P_INPUT1);
           idPort = p->getPortID();
-          std::pair<ID, Ports> p = findBlockByPortID(idPort, id);
+          std::pair<ID, Ports> p = findPortUser(idPort, id);
           if (p.second != Ports::P_OUTPUT)
           {
             throw CBlockEditorException(std::string("Input port connected to input port " + std::to_string(id) + " " + std::to_string(p.first)), EErrorCode::E_INTERN);
           }
           // Its input block
-          if (isInput(p.first))
+          const CBlock& src = findBlock(p.first);
+          if (src.getType() == BT_INPUT)
           {
             p1 = VALUE;
-            vin1 = getInputValue(p.first);
+            vin1 = src.getValue();
+            fin1 = src.hasArray() ? src.getSource() : std::string();
           }
           // Its normal block
           else
@@ -512,16 +2090,18 @@ namespace BlockEditorLogic
         {
           p = it.getPort(Ports::P_INPUT2);
           idPort = p->getPortID();
-          std::pair<ID, Ports> p = findBlockByPortID(idPort, id);
+          std::pair<ID, Ports> p = findPortUser(idPort, id);
           if (p.second != Ports::P_OUTPUT)
           {
             throw CBlockEditorException("Input port connected to input port", EErrorCode::E_INTERN);
           }
           // Its input block
-          if (isInput(p.first))
+          const CBlock& src = findBlock(p.first);
+          if (src.getType() == BT_INPUT)
           {
             p2 = VALUE;
-            vin2 = getInputValue(p.first);
+            vin2 = src.getValue();
+            fin2 = src.hasArray() ? src.getSource() : std::string();
           }
           // Its normal block
           else
@@ -540,7 +2120,7 @@ namespace BlockEditorLogic
         {
           p = it.getPort(Ports::P_OUTPUT);
           idPort = p->getPortID();
-          std::pair<ID, Ports> p = findBlockByPortID(idPort, id);
+          std::pair<ID, Ports> p = findPortUser(idPort, id);
           if (p.second == Ports::P_OUTPUT)
           {
             throw CBlockEditorException("Output port connected to output port", EErrorCode::E_INTERN);
@@ -555,7 +2135,7 @@ namespace BlockEditorLogic
         }
 
         pb.push_back(SchemePart{bt, id, coords, p1, p2, p3, vin1, vin2,
-                                in1, in2, out, which, tn});
+                                in1, in2, out, which, tn, fin1, fin2});
       }
     }
 
@@ -595,6 +2175,13 @@ namespace BlockEditorLogic
           return {it->getID(), Ports::P_INPUT2};
         }
       }
+      for (size_t n = 3; n <= it->getInputCount(); n++)
+      {
+        if (it->hasPort(inputPort(n)) && it->getPortID(inputPort(n)) == portID)
+        {
+          return {it->getID(), inputPort(n)};
+        }
+      }
       if (it->hasPort(Ports::P_OUTPUT))
       {
         p = it->getPort(Ports::P_OUTPUT);
@@ -657,107 +2244,275 @@ namespace BlockEditorLogic
   }
 
   /**
-   * @brief Runs the scheme
-   * @return Buffer of actions to do in GUI in right order
+   * @brief Evaluates snapshot of the scheme, see CSchemeSnapshot::run
+   * @return Results of blocks in order they were computed
    */
   CBlockScheme::ActionBuffer CBlockScheme::run()
   {
-    CPort* p1;
-    CPort* p2;
-    bool changed;
-    std::vector<ID> v;
+    CEvalContext ctx;
+    snapshot()->run(ctx);
+    this->m_actions = ctx.takeActions();
+
+    return this->m_actions;
+  }
 
-    /// Clear actions buffer
-    this->m_actions.clear();
+  /**
+   * @brief Evaluates the scheme in given context. Scheme is only read, so
+   *        any number of threads can run it at once, each in its own
+   *        context, as long as no thread edits it meanwhile. Snapshot taken
+   *        after the last edit is evaluated, if there isnt any, the run
+   *        makes one for itself, call snapshot() after editing to share it.
+   * @param ctx Context of the run, results are left there
+   */
+  void CBlockScheme::run(CEvalContext& ctx) const
+  {
+    getSnapshot()->run(ctx);
+  }
 
-    /// First iterate over input blocks and set their ports
-    for (auto& it : m_blocks)
+  /**
+   * @brief Snapshot of the current version without publishing it, safe to
+   *        call from many threads at once
+   * @return Published snapshot if it is current, new one otherwise
+   */
+  SnapshotPtr CBlockScheme::getSnapshot() const
+  {
+    if (m_snapshot && m_snapshot->getVersion() == m_version)
     {
-      if (it.getType() == BT_INPUT)
-      {
-        v.emplace_back(it.getID());
-        p1 = it.getPort(Ports::P_OUTPUT);
-        if (p1 == nullptr)
-          throw CBlockEditorException("Block hasnt output port", EErrorCode::E_UI_NOT_CON);
-        //p1->setPortName(TN_NUMBER1);
-        p1->setPortValue(it.getValue());
-      }
+      return m_snapshot;
     }
+    return makeSnapshot();
+  }
+
+  /**
+   * @brief Snapshot of the current version with values assigned to some
+   *        input ports replaced, the scheme is not changed. Safe to call
+   *        from many threads at once, the same way as run(CEvalContext&).
+   * @param inputs Ports and their values, ports must have value assigned
+   * @return The snapshot
+   */
+  SnapshotPtr CBlockScheme::withInputs(const std::vector<InputValue>& inputs) const
+  {
+    SnapshotPtr snap = getSnapshot();
+    std::vector<SlotValue> values;
+    values.reserve(inputs.size());
 
-    /// Then keep iteration over other blocks while any of port values changes
-    while (true)
+    for (auto& it : inputs)
     {
-      changed = false;
-      for (auto& it : m_blocks)
-      {
-        // Weve already been in this block, skip it
-        if (std::find(v.begin(), v.end(), it.getID()) != v.end())
-        {
-          continue;
-        }
+      values.push_back(SlotValue{getInputSlot(*snap, it.m_blockID, it.m_port), it.m_value, nullptr});
+    }
 
-        if (it.getType() != BT_INPUT)
-        {
+    return values.empty() ? snap : snap->withValues(values);
+  }
 
-          // Ma oba vstupni porty ? Pokud ne chyba
+  /**
+   * @brief Slot of input block holding value assigned to port, its value
+   *        is replaced by CSchemeSnapshot::withValues
+   * @param snap Snapshot of the current version
+   * @param blockID Block with the port
+   * @param whichPort Input port with value assigned
+   * @return Slot of the input block in snap
+   */
+  size_t CBlockScheme::getInputSlot(const CSchemeSnapshot& snap, ID blockID, Ports whichPort) const
+  {
+    auto slot = m_slots.find(blockID);
+    m_stats->add(SC_INDEX_LOOKUPS);
+    if (slot == m_slots.end())
+    {
+      throw CBlockEditorException("Block " + std::to_string(blockID) + " doesnt exist", EErrorCode::E_INTERN);
+    }
 
-          if (!it.hasPort(Ports::P_INPUT1) || !it.hasPort(Ports::P_INPUT2))
-            throw CBlockEditorException(
-              "Input value missing for some blocks. Make sure all input ports are either connected or have a value assigned.",
-               EErrorCode::E_UI_NOT_CON);
+    const SnapshotNode& node = snap.getNode(slot->second);
+    size_t n = inputNumber(whichPort);
+    size_t in = n >= 1 && n <= node.getInputCount() ? node.getInput(n - 1) : NO_SLOT;
+    if (node.m_bt == BT_INPUT || in == NO_SLOT || snap.getNode(in).m_bt != BT_INPUT)
+    {
+      throw CBlockEditorException("Port of block " + std::to_string(blockID) + " hasnt value assigned",
+                                  EErrorCode::E_UI_NOT_CON);
+    }
+    return in;
+  }
 
-          // Jsou oba vstupni porty s hodnotou ?
-          //  - Nastav changed = true;
-          //  - Proved operaci s hodnotami
-          //  - Nastav hodnotu vystupnimu portu
-          //  - ! Zkontrolovat jestli uz se v tomto bloku hodnota nepocitala (priznak)
+  /**
+   * @brief Publishes immutable snapshot of the current topology and input
+   *        values. Pages without changed blocks are shared with the previous
+   *        snapshot, snapshot of unchanged scheme is returned again.
+   * @return Snapshot tagged with version of the scheme
+   */
+  SnapshotPtr CBlockScheme::snapshot()
+  {
+    if (m_snapshot && m_snapshot->getVersion() == m_version)
+    {
+      return m_snapshot;
+    }
 
-          p1 = it.getPort(Ports::P_INPUT1);
-          p2 = it.getPort(Ports::P_INPUT2);
+    m_snapshot = makeSnapshot();
+    m_pages = m_snapshot->getPages();
+    m_dirtyPages.assign(m_pages.size(), false);
+    return m_snapshot;
+  }
 
-          if (p1->hasValue() && p2->hasValue())
-          {
-            // Unset values for next runs
-            p1->unsetValue();
-            p2->unsetValue();
+  /**
+   * @brief Makes snapshot of the current version, only pages with changed
+   *        blocks are built, others are taken from the last snapshot
+   * @return New snapshot, not published
+   */
+  SnapshotPtr CBlockScheme::makeSnapshot() const
+  {
+    TRACE_SPAN("snapshot");
+    CStatTimer timer(m_stats.get(), ST_SNAPSHOT);
+    const size_t pageSize = CSchemeSnapshot::PAGE_SIZE;
+    size_t pages = (m_slotCount + pageSize - 1) / pageSize;
+
+    std::vector<CSchemeSnapshot::PagePtr> result(pages);
+    std::vector<std::shared_ptr<CSchemeSnapshot::Page>> fresh(pages);
+    bool changed = false;
+    for (size_t i = 0; i < pages; i++)
+    {
+      if (i < m_pages.size() && m_pages[i] && !(i < m_dirtyPages.size() && m_dirtyPages[i]))
+      {
+        result[i] = m_pages[i];
+        continue;
+      }
+      fresh[i] = std::make_shared<CSchemeSnapshot::Page>(pageSize);
+      m_stats->add(SC_SNAPSHOT_PAGES);
+      changed = true;
+    }
 
-            // Add ID of block to buffer
-            v.emplace_back(it.getID());
-            // Weve changed any port, keep iterating
-            changed = true;
-            PortValue pv = it.performOperation(p1->getPortValue(), p2->getPortValue());
+    // Slot of block which owns port as output
+    uint64_t lookups = 0;
+    auto producer = [this, &lookups](const CPort *p) {
+      if (p == nullptr)
+      {
+        return NO_SLOT;
+      }
+      lookups += 2;
+      auto owner = m_portOwner.find(p->getPortID());
+      if (owner == m_portOwner.end())
+      {
+        return NO_SLOT;
+      }
+      auto slot = m_slots.find(owner->second);
+      return slot == m_slots.end() ? NO_SLOT : slot->second;
+    };
 
-            if (it.getTypeName() == "INT" || it.getTypeName() == "HEX")
-            {
-              pv = static_cast<int>(pv);
-            }
+    // Fill changed pages, removed blocks leave their slots empty
+    for (auto& it : m_blocks)
+    {
+      if (!changed)
+      {
+        break;
+      }
+      size_t slot = m_slots.at(it.getID());
+      lookups++;
+      auto& page = fresh[slot / pageSize];
+      if (!page)
+      {
+        continue;
+      }
 
-            m_actions.push_back(std::move(CBlockAction{it.getID(), pv}));
+      SnapshotNode& node = (*page)[slot % pageSize];
+      node.m_used = true;
+      node.m_blockID = it.getID();
+      node.m_bt = it.getType();
+      node.m_integral = it.getTypeName() == TN_INTEGER || it.getTypeName() == TN_HEXA;
+      node.m_input1 = producer(it.getPort(Ports::P_INPUT1));
+      node.m_input2 = producer(it.getPort(Ports::P_INPUT2));
+      for (size_t n = 3; n <= it.getInputCount(); n++)
+      {
+        node.m_more.push_back(producer(it.getPort(inputPort(n))));
+      }
+      node.m_mode = it.getReduceMode();
+      node.m_macro = it.getMacro();
+      node.m_connected = it.hasPort(Ports::P_OUTPUT);
+      if (it.getType() == BT_INPUT)
+      {
+        node.m_value = it.getValue();
+        node.m_array = it.getArray();
+      }
+    }
 
-            p1 = it.getPort(Ports::P_OUTPUT);
-            if (p1 == nullptr)
-            {
-              continue;
-            }
-            //p1->setPortName(TN_NUMBER1);
-            p1->setPortValue(pv);
-          }
-          else
-          {
-            continue;
-          }
-        }
+    for (size_t i = 0; i < pages; i++)
+    {
+      if (fresh[i])
+      {
+        result[i] = std::move(fresh[i]);
       }
-      if (!changed) break;
     }
 
-    // Did we check all blocks in sheme ? If not there is cycle
-    if (m_blocksInScheme != v.size())
+    m_stats->add(SC_INDEX_LOOKUPS, lookups);
+    return std::make_shared<const CSchemeSnapshot>(m_version, std::move(result), m_stats);
+  }
+
+  /**
+   * @brief Starts evaluation of the current snapshot which computes one
+   *        block per step, see CSchemeEvaluation
+   * @return Evaluation, no block is computed yet
+   */
+  std::unique_ptr<CSchemeEvaluation> CBlockScheme::evaluate()
+  {
+    return std::unique_ptr<CSchemeEvaluation>(new CSchemeEvaluation(snapshot()));
+  }
+
+  /**
+   * @return Version of the scheme, changes with topology or input values
+   */
+  uint64_t CBlockScheme::getVersion() const
+  {
+    return m_version;
+  }
+
+  /**
+   * @brief Assigns snapshot slot to new block
+   */
+  void CBlockScheme::takeSlot(ID blockID)
+  {
+    size_t slot;
+    if (!m_freeSlots.empty())
+    {
+      slot = m_freeSlots.back();
+      m_freeSlots.pop_back();
+    }
+    else
+    {
+      slot = m_slotCount++;
+    }
+    m_slots[blockID] = slot;
+    touch(blockID);
+  }
+
+  /**
+   * @brief Frees snapshot slot of removed block
+   */
+  void CBlockScheme::releaseSlot(ID blockID)
+  {
+    m_stats->add(SC_INDEX_LOOKUPS);
+    auto it = m_slots.find(blockID);
+    if (it != m_slots.end())
     {
-      throw CBlockEditorException("Detected cycle in the scheme", EErrorCode::E_UI_CYCLE);
+      touch(blockID);
+      m_freeSlots.push_back(it->second);
+      m_slots.erase(it);
     }
+  }
 
-    return this->m_actions;
+  /**
+   * @brief Marks block as changed, its page is built again by next snapshot
+   */
+  void CBlockScheme::touch(ID blockID)
+  {
+    m_version++;
+
+    m_stats->add(SC_INDEX_LOOKUPS);
+    auto it = m_slots.find(blockID);
+    if (it != m_slots.end())
+    {
+      size_t page = it->second / CSchemeSnapshot::PAGE_SIZE;
+      if (page >= m_dirtyPages.size())
+      {
+        m_dirtyPages.resize(page + 1, true);
+      }
+      m_dirtyPages[page] = true;
+    }
   }
 
 }
\ No newline at end of file
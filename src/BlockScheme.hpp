@@ -13,12 +13,24 @@
 #include <deque>
 #include <memory>
 #include <fstream>
+#include <map>
+#include <sstream>
 #include <vector>
 #include <algorithm>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "BlockAction.hpp"
 #include "Block.hpp"
+#include "MacroDefinition.hpp"
+#include "ArrayFile.hpp"
+#include "SchemeParser.hpp"
+#include "SchemeJournal.hpp"
+#include "SchemeSnapshot.hpp"
+#include "SchemeEvaluation.hpp"
+#include "SchemeBatch.hpp"
+#include "SchemeStats.hpp"
+#include "SchemeMemory.hpp"
 #include "Error.hpp"
 #include "TypeName.hpp"
 #include "BlockEditorException.hpp"
@@ -52,30 +64,93 @@ namespace BlockEditorLogic
     /// Functions called from GUI
     void          saveScheme(Coords, std::string&);
     PartBuffer    loadScheme(std::string&);
+    void          openScheme(std::string&, unsigned threads = 0);
+    void          readScheme(const char *, size_t);
+    PartBuffer    getParts() const;
 
     ActionBuffer  run();
+    void          run(CEvalContext&) const;
+    SnapshotPtr   getSnapshot() const;
+    SnapshotPtr   withInputs(const std::vector<InputValue>&) const;
+    size_t        getInputSlot(const CSchemeSnapshot&, ID, Ports) const;
+    SnapshotPtr   snapshot();
+    std::unique_ptr<CSchemeEvaluation> evaluate();
+    uint64_t      getVersion() const;
 
     /* ! Used from GUI when loading saved scheme ! */
     void          setID(ID);
 
     ID            addBlock(EBlockType, TypeName);
     void          removeBlock(ID);
+    void          removeBlocks(const std::vector<ID>&);
+    void          removeAllBlocks();
 
     void          addInputValue(ID, PortValue, Ports);
+    void          addInputArray(ID, const std::string&, Ports);
     void          removeInputValue(ID, Ports);
+    void          setInputArray(ID, Ports, PortArrayPtr);
+    std::string   getInputSummary(ID, Ports) const;
+    std::vector<ID> getOutputBlocks() const;
+    bool          hasBlock(ID) const;
 
     void          addPort(ID, ID, Ports);
     void          removePort(ID, ID, Ports);
+    void          setPosition(ID, std::pair<int, int>);
+
+    /// Reduction blocks, see EBlockType
+    void          setInputCount(ID, size_t);
+    void          setReduceMode(ID, EReduceMode);
+    size_t        collapseReductions();
+
+    /// Sub-schemes defined once and instanced by macro blocks, see CMacroDefinition
+    size_t        defineMacro(const std::string&, const std::vector<ID>&);
+    ID            addMacroBlock(const std::string&);
+    std::vector<MacroPtr> getMacros() const;
+
+    /// Many edits at once, see CSchemeBatch
+    CSchemeBatch  batch() const;
+    void          applyBatch(const CSchemeBatch&);
+
+    /// Journal of edits, saving a journaled scheme only appends to it
+    void          attachJournal(std::string&);
+    bool          isJournaled(const std::string&) const;
+    void          commitJournal();
+    void          closeJournal();
+    size_t        unsavedEdits() const;
+    size_t        recoverEdits();
+
+    /// Counters and timers of phases, see CSchemeStats
+    SchemeStats   getStats() const;
+    void          resetStats();
+    void          exportStats(const std::string&) const;
+
+    /// Bytes of memory used by the scheme, see SchemeMemory
+    SchemeMemory  getMemory() const;
 
     /// Debug
     void          debug_printBlocks() const;
 
     void          clearScheme();
+
   protected:
-    PartBuffer    getParts() const;
+    BlockBuffer::iterator findBlock(ID);
+    ID            createBlock(EBlockType, TypeName);
+    void          connectPort(ID, ID, Ports);
+    void          linkPorts(CBlock&, CBlock&, Ports);
+    CBlock*       addInputBlock(ID, Ports);
+    void          setReduction(CBlock&, size_t, EReduceMode);
     std::pair<ID, Ports> findBlockByPortID(ID, ID) const;
     bool          isInput(ID) const;
     PortValue     getInputValue(ID) const;
+    std::string   serialize() const;
+    void          buildScheme(const std::vector<SchemeChunk>&);
+    SnapshotPtr   makeSnapshot() const;
+    void          countMemory(CMemoryCounter&, SchemeMemory&) const;
+    void          journal(const JournalRecord&);
+    void          applyRecord(const JournalRecord&);
+    void          takeSlot(ID);
+    void          releaseSlot(ID);
+    void          touch(ID);
 
   private:
     unsigned long             m_blockCounter;     /**< Counter of block ID's in scheme */
@@ -83,5 +158,19 @@ namespace BlockEditorLogic
     unsigned long             m_blocksInScheme;   /**< Counter of blocks in scheme */
     BlockBuffer               m_blocks;           /**< Buffer of blocks used in scheme */
     ActionBuffer              m_actions;          /**< Buffer of actions in scheme */
+    std::unique_ptr<CSchemeJournal> m_journal;    /**< Journal of the opened/saved scheme file */
+    std::map<std::string, MacroPtr> m_macros;     /**< Definitions of macros by name */
+
+    /// Snapshots of topology, see CSchemeSnapshot
+    uint64_t                  m_version;          /**< Incremented by every change of topology or input values */
+    std::unordered_map<ID, size_t> m_slots;       /**< Slot of block in snapshots */
+    std::vector<size_t>       m_freeSlots;        /**< Slots of removed blocks */
+    size_t                    m_slotCount;        /**< Slots ever used */
+    std::unordered_map<ID, ID> m_portOwner;       /**< Block whose output port has the port ID */
+    std::vector<CSchemeSnapshot::PagePtr> m_pages;/**< Pages of the last snapshot */
+    std::vector<bool>         m_dirtyPages;       /**< Pages changed since the last snapshot */
+    SnapshotPtr               m_snapshot;         /**< The last snapshot */
+
+    StatsPtr                  m_stats;            /**< Counters shared with snapshots */
   };
 }
\ No newline at end of file
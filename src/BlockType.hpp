@@ -26,6 +26,30 @@ namespace BlockEditorLogic
 		BT_MUL,     		/**< Type of block which performs mul operation on inputs */
 		BT_DIV,     		/**< Type of block which performs div operation on inputs */
 		BT_POW,					/**< Type of block which performs pow operation first^second input */
+		BT_SUM,					/**< Sum of any number of inputs */
+		BT_PRODUCT,			/**< Product of any number of inputs */
+		BT_MIN,					/**< Minimum of any number of inputs */
+		BT_MAX,					/**< Maximum of any number of inputs */
+		BT_MACRO,				/**< Instance of macro, sub-scheme defined once -- see MacroDefinition.hpp */
 		// TODO: BT_ADD_STRING,      /**< Type of block which performs concatenation on two strings */
 	};
+
+	///
+	/// Order in which SUM block adds its inputs
+	///
+	enum EReduceMode
+	{
+		RM_PLAIN = 0,		/**< Sequential left fold in order of inputs, like a chain of ADD (MUL) blocks */
+		RM_KAHAN,				/**< Compensated summation, error doesnt grow with count of inputs */
+		RM_PAIRWISE,		/**< Halves are summed recursively, error grows with log of count */
+	};
+
+	/**
+	 * @brief Reduction blocks have any number of inputs, two at least
+	 * @return True if blocks of the type are reductions
+	 */
+	inline bool isReduction(EBlockType bt)
+	{
+		return bt >= BT_SUM && bt <= BT_MAX;
+	}
 }
\ No newline at end of file
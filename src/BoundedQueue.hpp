@@ -0,0 +1,102 @@
+/**
+ *		@file 		BoundedQueue.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Blocking queue with limited capacity, producer waits while
+ *              the queue is full (backpressure)
+ */
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  ///
+  /// Thread-safe FIFO holding at most capacity items. Closing the queue
+  /// wakes all waiting threads, consumers drain remaining items first.
+  ///
+  template <typename T>
+  class CBoundedQueue
+  {
+  public:
+    CBoundedQueue() = delete;
+    explicit CBoundedQueue(std::size_t capacity)
+      : m_capacity{capacity ? capacity : 1}
+      , m_closed{false}
+    {
+
+    }
+
+    /**
+     * @brief Appends item, waits while queue is full
+     * @param item Item to append
+     * @return false if queue was closed and item was dropped
+     */
+    bool push(T item)
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_notFull.wait(lock, [this] { return m_closed || m_items.size() < m_capacity; });
+      if (m_closed)
+      {
+        return false;
+      }
+      m_items.push_back(std::move(item));
+      m_notEmpty.notify_one();
+      return true;
+    }
+
+    /**
+     * @brief Takes first item, waits while queue is empty
+     * @param item Where item is stored
+     * @return false if queue is closed and empty
+     */
+    bool pop(T& item)
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_notEmpty.wait(lock, [this] { return m_closed || !m_items.empty(); });
+      if (m_items.empty())
+      {
+        return false;
+      }
+      item = std::move(m_items.front());
+      m_items.pop_front();
+      m_notFull.notify_one();
+      return true;
+    }
+
+    /**
+     * @brief Closes queue, no more items are accepted
+     */
+    void close()
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_closed = true;
+      m_notFull.notify_all();
+      m_notEmpty.notify_all();
+    }
+
+    /**
+     * @brief Opens closed queue again, items left in it are dropped
+     */
+    void reopen()
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_items.clear();
+      m_closed = false;
+    }
+
+  private:
+    std::mutex                m_mutex;
+    std::condition_variable   m_notFull;
+    std::condition_variable   m_notEmpty;
+    std::deque<T>             m_items;      /**< Queued items */
+    std::size_t               m_capacity;   /**< Max count of queued items */
+    bool                      m_closed;     /**< Queue doesnt accept items anymore */
+  };
+}
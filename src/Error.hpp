@@ -27,6 +27,12 @@ namespace BlockEditorLogic
     E_UI_BAD_FILE   = -6,
 
     E_INTERN        = -7,  /**< Inside error, cause by wrong call, shouldnt happen in UI, mainly for debug purposes */
+
+    E_UI_BAD_SIZE   = -8,  /**< Arrays on input ports of block differ in length */
+
+    E_CANCELLED     = -9,  /**< Computation was cancelled by user */
+
+    E_ARITHMETIC    = -13, /**< Overflow or division by zero in INT & HEX block */
   };
 
   /*
@@ -0,0 +1,65 @@
+/**
+ *		@file 		EvalContext.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    State of one evaluation, kept apart from the evaluated scheme
+ */
+
+#include "EvalContext.hpp"
+
+#include "SchemeSnapshot.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  /**
+   * @brief Context which wasnt used by any run yet
+   */
+  CEvalContext::CEvalContext()
+    : m_version{0}
+  {
+
+  }
+
+  /// @return Version of scheme the last run evaluated
+  uint64_t CEvalContext::getVersion() const
+  {
+    return m_version;
+  }
+
+  /// @return Results of the last run, in order blocks were computed
+  const std::deque<CBlockAction>& CEvalContext::getActions() const
+  {
+    return m_actions;
+  }
+
+  /**
+   * @brief Moves results of the last run out of context
+   * @return Results in order blocks were computed
+   */
+  std::deque<CBlockAction> CEvalContext::takeActions()
+  {
+    std::deque<CBlockAction> actions;
+    actions.swap(m_actions);
+    return actions;
+  }
+
+  /**
+   * @brief Prepares buffers for run, capacity of previous runs is kept
+   * @param slots Count of slots of evaluated snapshot
+   * @param version Version of scheme the snapshot was taken at
+   */
+  void CEvalContext::reset(size_t slots, uint64_t version)
+  {
+    m_version = version;
+    m_values.assign(slots, .0);
+    m_integers.assign(slots, 0);
+    m_arrays.assign(slots, nullptr);
+    m_consumer.assign(slots, NO_SLOT);
+    m_waiting.assign(slots, 0);
+    m_ready.clear();
+    m_actions.clear();
+  }
+}
@@ -0,0 +1,58 @@
+/**
+ *		@file 		EvalContext.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    State of one evaluation, kept apart from the evaluated scheme
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "ArrayOperation.hpp"
+#include "BlockAction.hpp"
+#include "MacroDefinition.hpp"
+#include "Port.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  ///
+  /// Values of ports, order of evaluation and results of one run. Runs
+  /// write only to their context, so any number of threads can evaluate
+  /// one scheme at once, each with its own context. Buffers are kept
+  /// between runs, context reused for the next run allocates nothing
+  /// besides the results.
+  ///
+  class CEvalContext
+  {
+  public:
+    CEvalContext();
+
+    uint64_t      getVersion() const;
+    const std::deque<CBlockAction>& getActions() const;
+    std::deque<CBlockAction> takeActions();
+
+  private:
+    friend class CSchemeSnapshot;
+
+    void          reset(size_t slots, uint64_t version);
+
+    uint64_t                  m_version;      /**< Version of scheme evaluated last */
+    std::vector<PortValue>    m_values;       /**< Value on output of block, by slot */
+    std::vector<PortInt>      m_integers;     /**< Exact value on output of INT & HEX block, by slot */
+    std::vector<PortArrayPtr> m_arrays;       /**< Values on output of block, if it is array */
+    std::vector<size_t>       m_consumer;     /**< Slot of block consuming output, by slot */
+    std::vector<uint32_t>     m_waiting;      /**< Inputs of block not computed yet */
+    std::vector<size_t>       m_ready;        /**< Blocks in order they got all inputs */
+    std::deque<CBlockAction>  m_actions;      /**< Results in order blocks were computed */
+    std::vector<PortValue>    m_operands;     /**< Inputs of reduction block being computed */
+    std::vector<PortInt>      m_intOperands;  /**< The same of INT & HEX block */
+    std::vector<ReduceOperand> m_arrayOperands; /**< The same if any of them is array */
+    MacroScratch              m_macro;        /**< Values inside macro block being computed */
+  };
+}
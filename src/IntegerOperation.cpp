@@ -0,0 +1,352 @@
+/**
+ *		@file 		IntegerOperation.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Operations of INT & HEX blocks, computed exactly in 64 bit integers
+ */
+
+#include <algorithm>
+#include <cstdint>
+
+#include "IntegerOperation.hpp"
+#include "BlockEditorException.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  ///
+  /// Kernels dont branch on overflow, each operation only ors its flag to
+  /// the flags of the loop, which are checked once the loop is done. Loops
+  /// of ADD, SUB, MIN and MAX stay free of branches, so the compiler can
+  /// vectorize them like the kernels of ArrayOperation.cpp.
+  ///
+  namespace
+  {
+    const int BAD_RANGE = 1;        /**< Result doesnt fit 64 bits */
+    const int BAD_ZERO  = 2;        /**< Division by zero */
+
+    /// 2^63, the smallest value above the range of PortInt
+    const PortValue INT_LIMIT = 9223372036854775808.0;
+
+    /// Truncates value to integer, out of range (or NaN) sets flag
+    inline PortInt load(PortValue v, int& bad)
+    {
+      bool ok = v >= -INT_LIMIT && v < INT_LIMIT;
+      bad |= ok ? 0 : BAD_RANGE;
+      return static_cast<PortInt>(ok ? v : .0);
+    }
+
+    inline PortInt intAdd(PortInt x, PortInt y, int& bad)
+    {
+      PortInt r = static_cast<PortInt>(static_cast<uint64_t>(x) + static_cast<uint64_t>(y));
+      bad |= ((x ^ r) & (y ^ r)) < 0 ? BAD_RANGE : 0;
+      return r;
+    }
+
+    inline PortInt intSub(PortInt x, PortInt y, int& bad)
+    {
+      PortInt r = static_cast<PortInt>(static_cast<uint64_t>(x) - static_cast<uint64_t>(y));
+      bad |= ((x ^ y) & (x ^ r)) < 0 ? BAD_RANGE : 0;
+      return r;
+    }
+
+    inline PortInt intMul(PortInt x, PortInt y, int& bad)
+    {
+      PortInt r;
+      bad |= __builtin_mul_overflow(x, y, &r) ? BAD_RANGE : 0;
+      return r;
+    }
+
+    inline PortInt intDiv(PortInt x, PortInt y, int& bad)
+    {
+      if (y == 0)
+      {
+        bad |= BAD_ZERO;
+        return 0;
+      }
+      if (y == -1)
+      {
+        return intSub(0, x, bad);
+      }
+      return x / y;
+    }
+
+    /// Exponentiation by squaring, negative exponent gives 1 / x^-y truncated
+    inline PortInt intPow(PortInt x, PortInt y, int& bad)
+    {
+      if (y < 0)
+      {
+        if (x == 0)
+        {
+          bad |= BAD_ZERO;
+          return 0;
+        }
+        return x == 1 ? 1 : x == -1 ? ((y & 1) ? -1 : 1) : 0;
+      }
+
+      PortInt r = 1;
+      while (y > 0)
+      {
+        if (y & 1)
+        {
+          r = intMul(r, x, bad);
+        }
+        y >>= 1;
+        // Square is used by the next bits, if it overflows the result does too
+        if (y > 0)
+        {
+          x = intMul(x, x, bad);
+        }
+      }
+      return r;
+    }
+
+    inline PortInt intMin(PortInt x, PortInt y, int&)
+    {
+      return y < x ? y : x;
+    }
+
+    inline PortInt intMax(PortInt x, PortInt y, int&)
+    {
+      return y > x ? y : x;
+    }
+
+    void check(int bad)
+    {
+      if (bad & BAD_ZERO)
+      {
+        throw CBlockEditorException("Division by zero in INT or HEX block", EErrorCode::E_ARITHMETIC);
+      }
+      if (bad & BAD_RANGE)
+      {
+        throw CBlockEditorException("Value of INT or HEX block doesnt fit 64 bits", EErrorCode::E_ARITHMETIC);
+      }
+    }
+
+    template <typename Op>
+    PortInt apply(PortInt x, PortInt y, Op op)
+    {
+      int bad = 0;
+      PortInt r = op(x, y, bad);
+      check(bad);
+      return r;
+    }
+
+    template <typename Op>
+    void applyKernel(const PortValue *a, PortInt sa, const PortValue *b,
+                     PortInt sb, PortValue *out, std::size_t n, Op op)
+    {
+      int bad = 0;
+      if (a && b)
+      {
+        for (std::size_t i = 0; i < n; i++)
+          out[i] = static_cast<PortValue>(op(load(a[i], bad), load(b[i], bad), bad));
+      }
+      else if (a)
+      {
+        for (std::size_t i = 0; i < n; i++)
+          out[i] = static_cast<PortValue>(op(load(a[i], bad), sb, bad));
+      }
+      else
+      {
+        for (std::size_t i = 0; i < n; i++)
+          out[i] = static_cast<PortValue>(op(sa, load(b[i], bad), bad));
+      }
+      check(bad);
+    }
+
+    template <typename Op>
+    PortInt fold(const PortInt *v, std::size_t n, Op op)
+    {
+      int bad = 0;
+      PortInt acc = v[0];
+      for (std::size_t i = 1; i < n; i++)
+        acc = op(acc, v[i], bad);
+      check(bad);
+      return acc;
+    }
+
+    /// Element-wise reduction, partial results are kept as integers so
+    /// they are exact even if the elements of the result are not
+    template <typename Op>
+    void reduceKernel(const std::vector<ReduceOperand>& ops, std::vector<PortInt>& acc, Op op)
+    {
+      int bad = 0;
+      std::size_t n = acc.size();
+      PortInt *out = acc.data();
+
+      if (ops[0].m_array)
+      {
+        const PortValue *p = ops[0].m_array->data();
+        for (std::size_t i = 0; i < n; i++)
+          out[i] = load(p[i], bad);
+      }
+      else
+      {
+        std::fill(acc.begin(), acc.end(), ops[0].m_integer);
+      }
+
+      for (std::size_t k = 1; k < ops.size(); k++)
+      {
+        if (ops[k].m_array)
+        {
+          const PortValue *p = ops[k].m_array->data();
+          for (std::size_t i = 0; i < n; i++)
+            out[i] = op(out[i], load(p[i], bad), bad);
+        }
+        else
+        {
+          PortInt v = ops[k].m_integer;
+          for (std::size_t i = 0; i < n; i++)
+            out[i] = op(out[i], v, bad);
+        }
+      }
+      check(bad);
+    }
+  }
+
+  /**
+   * @brief Converts value to integer, fraction is truncated
+   * @param pv Value, eg. of input block
+   * @return Integer value
+   */
+  PortInt toInteger(PortValue pv)
+  {
+    int bad = 0;
+    PortInt r = load(pv, bad);
+    check(bad);
+    return r;
+  }
+
+  /**
+   * @brief Performs operation due to type of block in integers
+   * @param bt Type of block
+   * @param pi1 Operand #1
+   * @param pi2 Operand #2
+   * @return Result of operation
+   */
+  PortInt performIntegerOperation(EBlockType bt, PortInt pi1, PortInt pi2)
+  {
+    switch (bt)
+    {
+      case BT_ADD:
+        return apply(pi1, pi2, intAdd);
+      case BT_SUB:
+        return apply(pi1, pi2, intSub);
+      case BT_MUL:
+        return apply(pi1, pi2, intMul);
+      case BT_DIV:
+        return apply(pi1, pi2, intDiv);
+      case BT_POW:
+        return apply(pi1, pi2, intPow);
+      default:
+        throw CBlockEditorException("Unknown type of block", EErrorCode::E_INTERN);
+    }
+  }
+
+  /**
+   * @brief Performs operation due to type of block in integers element-wise
+   * @param bt Type of block
+   * @param a1 Operand #1 array, nullptr if operand is scalar
+   * @param i1 Operand #1 scalar value
+   * @param a2 Operand #2 array, nullptr if operand is scalar
+   * @param i2 Operand #2 scalar value
+   * @return Array of results
+   */
+  PortArrayPtr performIntegerArrayOperation(EBlockType bt, const PortArrayPtr& a1, PortInt i1,
+                                            const PortArrayPtr& a2, PortInt i2)
+  {
+    std::size_t n = arrayLength(a1, a2);
+    const PortValue *p1 = a1 ? a1->data() : nullptr;
+    const PortValue *p2 = a2 ? a2->data() : nullptr;
+    auto result = std::make_shared<PortArray>(n);
+    PortValue *out = result->data();
+
+    switch (bt)
+    {
+      case BT_ADD:
+        applyKernel(p1, i1, p2, i2, out, n, intAdd);
+        break;
+      case BT_SUB:
+        applyKernel(p1, i1, p2, i2, out, n, intSub);
+        break;
+      case BT_MUL:
+        applyKernel(p1, i1, p2, i2, out, n, intMul);
+        break;
+      case BT_DIV:
+        applyKernel(p1, i1, p2, i2, out, n, intDiv);
+        break;
+      case BT_POW:
+        applyKernel(p1, i1, p2, i2, out, n, intPow);
+        break;
+      default:
+        throw CBlockEditorException("Unknown type of block", EErrorCode::E_INTERN);
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Reduces values of all inputs of reduction block in integers,
+   *        integer sum is exact, so mode of SUM makes no difference
+   * @param bt Type of block
+   * @param v Values of inputs in order of ports
+   * @param n Count of inputs
+   * @return Result of reduction
+   */
+  PortInt performIntegerReduction(EBlockType bt, const PortInt *v, std::size_t n)
+  {
+    if (n == 0)
+    {
+      throw CBlockEditorException("Reduction without inputs", EErrorCode::E_INTERN);
+    }
+
+    switch (bt)
+    {
+      case BT_SUM:
+        return fold(v, n, intAdd);
+      case BT_PRODUCT:
+        return fold(v, n, intMul);
+      case BT_MIN:
+        return fold(v, n, intMin);
+      case BT_MAX:
+        return fold(v, n, intMax);
+      default:
+        throw CBlockEditorException("Unknown type of block", EErrorCode::E_INTERN);
+    }
+  }
+
+  /**
+   * @brief Reduces inputs of reduction block in integers element-wise
+   * @param bt Type of block
+   * @param ops Inputs in order of ports, at least one of them is array,
+   *            scalars are taken from m_integer
+   * @return Array of results
+   */
+  PortArrayPtr performIntegerArrayReduction(EBlockType bt, const std::vector<ReduceOperand>& ops)
+  {
+    std::vector<PortInt> acc(arrayLength(ops));
+
+    switch (bt)
+    {
+      case BT_SUM:
+        reduceKernel(ops, acc, intAdd);
+        break;
+      case BT_PRODUCT:
+        reduceKernel(ops, acc, intMul);
+        break;
+      case BT_MIN:
+        reduceKernel(ops, acc, intMin);
+        break;
+      case BT_MAX:
+        reduceKernel(ops, acc, intMax);
+        break;
+      default:
+        throw CBlockEditorException("Unknown type of block", EErrorCode::E_INTERN);
+    }
+
+    return std::make_shared<PortArray>(acc.begin(), acc.end());
+  }
+}
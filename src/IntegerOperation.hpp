@@ -0,0 +1,32 @@
+/**
+ *		@file 		IntegerOperation.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Operations of INT & HEX blocks, computed exactly in 64 bit integers
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "ArrayOperation.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  ///
+  /// Operands are truncated to integers, DIV rounds toward zero and
+  /// results which dont fit 64 bits, as well as division by zero, throw
+  /// E_ARITHMETIC. Arrays keep PortValue elements, so their values are
+  /// exact up to 2^53, scalar results are exact in the whole range.
+  ///
+  PortInt       toInteger(PortValue);
+
+  PortInt       performIntegerOperation(EBlockType, PortInt, PortInt);
+  PortArrayPtr  performIntegerArrayOperation(EBlockType, const PortArrayPtr&, PortInt,
+                                             const PortArrayPtr&, PortInt);
+  PortInt       performIntegerReduction(EBlockType, const PortInt*, std::size_t);
+  PortArrayPtr  performIntegerArrayReduction(EBlockType, const std::vector<ReduceOperand>&);
+}
@@ -0,0 +1,459 @@
+/**
+ *		@file 		MacroDefinition.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Sub-scheme stored once and instanced by macro blocks, it is
+ *              compiled to steps which are run for every instance
+ */
+
+#include <unordered_map>
+#include <utility>
+
+#include "MacroDefinition.hpp"
+#include "BlockEditorException.hpp"
+#include "IntegerOperation.hpp"
+#include "SchemeMemory.hpp"
+#include "TypeName.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  namespace
+  {
+    /// Record without producer or step
+    const size_t NONE = static_cast<size_t>(-1);
+  }
+
+  /**
+   * @brief Makes definition and compiles it
+   * @param name Name of macro
+   * @param body Blocks of the body, all fields of records are set
+   */
+  CMacroDefinition::CMacroDefinition(std::string name, std::vector<SchemeRecord> body)
+    : m_name{std::move(name)}, m_body{std::move(body)}
+  {
+    checkName(m_name);
+    compile();
+  }
+
+  /**
+   * @brief Writes blocks of the body to scheme file, every one of them
+   *        with "Macro" line so they are not loaded as blocks of the scheme
+   * @param os Opened file desc
+   * @param def Definition to write into file
+   * @return ostream, to make proper overload
+   */
+  std::ostream& operator<<(std::ostream& os, const CMacroDefinition& def)
+  {
+    auto port = [](bool has, ID id) {
+      return has && id != NO_PORT ? std::to_string(id) : std::string("None");
+    };
+
+    for (auto& rec : def.m_body)
+    {
+      os << "Type:"        << rec.m_bt << std::endl;
+      os << "ID:"          << rec.m_blockID << std::endl;
+      os << "Position X:"  << rec.m_x << std::endl;
+      os << "Position Y:"  << rec.m_y << std::endl;
+      os << "Type name:"   << rec.m_tn << std::endl;
+      os << "Macro:"       << def.m_name << std::endl;
+      if (rec.m_param > 0)
+      {
+        os << "Macro input:" << rec.m_param << std::endl;
+      }
+      os << "Input value:" << ((rec.m_bt == BT_INPUT && rec.m_param == 0 && !rec.m_array) ?
+            std::to_string(rec.m_value) : "None") << std::endl;
+      if (rec.m_array)
+      {
+        os << "Input file:" << rec.m_file << std::endl;
+      }
+      os << "Input 1 ID:"  << port(rec.m_fields & RF_INPUT1, rec.m_input1) << std::endl;
+      os << "Input 2 ID:"  << port(rec.m_fields & RF_INPUT2, rec.m_input2) << std::endl;
+      for (auto& in : rec.m_more)
+      {
+        os << "Input " << in.first << " ID:" << port(true, in.second) << std::endl;
+      }
+      if (rec.m_mode != RM_PLAIN)
+      {
+        os << "Reduction:" << (rec.m_mode == RM_KAHAN ? "kahan" : "pairwise") << std::endl;
+      }
+      os << "Output ID:"   << port(rec.m_fields & RF_OUTPUT, rec.m_output) << std::endl;
+    }
+    return os;
+  }
+
+  /**
+   * @brief Get function
+   * @return Name of macro
+   */
+  const std::string& CMacroDefinition::getName() const
+  {
+    return m_name;
+  }
+
+  /**
+   * @brief Get function
+   * @return Type name of blocks of the body, instances have the same
+   */
+  TypeName CMacroDefinition::getTypeName() const
+  {
+    return m_tn;
+  }
+
+  /**
+   * @brief Checks if the body computes in integers
+   * @return True for INT and HEX macros
+   */
+  bool CMacroDefinition::isIntegral() const
+  {
+    return m_integral;
+  }
+
+  /**
+   * @brief Get function
+   * @return Count of inputs of macro
+   */
+  size_t CMacroDefinition::getInputCount() const
+  {
+    return m_inputs;
+  }
+
+  /**
+   * @brief Get function
+   * @return Count of blocks of the body, input blocks included
+   */
+  size_t CMacroDefinition::getBlockCount() const
+  {
+    return m_body.size();
+  }
+
+  /**
+   * @brief Memory of the body and of compiled steps
+   * @param c Counter of the report, arrays it counted already are skipped
+   * @return Bytes allocated by definition
+   */
+  uint64_t CMacroDefinition::getHeapBytes(CMemoryCounter& c) const
+  {
+    uint64_t bytes = CMemoryCounter::stringBytes(m_name) + CMemoryCounter::stringBytes(m_tn)
+                   + CMemoryCounter::vectorBytes(m_body) + CMemoryCounter::vectorBytes(m_steps);
+    for (auto& rec : m_body)
+    {
+      bytes += CMemoryCounter::stringBytes(rec.m_tn) + CMemoryCounter::stringBytes(rec.m_file)
+             + CMemoryCounter::stringBytes(rec.m_macro) + CMemoryCounter::vectorBytes(rec.m_more)
+             + c.arrayBytes(rec.m_array);
+    }
+    for (auto& step : m_steps)
+    {
+      bytes += CMemoryCounter::vectorBytes(step.m_inputs);
+    }
+    return bytes;
+  }
+
+  /**
+   * @brief Checks if name can be used for macro
+   * @param name Name of macro
+   */
+  void CMacroDefinition::checkName(const std::string& name)
+  {
+    if (name.empty() || name.find_first_of("\r\n") != std::string::npos)
+    {
+      throw CBlockEditorException("Name of macro has to be one line of text", EErrorCode::E_INTERN);
+    }
+  }
+
+  /**
+   * @brief Checks the body and orders its blocks for evaluation, operands
+   *        are resolved to inputs, constants or earlier steps
+   */
+  void CMacroDefinition::compile()
+  {
+    auto fail = [this](const std::string& what, EErrorCode ec) {
+      throw CBlockEditorException("Macro " + m_name + ": " + what, ec);
+    };
+
+    // Producers of ports and inputs of macro
+    std::unordered_map<ID, size_t> producer;
+    std::vector<size_t> params;
+    size_t blocks = 0;
+    for (size_t i = 0; i < m_body.size(); i++)
+    {
+      const SchemeRecord& rec = m_body[i];
+      if (rec.m_bt == BT_INPUT)
+      {
+        if (rec.m_param > 0)
+        {
+          if (rec.m_param > params.size())
+          {
+            params.resize(rec.m_param, NONE);
+          }
+          if (params[rec.m_param - 1] != NONE)
+          {
+            fail("input " + std::to_string(rec.m_param) + " is defined twice", EErrorCode::E_UI_BAD_FILE);
+          }
+          params[rec.m_param - 1] = i;
+        }
+      }
+      else
+      {
+        if (rec.m_bt == BT_MACRO)
+        {
+          fail("macro blocks inside macros are not supported", EErrorCode::E_UI_BAD_FILE);
+        }
+        if (rec.m_bt < BT_INPUT || rec.m_bt > BT_MAX)
+        {
+          fail("unknown type of block " + std::to_string(rec.m_bt), EErrorCode::E_UI_BAD_FILE);
+        }
+        if (blocks == 0)
+        {
+          m_tn = rec.m_tn;
+        }
+        else if (rec.m_tn != m_tn)
+        {
+          fail("blocks of the body have different types", EErrorCode::E_UI_BAD_TYPES);
+        }
+        blocks++;
+      }
+      if ((rec.m_fields & RF_OUTPUT) && !producer.emplace(rec.m_output, i).second)
+      {
+        fail("port " + std::to_string(rec.m_output) + " is output of two blocks", EErrorCode::E_UI_BAD_FILE);
+      }
+    }
+    if (blocks == 0)
+    {
+      fail("body has no blocks besides input blocks", EErrorCode::E_UI_BAD_FILE);
+    }
+    for (size_t k = 0; k < params.size(); k++)
+    {
+      if (params[k] == NONE)
+      {
+        fail("input " + std::to_string(k + 1) + " is missing", EErrorCode::E_UI_BAD_FILE);
+      }
+    }
+    m_inputs = params.size();
+    m_integral = m_tn == TN_INTEGER || m_tn == TN_HEXA;
+
+    // Producers of inputs of every block in order of ports
+    std::vector<std::vector<size_t>> inputs(m_body.size());
+    std::vector<bool> consumed(m_body.size(), false);
+    auto producerOf = [&producer](bool has, ID id) {
+      auto it = has && id != NO_PORT ? producer.find(id) : producer.end();
+      return it == producer.end() ? NONE : it->second;
+    };
+    for (size_t i = 0; i < m_body.size(); i++)
+    {
+      const SchemeRecord& rec = m_body[i];
+      if (rec.m_bt == BT_INPUT)
+      {
+        continue;
+      }
+      if (!rec.m_more.empty() && !isReduction(rec.m_bt))
+      {
+        fail("block " + std::to_string(rec.m_blockID) + " has more than two inputs,"
+             " but it isnt reduction", EErrorCode::E_UI_BAD_FILE);
+      }
+
+      std::vector<size_t>& in = inputs[i];
+      in.push_back(producerOf(rec.m_fields & RF_INPUT1, rec.m_input1));
+      in.push_back(producerOf(rec.m_fields & RF_INPUT2, rec.m_input2));
+      for (auto& more : rec.m_more)
+      {
+        if (more.first > in.size())
+        {
+          in.resize(more.first, NONE);
+        }
+        in[more.first - 1] = producerOf(true, more.second);
+      }
+      for (size_t n = 0; n < in.size(); n++)
+      {
+        if (in[n] == NONE)
+        {
+          fail("input " + std::to_string(n + 1) + " of block " + std::to_string(rec.m_blockID)
+               + " isnt connected", EErrorCode::E_UI_NOT_CON);
+        }
+        consumed[in[n]] = true;
+      }
+    }
+
+    // Output of macro is the only block whose output isnt connected
+    size_t output = NONE, outputs = 0;
+    for (size_t i = 0; i < m_body.size(); i++)
+    {
+      if (m_body[i].m_bt != BT_INPUT && !consumed[i])
+      {
+        output = i;
+        outputs++;
+      }
+    }
+    if (outputs == 0)
+    {
+      fail("there is a cycle in the body", EErrorCode::E_UI_CYCLE);
+    }
+    if (outputs > 1)
+    {
+      fail(std::to_string(outputs) + " blocks have unconnected output, macro has one output", EErrorCode::E_UI_NOT_CON);
+    }
+
+    // Steps in post-order from the output, so operands are computed first
+    std::vector<size_t> step(m_body.size(), NONE);
+    std::vector<bool> open(m_body.size(), false);
+    std::vector<std::pair<size_t, size_t>> stack{{output, 0}};
+    open[output] = true;
+    while (!stack.empty())
+    {
+      size_t i = stack.back().first;
+      if (stack.back().second < inputs[i].size())
+      {
+        size_t p = inputs[i][stack.back().second++];
+        if (m_body[p].m_bt == BT_INPUT || step[p] != NONE)
+        {
+          continue;
+        }
+        if (open[p])
+        {
+          fail("there is a cycle in the body", EErrorCode::E_UI_CYCLE);
+        }
+        open[p] = true;
+        stack.emplace_back(p, 0);
+        continue;
+      }
+
+      MacroStep s;
+      s.m_bt = m_body[i].m_bt;
+      s.m_mode = m_body[i].m_mode;
+      for (size_t p : inputs[i])
+      {
+        const SchemeRecord& rec = m_body[p];
+        MacroOperand o;
+        if (rec.m_bt != BT_INPUT)
+        {
+          o.m_source = MS_STEP;
+          o.m_index = step[p];
+        }
+        else if (rec.m_param > 0)
+        {
+          o.m_source = MS_PARAM;
+          o.m_index = rec.m_param - 1;
+        }
+        else
+        {
+          o.m_const.m_value = rec.m_value;
+          o.m_const.m_array = rec.m_array;
+          o.m_const.m_integer = m_integral && !rec.m_array ? toInteger(rec.m_value) : 0;
+        }
+        s.m_inputs.push_back(std::move(o));
+      }
+
+      step[i] = m_steps.size();
+      m_steps.push_back(std::move(s));
+      stack.pop_back();
+    }
+
+    // Blocks not reached from the output can only feed a cycle
+    if (m_steps.size() != blocks)
+    {
+      fail("there is a cycle in the body", EErrorCode::E_UI_CYCLE);
+    }
+  }
+
+  /**
+   * @brief Computes output of one instance the way snapshot computes
+   *        blocks, INT and HEX bodies in integers
+   * @param s Buffers of evaluation, m_params hold inputs of the instance
+   * @param result Where output of macro is stored
+   */
+  void CMacroDefinition::evaluate(MacroScratch& s, MacroValue& result) const
+  {
+    auto operand = [this, &s](const MacroOperand& o) -> const MacroValue& {
+      return o.m_source == MS_PARAM ? s.m_params[o.m_index]
+           : o.m_source == MS_STEP ? s.m_steps[o.m_index] : o.m_const;
+    };
+
+    s.m_steps.resize(m_steps.size());
+    bool arrays = false;
+    for (size_t k = 0; k < m_steps.size(); k++)
+    {
+      const MacroStep& step = m_steps[k];
+      MacroValue& out = s.m_steps[k];
+      bool array = false;
+      for (auto& o : step.m_inputs)
+      {
+        array = array || operand(o).m_array;
+      }
+
+      if (array)
+      {
+        if (isReduction(step.m_bt))
+        {
+          s.m_arrayOperands.clear();
+          for (auto& o : step.m_inputs)
+          {
+            const MacroValue& v = operand(o);
+            s.m_arrayOperands.push_back(ReduceOperand{v.m_array.get(), v.m_value, v.m_integer});
+          }
+          out.m_array = m_integral ? performIntegerArrayReduction(step.m_bt, s.m_arrayOperands)
+                                   : performArrayReduction(step.m_bt, s.m_arrayOperands, step.m_mode);
+        }
+        else
+        {
+          const MacroValue& a = operand(step.m_inputs[0]);
+          const MacroValue& b = operand(step.m_inputs[1]);
+          out.m_array = m_integral ? performIntegerArrayOperation(step.m_bt, a.m_array, a.m_integer, b.m_array, b.m_integer)
+                                   : performArrayOperation(step.m_bt, a.m_array, a.m_value, b.m_array, b.m_value);
+        }
+        out.m_value = .0;
+        out.m_integer = 0;
+        arrays = true;
+      }
+      else if (m_integral)
+      {
+        if (isReduction(step.m_bt))
+        {
+          s.m_intOperands.clear();
+          for (auto& o : step.m_inputs)
+          {
+            s.m_intOperands.push_back(operand(o).m_integer);
+          }
+          out.m_integer = performIntegerReduction(step.m_bt, s.m_intOperands.data(), s.m_intOperands.size());
+        }
+        else
+        {
+          out.m_integer = performIntegerOperation(step.m_bt, operand(step.m_inputs[0]).m_integer,
+                                                  operand(step.m_inputs[1]).m_integer);
+        }
+        out.m_value = static_cast<PortValue>(out.m_integer);
+        out.m_array.reset();
+      }
+      else
+      {
+        if (isReduction(step.m_bt))
+        {
+          s.m_operands.clear();
+          for (auto& o : step.m_inputs)
+          {
+            s.m_operands.push_back(operand(o).m_value);
+          }
+          out.m_value = performScalarReduction(step.m_bt, s.m_operands.data(), s.m_operands.size(), step.m_mode);
+        }
+        else
+        {
+          out.m_value = performScalarOperation(step.m_bt, operand(step.m_inputs[0]).m_value,
+                                                operand(step.m_inputs[1]).m_value);
+        }
+        out.m_array.reset();
+      }
+    }
+
+    result = s.m_steps.back();
+
+    // Arrays of steps are not kept until the next instance
+    if (arrays)
+    {
+      for (auto& it : s.m_steps)
+      {
+        it.m_array.reset();
+      }
+    }
+  }
+}
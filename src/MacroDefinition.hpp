@@ -0,0 +1,118 @@
+/**
+ *		@file 		MacroDefinition.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Sub-scheme stored once and instanced by macro blocks, it is
+ *              compiled to steps which are run for every instance
+ */
+
+#pragma once
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "ArrayOperation.hpp"
+#include "BlockType.hpp"
+#include "Port.hpp"
+#include "SchemeParser.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  class CMemoryCounter;
+
+  ///
+  /// Value on input of macro block or on output of step
+  ///
+  struct MacroValue
+  {
+    PortValue     m_value = .0;
+    PortInt       m_integer = 0;      /**< Exact value, if the body is INT or HEX */
+    PortArrayPtr  m_array;            /**< Values, if it is array */
+  };
+
+  ///
+  /// Where operand of step comes from
+  ///
+  enum EMacroSource
+  {
+    MS_PARAM = 0,     /**< Input of the macro block */
+    MS_CONST,         /**< Input block of the body */
+    MS_STEP,          /**< Output of earlier step */
+  };
+
+  struct MacroOperand
+  {
+    EMacroSource  m_source = MS_CONST;
+    size_t        m_index = 0;        /**< Input of macro block or step, from 0 */
+    MacroValue    m_const;            /**< Value of input block, MS_CONST only */
+  };
+
+  ///
+  /// Block of the body. Steps are in order of evaluation, the last one
+  /// is the output of macro.
+  ///
+  struct MacroStep
+  {
+    EBlockType    m_bt = BT_ADD;
+    EReduceMode   m_mode = RM_PLAIN;
+    std::vector<MacroOperand> m_inputs;
+  };
+
+  ///
+  /// Buffers of evaluation kept between instances, see CEvalContext.
+  /// Caller fills m_params with values on inputs of the instance.
+  ///
+  struct MacroScratch
+  {
+    std::vector<MacroValue>   m_params;
+    std::vector<MacroValue>   m_steps;
+    std::vector<PortValue>    m_operands;
+    std::vector<PortInt>      m_intOperands;
+    std::vector<ReduceOperand> m_arrayOperands;
+  };
+
+  ///
+  /// Definition of macro, blocks of the body are stored as records of the
+  /// scheme file with IDs local to the body. Input blocks of the body with
+  /// "Macro input" line are the inputs of macro, other input blocks hold
+  /// constants. The only block whose output isnt connected is the output
+  /// of macro. Definition is compiled once, when it is made, and never
+  /// changed afterwards, so instances and snapshots share it.
+  ///
+  class CMacroDefinition
+  {
+  public:
+    CMacroDefinition(std::string name, std::vector<SchemeRecord> body);
+
+    friend
+    std::ostream& operator<<(std::ostream&, const CMacroDefinition&);
+
+    const std::string& getName() const;
+    TypeName      getTypeName() const;
+    bool          isIntegral() const;
+    size_t        getInputCount() const;
+    size_t        getBlockCount() const;
+    uint64_t      getHeapBytes(CMemoryCounter&) const;
+
+    void          evaluate(MacroScratch&, MacroValue& result) const;
+
+    static void   checkName(const std::string&);
+
+  private:
+    void          compile();
+
+    std::string               m_name;
+    TypeName                  m_tn;             /**< Type name of all blocks of the body */
+    bool                      m_integral = false; /**< Body is INT or HEX */
+    size_t                    m_inputs = 0;
+    std::vector<SchemeRecord> m_body;           /**< Blocks of the body as they are saved */
+    std::vector<MacroStep>    m_steps;          /**< Blocks of the body in order of evaluation */
+  };
+
+  using MacroPtr = std::shared_ptr<const CMacroDefinition>;
+}
@@ -7,6 +7,7 @@
  */
 
 #include "Port.hpp"
+#include "SchemeMemory.hpp"
 
 ///
 /// Namespace with implementation of logic of an application
@@ -17,8 +18,7 @@ namespace BlockEditorLogic
    * @brief Constructor of the port
    * @param portID idetificator of new port
    */
-  CPort::CPort(ID portID) : m_portID{portID}, m_value{0},
-      m_bValue{false}
+  CPort::CPort(ID portID) : m_portID{portID}
   {
 
   }
@@ -32,15 +32,6 @@ namespace BlockEditorLogic
     return this->m_name;
   }
 
-  /**
-   * @brief Get function
-   * @return Value of port
-   */
-  PortValue CPort::getPortValue() const
-  {
-    return this->m_value;
-  }
-
   /**
    * @brief Get function
    * @return ID of port
@@ -50,14 +41,6 @@ namespace BlockEditorLogic
     return this->m_portID;
   }
 
-  /**
-   * @brief Unsets value of port, used after run of scheme
-   */
-  void CPort::unsetValue()
-  {
-    this->m_bValue = false;
-  }
-
   /**
    * @brief Set function
    * @param New name of type of port
@@ -68,21 +51,11 @@ namespace BlockEditorLogic
   }
 
   /**
-   * @brief Set function
-   * @param New value of port
-   */
-  void CPort::setPortValue(PortValue pv)
-  {
-    this->m_bValue = true;
-    this->m_value = pv;
-  }
-
-  /**
-   * @brief Checks if port already has value
-   * @return true if has value
+   * @brief Memory of name owned by port, array is not included
+   * @return Bytes allocated by string of port
    */
-  bool CPort::hasValue() const
+  uint64_t CPort::getHeapBytes() const
   {
-    return this->m_bValue;
+    return CMemoryCounter::stringBytes(m_name);
   }
 }
\ No newline at end of file
@@ -8,7 +8,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 #include "TypeName.hpp"
 
@@ -24,16 +27,44 @@ namespace BlockEditorLogic
   {
     P_INPUT1 = 1,
     P_INPUT2 = 2,
-    P_OUTPUT = 3
+    P_OUTPUT = 3,
+    P_INPUT3 = 4      /**< Inputs of reduction blocks past the second follow it */
   };
 
   /// Alliases
-  using PortValue = double;
-  using TypeName  = std::string;
-  using ID        = unsigned int;
+  using PortValue    = double;
+  using PortInt      = int64_t;     /**< Exact value of INT & HEX blocks */
+  using PortArray    = std::vector<PortValue>;
+  using PortArrayPtr = std::shared_ptr<const PortArray>;
+  using TypeName     = std::string;
+  using ID           = unsigned int;
+
+  /// Inputs a reduction block may have at most
+  const size_t MAX_INPUTS = 1 << 20;
+
+  /**
+   * @brief Input port by its number
+   * @param n Number of input, from 1
+   */
+  inline Ports inputPort(size_t n)
+  {
+    return static_cast<Ports>(n <= 2 ? n : n + 1);
+  }
+
+  /**
+   * @brief Number of input port, inverse of inputPort
+   * @return Number from 1, 0 for the output port
+   */
+  inline size_t inputNumber(Ports whichPort)
+  {
+    size_t n = static_cast<size_t>(whichPort);
+    return whichPort == Ports::P_OUTPUT ? 0 : n <= 2 ? n : n - 1;
+  }
 
   ///
-  /// Each port has type, which consists of the name and value of type double
+  /// Port connects output of one block to input of other, it has the name of
+  /// type of values passed. Values are never stored in the port, evaluation
+  /// keeps them in its CEvalContext, so the scheme is only read by runs.
   ///
   class CPort
   {
@@ -44,19 +75,14 @@ namespace BlockEditorLogic
 
     ID          getPortID() const;
     TypeName    getPortName() const;
-    PortValue   getPortValue() const;
-    bool        hasValue() const;
+    uint64_t    getHeapBytes() const;
 
-    void        unsetValue();
     void        setPortName(std::string);
-    void        setPortValue(PortValue);
 
   protected:
 
   private:
     ID                m_portID;      /**< Unique ID of port */
     TypeName          m_name;        /**< Name of port */
-    PortValue         m_value;       /**< Port value */
-    bool              m_bValue;      /**< Does port have value ? */
   };
 }
\ No newline at end of file
@@ -0,0 +1,136 @@
+/**
+ *		@file 		SchemeBatch.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Batch of edits applied to scheme at once, all or nothing
+ */
+
+#include "SchemeBatch.hpp"
+
+#include "ArrayFile.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  /**
+   * @brief Empty batch, see CBlockScheme::batch
+   * @param firstID ID the first block of batch gets
+   */
+  CSchemeBatch::CSchemeBatch(ID firstID)
+    : m_firstID{firstID}, m_nextID{firstID}
+  {
+
+  }
+
+  /**
+   * @brief Adds new block
+   * @param type Type of new block
+   * @return ID the block gets
+   */
+  ID CSchemeBatch::addBlock(EBlockType type, TypeName tn)
+  {
+    BatchRecord r;
+    r.m_op = BO_ADD_BLOCK;
+    r.m_blockID = m_nextID++;
+    r.m_type = type;
+    r.m_tn = tn;
+    m_records.push_back(std::move(r));
+
+    return m_records.back().m_blockID;
+  }
+
+  /**
+   * @brief Adds instance of macro defined in the scheme
+   * @param name Name of macro
+   * @return ID the block gets
+   */
+  ID CSchemeBatch::addMacroBlock(const std::string& name)
+  {
+    BatchRecord r;
+    r.m_op = BO_ADD_MACRO;
+    r.m_blockID = m_nextID++;
+    r.m_type = BT_MACRO;
+    r.m_macro = name;
+    m_records.push_back(std::move(r));
+
+    return m_records.back().m_blockID;
+  }
+
+  /**
+   * @brief Connects output of one block to input port of other
+   * @param blockID_out Block with output port
+   * @param blockID_in Block with input port
+   * @param whichPort Which input port
+   */
+  void CSchemeBatch::addPort(ID blockID_out, ID blockID_in, Ports whichPort)
+  {
+    BatchRecord r;
+    r.m_op = BO_ADD_PORT;
+    r.m_blockID = blockID_out;
+    r.m_otherID = blockID_in;
+    r.m_port = whichPort;
+    m_records.push_back(std::move(r));
+  }
+
+  /**
+   * @brief Assigns value to input port, input block holding it takes ID
+   * @param blockID Block with the port
+   * @param value The value to assign
+   * @param whichPort Which input port
+   */
+  void CSchemeBatch::addInputValue(ID blockID, PortValue value, Ports whichPort)
+  {
+    BatchRecord r;
+    r.m_op = BO_INPUT_VALUE;
+    r.m_blockID = blockID;
+    r.m_otherID = m_nextID++;
+    r.m_port = whichPort;
+    r.m_value = value;
+    m_records.push_back(std::move(r));
+  }
+
+  /**
+   * @brief Assigns values loaded from file to input port. File is loaded
+   *        right away, bad file is reported before batch is applied.
+   * @param blockID Block with the port
+   * @param fileName Binary or CSV file with values
+   * @param whichPort Which input port
+   */
+  void CSchemeBatch::addInputArray(ID blockID, const std::string& fileName, Ports whichPort)
+  {
+    BatchRecord r;
+    r.m_op = BO_INPUT_ARRAY;
+    r.m_array = loadArrayFile(fileName);
+    r.m_blockID = blockID;
+    r.m_otherID = m_nextID++;
+    r.m_port = whichPort;
+    r.m_file = fileName;
+    m_records.push_back(std::move(r));
+  }
+
+  /// @return ID of the first block of batch
+  ID CSchemeBatch::getFirstID() const
+  {
+    return m_firstID;
+  }
+
+  /// @return ID after the last block of batch
+  ID CSchemeBatch::getNextID() const
+  {
+    return m_nextID;
+  }
+
+  /// @return Count of blocks added by batch, input blocks included
+  size_t CSchemeBatch::getBlockCount() const
+  {
+    return m_nextID - m_firstID;
+  }
+
+  /// @return Edits in order they were made
+  const std::vector<BatchRecord>& CSchemeBatch::getRecords() const
+  {
+    return m_records;
+  }
+}
@@ -0,0 +1,78 @@
+/**
+ *		@file 		SchemeBatch.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Batch of edits applied to scheme at once, all or nothing
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "BlockType.hpp"
+#include "Port.hpp"
+#include "TypeName.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  ///
+  /// Edit recorded by batch
+  ///
+  enum EBatchOp
+  {
+    BO_ADD_BLOCK,       /**< Block m_blockID of m_type/m_tn is added */
+    BO_ADD_PORT,        /**< Output of m_blockID is connected to m_port of m_otherID */
+    BO_INPUT_VALUE,     /**< m_value is assigned to m_port of m_blockID by input block m_otherID */
+    BO_INPUT_ARRAY,     /**< m_array loaded from m_file is assigned, same as BO_INPUT_VALUE */
+    BO_ADD_MACRO,       /**< Block m_blockID instancing macro m_macro is added */
+  };
+
+  ///
+  /// One edit of batch, fields not used by the operation are empty
+  ///
+  struct BatchRecord
+  {
+    EBatchOp      m_op = BO_ADD_BLOCK;
+    ID            m_blockID = 0;
+    ID            m_otherID = 0;
+    EBlockType    m_type = BT_INPUT;
+    TypeName      m_tn;
+    Ports         m_port = Ports::P_INPUT1;
+    PortValue     m_value = .0;
+    PortArrayPtr  m_array;
+    std::string   m_file;
+    std::string   m_macro;
+  };
+
+  ///
+  /// Edits collected without touching the scheme, applied by
+  /// CBlockScheme::applyBatch. Blocks get the IDs the same calls of
+  /// CBlockScheme would give them, so they can be connected right away.
+  /// Nothing is validated before the batch is applied.
+  ///
+  class CSchemeBatch
+  {
+  public:
+    explicit CSchemeBatch(ID firstID);
+
+    ID            addBlock(EBlockType, TypeName);
+    ID            addMacroBlock(const std::string&);
+    void          addPort(ID, ID, Ports);
+    void          addInputValue(ID, PortValue, Ports);
+    void          addInputArray(ID, const std::string&, Ports);
+
+    ID            getFirstID() const;
+    ID            getNextID() const;
+    size_t        getBlockCount() const;
+    const std::vector<BatchRecord>& getRecords() const;
+
+  private:
+    ID                        m_firstID;      /**< ID of the first block of batch */
+    ID                        m_nextID;       /**< ID of the next block of batch */
+    std::vector<BatchRecord>  m_records;      /**< Edits in order they were made */
+  };
+}
@@ -0,0 +1,140 @@
+/**
+ *		@file 		SchemeBench.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Generated schemes of given shape and size, for benchmarks
+ */
+
+#include "SchemeBench.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "BlockEditorException.hpp"
+#include "BlockScheme.hpp"
+#include "Error.hpp"
+#include "SchemeBatch.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  /**
+   * @brief Shape by its name
+   * @param name chain, tree, wide or macro
+   * @return The shape
+   */
+  EBenchShape parseBenchShape(const std::string& name)
+  {
+    if (name == "chain")
+    {
+      return BS_CHAIN;
+    }
+    if (name == "tree")
+    {
+      return BS_TREE;
+    }
+    if (name == "wide")
+    {
+      return BS_WIDE;
+    }
+    if (name == "macro")
+    {
+      return BS_MACRO;
+    }
+    throw CBlockEditorException("Unknown scheme shape " + name + ", use chain, tree, wide or macro", EErrorCode::E_INTERN);
+  }
+
+  /**
+   * @brief Adds generated blocks to scheme in one batch. Operations
+   *        alternate between add, sub and mul, input values keep results of
+   *        a chain of any length finite.
+   * @param scheme Scheme the blocks are added to
+   * @param shape Shape of connections between the blocks
+   * @param blocks Count of blocks, input blocks not included, for BS_MACRO
+   *        count of blocks of all instances
+   */
+  void generateBenchScheme(CBlockScheme& scheme, EBenchShape shape, size_t blocks)
+  {
+    const EBlockType types[] = {BT_ADD, BT_SUB, BT_MUL};
+
+    if (shape == BS_MACRO)
+    {
+      // Body is generated as chain with free first input, defined and removed
+      size_t body = std::min(blocks, MACRO_BODY);
+      CSchemeBatch chain = scheme.batch();
+      std::vector<ID> ids(body);
+      for (size_t i = 0; i < body; i++)
+      {
+        ids[i] = chain.addBlock(types[i % 3], TN_FLOAT);
+        if (i > 0)
+        {
+          chain.addPort(ids[i - 1], ids[i], Ports::P_INPUT1);
+        }
+        chain.addInputValue(ids[i], types[i % 3] == BT_MUL ? 1.0 : 0.5, Ports::P_INPUT2);
+      }
+      scheme.applyBatch(chain);
+      scheme.defineMacro("chain", ids);
+      scheme.removeBlocks(ids);
+
+      CSchemeBatch b = scheme.batch();
+      ID last = 0;
+      for (size_t i = 0; i < (blocks + body - 1) / body; i++)
+      {
+        ID id = b.addMacroBlock("chain");
+        if (i > 0)
+        {
+          b.addPort(last, id, Ports::P_INPUT1);
+        }
+        else
+        {
+          b.addInputValue(id, 0.5, Ports::P_INPUT1);
+        }
+        last = id;
+      }
+      scheme.applyBatch(b);
+      return;
+    }
+    CSchemeBatch b = scheme.batch();
+    std::vector<ID> ids(blocks);
+
+    for (size_t i = 0; i < blocks; i++)
+    {
+      ids[i] = b.addBlock(types[i % 3], TN_FLOAT);
+    }
+
+    for (size_t i = 0; i < blocks; i++)
+    {
+      // Chain adds and subtracts 0.5 and multiplies by 1
+      PortValue value = types[i % 3] == BT_MUL ? 1.0 : 0.5;
+      size_t fed[2] = {blocks, blocks};
+
+      if (shape == BS_CHAIN && i > 0)
+      {
+        fed[0] = i - 1;
+      }
+      else if (shape == BS_TREE)
+      {
+        // Heap order, children of block i are 2i + 1 and 2i + 2
+        fed[0] = 2 * i + 1;
+        fed[1] = 2 * i + 2;
+      }
+
+      Ports ports[2] = {Ports::P_INPUT1, Ports::P_INPUT2};
+      for (int p = 0; p < 2; p++)
+      {
+        if (fed[p] < blocks)
+        {
+          b.addPort(ids[fed[p]], ids[i], ports[p]);
+        }
+        else
+        {
+          b.addInputValue(ids[i], value, ports[p]);
+        }
+      }
+    }
+
+    scheme.applyBatch(b);
+  }
+}
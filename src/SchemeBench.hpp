@@ -0,0 +1,37 @@
+/**
+ *		@file 		SchemeBench.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Generated schemes of given shape and size, for benchmarks
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  /// Forward declaration
+  class CBlockScheme;
+
+  ///
+  /// Shape of generated scheme
+  ///
+  enum EBenchShape
+  {
+    BS_CHAIN = 0,       /**< Every block consumes result of the previous one */
+    BS_TREE,            /**< Binary tree, every block consumes results of two others */
+    BS_WIDE,            /**< Unconnected blocks with input values only */
+    BS_MACRO,           /**< Chain of instances of one macro, its body is chain of MACRO_BODY blocks */
+  };
+
+  /// Blocks of body of macro in BS_MACRO scheme
+  const size_t MACRO_BODY = 50;
+
+  EBenchShape   parseBenchShape(const std::string&);
+  void          generateBenchScheme(CBlockScheme&, EBenchShape, size_t blocks);
+}
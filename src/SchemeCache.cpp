@@ -0,0 +1,166 @@
+/**
+ *		@file 		SchemeCache.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Loaded schemes kept for repeated evaluation, least recently
+ *              used are dropped
+ */
+
+#include "SchemeCache.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/stat.h>
+
+#include "BlockEditorException.hpp"
+#include "Error.hpp"
+#include "SchemeJournal.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  /**
+   * @brief Empty cache
+   * @param capacity Max count of schemes kept
+   */
+  CSchemeCache::CSchemeCache(size_t capacity)
+    : m_capacity{capacity ? capacity : 1}
+  {
+
+  }
+
+  /**
+   * @brief Version of scheme on disk, changes with file or its journal
+   * @param file Scheme file
+   * @return Times of modification and sizes of both files
+   */
+  std::string CSchemeCache::fileVersion(const std::string& file)
+  {
+    struct stat st;
+    if (stat(file.c_str(), &st) != 0)
+    {
+      throw CBlockEditorException("Cannot open file " + file + " -- " + std::strerror(errno), EErrorCode::E_UI_BAD_FILE);
+    }
+    std::string version = std::to_string(st.st_mtim.tv_sec) + "." + std::to_string(st.st_mtim.tv_nsec)
+                        + ":" + std::to_string(st.st_size);
+
+    // Journal holds edits saved after the file
+    if (stat(CSchemeJournal::journalName(file).c_str(), &st) == 0)
+    {
+      version += "/" + std::to_string(st.st_mtim.tv_sec) + "." + std::to_string(st.st_mtim.tv_nsec)
+               + ":" + std::to_string(st.st_size);
+    }
+    return version;
+  }
+
+  /**
+   * @brief Loads scheme and publishes its snapshot
+   * @param file Scheme file
+   * @param version Version of file before it was read
+   * @return The scheme
+   */
+  CachedSchemePtr CSchemeCache::load(const std::string& file, const std::string& version)
+  {
+    std::shared_ptr<CBlockScheme> scheme = std::make_shared<CBlockScheme>();
+    std::string name = file;
+    scheme->openScheme(name);
+
+    std::shared_ptr<CachedScheme> cached = std::make_shared<CachedScheme>();
+    cached->m_file = file;
+    cached->m_version = version;
+    cached->m_snapshot = scheme->snapshot();
+    cached->m_outputs = scheme->getOutputBlocks();
+    cached->m_scheme = std::move(scheme);
+    return cached;
+  }
+
+  /**
+   * @brief Scheme loaded from file, loads it if it isnt cached or it
+   *        changed on disk since. Least recently used scheme is dropped
+   *        when the cache is full, evaluations holding it keep it alive.
+   * @param file Scheme file
+   * @return The scheme
+   */
+  CachedSchemePtr CSchemeCache::get(const std::string& file)
+  {
+    std::string version = fileVersion(file);
+    std::promise<CachedSchemePtr> loaded;
+    std::shared_future<CachedSchemePtr> scheme;
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto it = m_entries.find(file);
+      if (it != m_entries.end() && it->second.m_version == version)
+      {
+        m_lru.splice(m_lru.begin(), m_lru, it->second.m_lru);
+        scheme = it->second.m_scheme;
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+      }
+      else
+      {
+        // This thread loads it, others wait for the future
+        if (it == m_entries.end())
+        {
+          m_lru.push_front(file);
+          it = m_entries.emplace(file, Entry()).first;
+          it->second.m_lru = m_lru.begin();
+        }
+        else
+        {
+          m_lru.splice(m_lru.begin(), m_lru, it->second.m_lru);
+        }
+        it->second.m_version = version;
+        it->second.m_scheme = loaded.get_future().share();
+
+        while (m_entries.size() > m_capacity)
+        {
+          m_entries.erase(m_lru.back());
+          m_lru.pop_back();
+          m_evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    }
+
+    if (scheme.valid())
+    {
+      return scheme.get();
+    }
+
+    m_loads.fetch_add(1, std::memory_order_relaxed);
+    try
+    {
+      CachedSchemePtr cached = load(file, version);
+      loaded.set_value(cached);
+      return cached;
+    }
+    catch (...)
+    {
+      // Failed load isnt cached, next request tries again
+      loaded.set_exception(std::current_exception());
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto it = m_entries.find(file);
+      if (it != m_entries.end() && it->second.m_version == version)
+      {
+        m_lru.erase(it->second.m_lru);
+        m_entries.erase(it);
+      }
+      throw;
+    }
+  }
+
+  /// @return Counters of cache
+  SchemeCacheStats CSchemeCache::getStats() const
+  {
+    SchemeCacheStats s;
+    s.m_hits = m_hits.load(std::memory_order_relaxed);
+    s.m_loads = m_loads.load(std::memory_order_relaxed);
+    s.m_evictions = m_evictions.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    s.m_size = m_entries.size();
+    return s;
+  }
+}
@@ -0,0 +1,87 @@
+/**
+ *		@file 		SchemeCache.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Loaded schemes kept for repeated evaluation, least recently
+ *              used are dropped
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BlockScheme.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  ///
+  /// Scheme loaded from file, with its snapshot published. The scheme is
+  /// never changed, so it is evaluated by any number of threads at once.
+  ///
+  struct CachedScheme
+  {
+    std::string   m_file;
+    std::string   m_version;          /**< Times and sizes of scheme file and journal when loaded */
+    std::shared_ptr<const CBlockScheme> m_scheme;
+    SnapshotPtr   m_snapshot;
+    std::vector<ID> m_outputs;        /**< Blocks with unconnected output */
+  };
+
+  using CachedSchemePtr = std::shared_ptr<const CachedScheme>;
+
+  ///
+  /// Counters of cache
+  ///
+  struct SchemeCacheStats
+  {
+    uint64_t      m_hits = 0;
+    uint64_t      m_loads = 0;        /**< Schemes loaded, missing or changed on disk */
+    uint64_t      m_evictions = 0;
+    uint64_t      m_size = 0;         /**< Schemes in cache */
+  };
+
+  ///
+  /// Cache of loaded schemes keyed by path. Scheme is loaded again once its
+  /// file or journal changes on disk (time of modification or size). Only
+  /// one thread loads a scheme, others asking for it meanwhile wait for
+  /// that load. Loading is done outside of the lock of the cache.
+  ///
+  class CSchemeCache
+  {
+  public:
+    explicit CSchemeCache(size_t capacity);
+
+    CachedSchemePtr get(const std::string& file);
+    SchemeCacheStats getStats() const;
+
+  private:
+    struct Entry
+    {
+      std::string               m_version;
+      std::shared_future<CachedSchemePtr> m_scheme;
+      std::list<std::string>::iterator m_lru;
+    };
+
+    static std::string  fileVersion(const std::string& file);
+    static CachedSchemePtr load(const std::string& file, const std::string& version);
+
+    mutable std::mutex        m_mutex;
+    size_t                    m_capacity;     /**< Max count of schemes */
+    std::list<std::string>    m_lru;          /**< Paths, most recently used first */
+    std::unordered_map<std::string, Entry> m_entries;
+    std::atomic<uint64_t>     m_hits{0};
+    std::atomic<uint64_t>     m_loads{0};
+    std::atomic<uint64_t>     m_evictions{0};
+  };
+}
@@ -0,0 +1,285 @@
+/**
+ *		@file 		SchemeEvaluation.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Resumable evaluation of scheme snapshot, one block per step
+ */
+
+#include "SchemeEvaluation.hpp"
+
+#include "ArrayOperation.hpp"
+#include "BlockEditorException.hpp"
+#include "Error.hpp"
+#include "IntegerOperation.hpp"
+#include "SchemeTrace.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  /// Steps between checks of cancel flag and progress reports
+  const size_t STEP_STRIDE = 1024;
+
+  /**
+   * @brief Evaluation of snapshot, nothing is computed yet
+   * @param snapshot Snapshot to evaluate
+   */
+  CSchemeEvaluation::CSchemeEvaluation(SnapshotPtr snapshot)
+    : m_snapshot{std::move(snapshot)}, m_cursor{0}, m_finished{false}
+  {
+
+  }
+
+  /**
+   * @brief Blocks computed by unfinished evaluation are counted too
+   */
+  CSchemeEvaluation::~CSchemeEvaluation()
+  {
+    m_meter.flush(m_snapshot->getStats(), false);
+  }
+
+  /// @return Version of scheme the evaluated snapshot was taken at
+  uint64_t CSchemeEvaluation::getVersion() const
+  {
+    return m_snapshot->getVersion();
+  }
+
+  /**
+   * @brief Moves cursor to the next block which wasnt computed
+   * @return True if all blocks were computed
+   */
+  bool CSchemeEvaluation::finished()
+  {
+    if (!m_stack.empty())
+    {
+      return false;
+    }
+
+    size_t n = m_snapshot->getSlotCount();
+    while (m_cursor < n)
+    {
+      const SnapshotNode& node = m_snapshot->getNode(m_cursor);
+      if (node.m_used && node.m_bt != BT_INPUT && m_doneAhead.erase(m_cursor) == 0)
+      {
+        return false;
+      }
+      m_cursor++;
+    }
+
+    if (!m_finished)
+    {
+      m_finished = true;
+      m_meter.flush(m_snapshot->getStats(), true);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Computes next block
+   * @return Result of the block
+   */
+  CBlockAction CSchemeEvaluation::next()
+  {
+    if (m_stack.empty())
+    {
+      if (finished())
+      {
+        throw CBlockEditorException("All blocks were computed already", EErrorCode::E_INTERN);
+      }
+      m_stack.push_back(m_cursor);
+      m_onStack.insert(m_cursor);
+      m_cursor++;
+    }
+
+    while (true)
+    {
+      size_t slot = m_stack.back();
+      const SnapshotNode& node = m_snapshot->getNode(slot);
+
+      size_t count = node.getInputCount();
+      for (size_t k = 0; k < count; k++)
+      {
+        if (node.getInput(k) == NO_SLOT)
+        {
+          throw CBlockEditorException(
+            "Input value missing for some blocks. Make sure all input ports are either connected or have a value assigned.",
+             EErrorCode::E_UI_NOT_CON);
+        }
+      }
+
+      // Compute inputs first
+      bool waiting = false;
+      for (size_t k = 0; k < count; k++)
+      {
+        size_t in = node.getInput(k);
+        if (m_snapshot->getNode(in).m_bt == BT_INPUT || m_results.count(in))
+        {
+          continue;
+        }
+        if (m_onStack.count(in))
+        {
+          throw CBlockEditorException("Detected cycle in the scheme", EErrorCode::E_UI_CYCLE);
+        }
+        m_stack.push_back(in);
+        m_onStack.insert(in);
+        waiting = true;
+        break;
+      }
+      if (waiting)
+      {
+        continue;
+      }
+
+      // Take operands, results of inputs are consumed
+      std::vector<Result> op(count);
+      bool array = false;
+      for (size_t k = 0; k < count; k++)
+      {
+        const SnapshotNode& in = m_snapshot->getNode(node.getInput(k));
+        if (in.m_bt == BT_INPUT)
+        {
+          op[k] = Result{in.m_value, in.m_array, 0};
+        }
+        else
+        {
+          auto it = m_results.find(node.getInput(k));
+          op[k] = std::move(it->second);
+          m_results.erase(it);
+        }
+        // INT & HEX blocks compute in integers, other producers (input blocks) have value only
+        if (node.m_integral && !in.m_integral && !op[k].m_array)
+        {
+          op[k].m_integer = toInteger(op[k].m_value);
+        }
+        array = array || op[k].m_array;
+      }
+
+      m_stack.pop_back();
+      m_onStack.erase(slot);
+      if (slot >= m_cursor)
+      {
+        m_doneAhead.insert(slot);
+      }
+
+      bool timed = m_meter.timed(array);
+      auto start = timed ? COpMeter::Clock::now() : COpMeter::Clock::time_point();
+
+      // Vector-valued ports, operation is performed element-wise
+      Result res{.0, nullptr, 0};
+      if (node.m_bt == BT_MACRO)
+      {
+        m_macro.m_params.resize(count);
+        for (size_t k = 0; k < count; k++)
+        {
+          m_macro.m_params[k] = MacroValue{op[k].m_value, op[k].m_integer, std::move(op[k].m_array)};
+        }
+        MacroValue result;
+        node.m_macro->evaluate(m_macro, result);
+        m_macro.m_params.clear();
+        res = Result{result.m_value, std::move(result.m_array), result.m_integer};
+      }
+      else if (array && isReduction(node.m_bt))
+      {
+        std::vector<ReduceOperand> operands;
+        for (auto& it : op)
+        {
+          operands.push_back(ReduceOperand{it.m_array.get(), it.m_value, it.m_integer});
+        }
+        res.m_array = node.m_integral ? performIntegerArrayReduction(node.m_bt, operands)
+                                      : performArrayReduction(node.m_bt, operands, node.m_mode);
+      }
+      else if (array && node.m_integral)
+      {
+        res.m_array = performIntegerArrayOperation(node.m_bt, op[0].m_array, op[0].m_integer,
+                                                   op[1].m_array, op[1].m_integer);
+      }
+      else if (array)
+      {
+        res.m_array = performArrayOperation(node.m_bt, op[0].m_array, op[0].m_value,
+                                            op[1].m_array, op[1].m_value);
+      }
+      else if (node.m_integral)
+      {
+        if (isReduction(node.m_bt))
+        {
+          std::vector<PortInt> operands;
+          for (auto& it : op)
+          {
+            operands.push_back(it.m_integer);
+          }
+          res.m_integer = performIntegerReduction(node.m_bt, operands.data(), operands.size());
+        }
+        else
+        {
+          res.m_integer = performIntegerOperation(node.m_bt, op[0].m_integer, op[1].m_integer);
+        }
+        res.m_value = static_cast<PortValue>(res.m_integer);
+      }
+      else
+      {
+        if (isReduction(node.m_bt))
+        {
+          std::vector<PortValue> operands;
+          for (auto& it : op)
+          {
+            operands.push_back(it.m_value);
+          }
+          res.m_value = performScalarReduction(node.m_bt, operands.data(), operands.size(), node.m_mode);
+        }
+        else
+        {
+          res.m_value = performScalarOperation(node.m_bt, op[0].m_value, op[1].m_value);
+        }
+      }
+      m_meter.count(node.m_bt, array, timed ? COpMeter::Clock::now() - start : COpMeter::Clock::duration::zero());
+
+      if (node.m_connected)
+      {
+        m_results[slot] = res;
+      }
+      if (res.m_array)
+      {
+        return CBlockAction{node.m_blockID, res.m_array};
+      }
+      return node.m_integral ? CBlockAction{node.m_blockID, res.m_integer}
+                             : CBlockAction{node.m_blockID, res.m_value};
+    }
+  }
+
+  /**
+   * @brief Computes all remaining blocks
+   * @param cancel Evaluation stops with E_CANCELLED once flag is set
+   * @param progress Called periodically with slots passed and all slots
+   * @return Results of the remaining blocks
+   */
+  std::deque<CBlockAction> CSchemeEvaluation::run(const std::atomic<bool> *cancel,
+                                                  const CSchemeSnapshot::Progress& progress)
+  {
+    TRACE_SPAN("evaluation");
+    CStatTimer timer(m_snapshot->getStats(), ST_RUN);
+    std::deque<CBlockAction> actions;
+
+    for (size_t i = 0; !finished(); i++)
+    {
+      if (i % STEP_STRIDE == 0)
+      {
+        if (cancel && cancel->load(std::memory_order_relaxed))
+        {
+          throw CBlockEditorException("Computation was cancelled", EErrorCode::E_CANCELLED);
+        }
+        if (progress)
+        {
+          progress(m_cursor, m_snapshot->getSlotCount());
+        }
+      }
+      actions.push_back(next());
+    }
+
+    if (progress)
+    {
+      progress(m_snapshot->getSlotCount(), m_snapshot->getSlotCount());
+    }
+    return actions;
+  }
+}
@@ -0,0 +1,64 @@
+/**
+ *		@file 		SchemeEvaluation.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Resumable evaluation of scheme snapshot, one block per step
+ */
+
+#pragma once
+
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "SchemeSnapshot.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  ///
+  /// Evaluation of snapshot which computes one block per call of next().
+  /// Slots are walked in order, block found there is computed after its
+  /// inputs, which are searched depth first. Every block is visited once,
+  /// so the work per step is constant on average, and nothing is prepared
+  /// in advance. Result is kept only until the consumer of the block is
+  /// computed.
+  ///
+  class CSchemeEvaluation
+  {
+  public:
+    explicit CSchemeEvaluation(SnapshotPtr snapshot);
+    ~CSchemeEvaluation();
+
+    uint64_t      getVersion() const;
+
+    bool          finished();
+    CBlockAction  next();
+    std::deque<CBlockAction> run(const std::atomic<bool> *cancel = nullptr,
+                                 const CSchemeSnapshot::Progress& progress = CSchemeSnapshot::Progress());
+
+  private:
+    ///
+    /// Computed value which wasnt used by consumer yet
+    ///
+    struct Result
+    {
+      PortValue     m_value;
+      PortArrayPtr  m_array;
+      PortInt       m_integer;    /**< Exact value of INT & HEX block */
+    };
+
+    SnapshotPtr               m_snapshot;     /**< Evaluated snapshot */
+    size_t                    m_cursor;       /**< Slots before cursor are done or on stack */
+    std::vector<size_t>       m_stack;        /**< Blocks waiting for their inputs */
+    std::unordered_set<size_t> m_onStack;     /**< Slots on stack, to detect cycles */
+    std::unordered_set<size_t> m_doneAhead;   /**< Computed blocks at or after cursor */
+    std::unordered_map<size_t, Result> m_results; /**< Results not consumed yet */
+    COpMeter                  m_meter;        /**< Computed blocks not added to stats yet */
+    MacroScratch              m_macro;        /**< Values inside macro block being computed */
+    bool                      m_finished;     /**< All blocks were computed */
+  };
+}
@@ -0,0 +1,597 @@
+/**
+ *		@file 		SchemeJournal.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Append-only binary journal of scheme edits stored next to
+ *              the scheme file, replayed on top of the last full snapshot
+ */
+
+#include "SchemeJournal.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "BlockEditorException.hpp"
+#include "SchemeTrace.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  namespace
+  {
+    const char      JOURNAL_MAGIC[4] = {'B', 'E', 'J', '1'};
+    const size_t    HEADER_SIZE      = sizeof(JOURNAL_MAGIC) + sizeof(uint64_t);
+    const size_t    MIN_COMPACTION   = 256 * 1024;  /**< Smaller journals are never compacted */
+    const uint8_t   WIDE_PORT        = 0xff;        /**< Port number doesnt fit, it follows as uint32 */
+
+    /// Appends value in host byte order
+    template<typename T>
+    void put(std::string& out, T value)
+    {
+      out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    /// Reads value written by put, false if data is too short
+    template<typename T>
+    bool get(const std::string& in, size_t& pos, T& value)
+    {
+      if (in.size() - pos < sizeof(T))
+      {
+        return false;
+      }
+      std::memcpy(&value, in.data() + pos, sizeof(T));
+      pos += sizeof(T);
+      return true;
+    }
+
+    std::string header(uint64_t snapshotHash)
+    {
+      std::string out(JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+      put<uint64_t>(out, snapshotHash);
+      return out;
+    }
+
+    /**
+     * @brief Encodes record as length, payload and checksum of payload,
+     *        record cut by crash fails the checksum. Port takes one byte
+     *        unless it is a high input of reduction block, so records
+     *        written before reductions existed read the same.
+     */
+    std::string encode(const JournalRecord& r)
+    {
+      std::string payload;
+      put<uint8_t>(payload, static_cast<uint8_t>(r.m_op));
+      uint32_t port = static_cast<uint32_t>(r.m_port);
+      put<uint8_t>(payload, port < WIDE_PORT ? static_cast<uint8_t>(port) : WIDE_PORT);
+      if (port >= WIDE_PORT)
+      {
+        put<uint32_t>(payload, port);
+      }
+      put<int32_t>(payload, static_cast<int32_t>(r.m_type));
+      put<uint32_t>(payload, r.m_blockID);
+      put<uint32_t>(payload, r.m_otherID);
+      put<int32_t>(payload, r.m_x);
+      put<int32_t>(payload, r.m_y);
+      put<double>(payload, r.m_value);
+      put<uint64_t>(payload, r.m_hash);
+      put<uint32_t>(payload, static_cast<uint32_t>(r.m_text.size()));
+      payload += r.m_text;
+
+      std::string out;
+      put<uint32_t>(out, static_cast<uint32_t>(payload.size()));
+      out += payload;
+      put<uint32_t>(out, static_cast<uint32_t>(CSchemeJournal::hash(payload)));
+      return out;
+    }
+
+    /**
+     * @brief Decodes record at pos, pos is moved after it
+     * @return False if record is incomplete or damaged
+     */
+    bool decode(const std::string& in, size_t& pos, JournalRecord& r)
+    {
+      size_t p = pos;
+      uint32_t length, check, textLength, port;
+      uint8_t op, shortPort;
+      int32_t type;
+
+      if (!get(in, p, length) || in.size() - p < size_t(length) + sizeof(check))
+      {
+        return false;
+      }
+      std::string payload = in.substr(p, length);
+      p += length;
+      if (!get(in, p, check) || check != static_cast<uint32_t>(CSchemeJournal::hash(payload)))
+      {
+        return false;
+      }
+
+      size_t q = 0;
+      if (!get(payload, q, op) || !get(payload, q, shortPort))
+      {
+        return false;
+      }
+      port = shortPort;
+      if ((shortPort == WIDE_PORT && !get(payload, q, port)) || !get(payload, q, type)
+            || !get(payload, q, r.m_blockID) || !get(payload, q, r.m_otherID)
+            || !get(payload, q, r.m_x) || !get(payload, q, r.m_y)
+            || !get(payload, q, r.m_value) || !get(payload, q, r.m_hash)
+            || !get(payload, q, textLength) || payload.size() - q != textLength)
+      {
+        return false;
+      }
+      if (op < JO_ADD_BLOCK || op > JO_ADD_MACRO
+            || port < static_cast<uint32_t>(Ports::P_INPUT1) || port > static_cast<uint32_t>(inputPort(MAX_INPUTS)))
+      {
+        return false;
+      }
+
+      r.m_op = static_cast<EJournalOp>(op);
+      r.m_port = static_cast<Ports>(port);
+      r.m_type = static_cast<EBlockType>(type);
+      r.m_text = payload.substr(q);
+      pos = p;
+      return true;
+    }
+
+    /// Writes whole buffer, throws on failure
+    void writeAll(int fd, const std::string& data, const std::string& fileName)
+    {
+      size_t done = 0;
+      while (done < data.size())
+      {
+        ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+        if (n < 0)
+        {
+          if (errno == EINTR)
+          {
+            continue;
+          }
+          throw CBlockEditorException("Cannot write file " + fileName + " -- " + std::strerror(errno), EErrorCode::E_UI_BAD_FILE);
+        }
+        done += n;
+      }
+    }
+
+    /// Replaces file by data, file contains either old or new data after crash
+    void replaceFile(const std::string& fileName, const std::string& data)
+    {
+      std::string tmp = fileName + ".tmp";
+      int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0)
+      {
+        throw CBlockEditorException("Cannot open file " + tmp + " -- " + std::strerror(errno), EErrorCode::E_UI_BAD_FILE);
+      }
+      try
+      {
+        writeAll(fd, data, tmp);
+      }
+      catch (...)
+      {
+        ::close(fd);
+        throw;
+      }
+      bool synced = ::fsync(fd) == 0;
+      ::close(fd);
+      if (!synced || std::rename(tmp.c_str(), fileName.c_str()) != 0)
+      {
+        throw CBlockEditorException("Cannot replace file " + fileName + " -- " + std::strerror(errno), EErrorCode::E_UI_BAD_FILE);
+      }
+    }
+  }
+
+  /**
+   * @brief Journal of scheme file, hash of the file is read when needed
+   * @param schemeFile Scheme file with the last snapshot
+   */
+  CSchemeJournal::CSchemeJournal(const std::string& schemeFile)
+    : m_schemeFile{schemeFile}, m_journalFile{journalName(schemeFile)}
+  {
+
+  }
+
+  /**
+   * @brief Journal of scheme file which was just written
+   * @param schemeFile Scheme file with the snapshot
+   * @param snapshot Content of the scheme file
+   */
+  CSchemeJournal::CSchemeJournal(const std::string& schemeFile, const std::string& snapshot)
+    : m_schemeFile{schemeFile}, m_journalFile{journalName(schemeFile)},
+      m_snapshotHash{hash(snapshot)}, m_snapshotSize{snapshot.size()}, m_hashed{true}
+  {
+
+  }
+
+  /**
+   * @brief Waits for running compaction and closes journal, unsaved
+   *        records are kept for recovery
+   */
+  CSchemeJournal::~CSchemeJournal()
+  {
+    finishCompaction(true);
+    if (m_fd >= 0)
+    {
+      ::close(m_fd);
+    }
+  }
+
+  /**
+   * @brief Name of journal file of scheme file
+   */
+  std::string CSchemeJournal::journalName(const std::string& schemeFile)
+  {
+    return schemeFile + ".journal";
+  }
+
+  /**
+   * @brief FNV-1a hash, identifies snapshot and checks records
+   */
+  uint64_t CSchemeJournal::hash(const std::string& data)
+  {
+    uint64_t h = 14695981039346656037ULL;
+    for (unsigned char c : data)
+    {
+      h ^= c;
+      h *= 1099511628211ULL;
+    }
+    return h;
+  }
+
+  /**
+   * @brief Reads whole file
+   * @return Content of file, empty if file doesnt exist
+   */
+  std::string CSchemeJournal::readFile(const std::string& fileName)
+  {
+    std::ifstream fd(fileName, std::ios::binary);
+    std::ostringstream ss;
+    ss << fd.rdbuf();
+    return ss.str();
+  }
+
+  /**
+   * @brief Writes full snapshot of scheme through temporary file, crash
+   *        during write leaves the previous snapshot in place
+   * @param fileName Scheme file
+   * @param data Saved scheme
+   */
+  void CSchemeJournal::writeSnapshot(const std::string& fileName, const std::string& data)
+  {
+    replaceFile(fileName, data);
+  }
+
+  /// Reads snapshot to find out which journal continues it
+  void CSchemeJournal::hashSnapshot()
+  {
+    if (!m_hashed)
+    {
+      std::string data = readFile(m_schemeFile);
+      m_snapshotHash = hash(data);
+      m_snapshotSize = data.size();
+      m_hashed = true;
+    }
+  }
+
+  /**
+   * @brief Applies saved records of journal which continues the snapshot,
+   *        records after the last commit are kept for recover()
+   * @param apply Called for each record in order
+   * @return Count of applied records
+   */
+  size_t CSchemeJournal::replay(const std::function<void(const JournalRecord&)>& apply)
+  {
+    TRACE_SPAN("replayJournal");
+    std::string data = readFile(m_journalFile);
+    if (data.size() < HEADER_SIZE || std::memcmp(data.data(), JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0)
+    {
+      return 0;
+    }
+
+    hashSnapshot();
+
+    uint64_t headHash;
+    size_t pos = sizeof(JOURNAL_MAGIC);
+    if (!get(data, pos, headHash))
+    {
+      return 0;
+    }
+
+    // Records and offsets after them, damaged tail is dropped
+    std::vector<std::pair<JournalRecord, size_t>> records;
+    JournalRecord r;
+    while (decode(data, pos, r))
+    {
+      records.emplace_back(r, pos);
+    }
+
+    // Journal starts at snapshot it was created for, or at compaction
+    // which wrote the snapshot but didnt manage to replace the journal
+    size_t first = 0;
+    m_matched = headHash == m_snapshotHash;
+    m_committedEnd = HEADER_SIZE;
+    for (size_t i = records.size(); !m_matched && i > 0; i--)
+    {
+      if (records[i-1].first.m_op == JO_COMPACT && records[i-1].first.m_hash == m_snapshotHash)
+      {
+        m_matched = true;
+        first = i;
+        m_committedEnd = records[i-1].second;
+      }
+    }
+    if (!m_matched)
+    {
+      return 0;
+    }
+    m_validEnd = records.empty() ? HEADER_SIZE : records.back().second;
+
+    size_t saved = first;
+    for (size_t i = first; i < records.size(); i++)
+    {
+      if (records[i].first.m_op == JO_COMMIT)
+      {
+        saved = i + 1;
+        m_committedEnd = records[i].second;
+      }
+    }
+
+    size_t applied = 0;
+    for (size_t i = first; i < records.size(); i++)
+    {
+      const JournalRecord& rec = records[i].first;
+      if (rec.m_op == JO_COMMIT || rec.m_op == JO_COMPACT)
+      {
+        continue;
+      }
+      if (i < saved)
+      {
+        apply(rec);
+        applied++;
+      }
+      else
+      {
+        m_unsaved.push_back(rec);
+      }
+    }
+
+    return applied;
+  }
+
+  /**
+   * @brief Applies records which were not saved, left by crash
+   * @param apply Called for each record in order
+   * @return Count of applied records
+   */
+  size_t CSchemeJournal::recover(const std::function<void(const JournalRecord&)>& apply)
+  {
+    for (auto& it : m_unsaved)
+    {
+      apply(it);
+    }
+    m_recovered = true;
+    return m_unsaved.size();
+  }
+
+  /// @return Count of records after the last commit found by replay()
+  size_t CSchemeJournal::unsavedCount() const
+  {
+    return m_unsaved.size();
+  }
+
+  /**
+   * @brief Opens journal for appending. Journal found by replay() is
+   *        continued, unsaved records are dropped unless recovered.
+   *        Otherwise new journal is created for the current snapshot.
+   */
+  void CSchemeJournal::open()
+  {
+    if (m_fd >= 0)
+    {
+      return;
+    }
+
+    if (m_matched)
+    {
+      m_fd = ::open(m_journalFile.c_str(), O_WRONLY | O_APPEND);
+      m_size = m_recovered ? m_validEnd : m_committedEnd;
+      if (m_fd >= 0 && ::ftruncate(m_fd, m_size) != 0)
+      {
+        ::close(m_fd);
+        m_fd = -1;
+      }
+    }
+    else
+    {
+      hashSnapshot();
+      std::string head = header(m_snapshotHash);
+      replaceFile(m_journalFile, head);
+      m_fd = ::open(m_journalFile.c_str(), O_WRONLY | O_APPEND);
+      m_size = head.size();
+    }
+
+    if (m_fd < 0)
+    {
+      throw CBlockEditorException("Cannot open journal " + m_journalFile + " -- " + std::strerror(errno), EErrorCode::E_UI_BAD_FILE);
+    }
+    m_lastCommit = m_size;
+    m_unsaved.clear();
+  }
+
+  /**
+   * @brief Stops journaling
+   * @param discardUnsaved Drop records after the last commit, scheme was
+   *        closed without saving
+   */
+  void CSchemeJournal::close(bool discardUnsaved)
+  {
+    finishCompaction(true);
+    if (m_fd < 0)
+    {
+      return;
+    }
+    if (discardUnsaved && ::ftruncate(m_fd, m_lastCommit) != 0)
+    {
+      std::cerr << "Warning: Cannot truncate journal " << m_journalFile << std::endl;
+    }
+    ::close(m_fd);
+    m_fd = -1;
+  }
+
+  /// @return True if edits are being recorded
+  bool CSchemeJournal::isOpen() const
+  {
+    return m_fd >= 0;
+  }
+
+  /**
+   * @brief Appends record to the journal, record is in the file (not
+   *        necessarily on disk) when function returns
+   */
+  void CSchemeJournal::append(const JournalRecord& r)
+  {
+    finishCompaction(false);
+
+    std::string frame = encode(r);
+    writeAll(m_fd, frame, m_journalFile);
+    m_size += frame.size();
+
+    // Journal replacing this one gets the record too
+    if (m_compactor.joinable())
+    {
+      m_tail += frame;
+    }
+  }
+
+  /**
+   * @brief Marks everything written so far as saved and syncs journal to disk
+   */
+  void CSchemeJournal::commit()
+  {
+    JournalRecord r;
+    r.m_op = JO_COMMIT;
+    append(r);
+
+    if (::fsync(m_fd) != 0)
+    {
+      throw CBlockEditorException("Cannot sync journal " + m_journalFile + " -- " + std::strerror(errno), EErrorCode::E_UI_BAD_FILE);
+    }
+    m_lastCommit = m_size;
+    m_tailCommit = m_tail.size();
+
+    // Error is written by compactor, it can be read once the thread is joined
+    if (!m_compactor.joinable() && !m_compactError.empty())
+    {
+      std::string err = std::move(m_compactError);
+      m_compactError.clear();
+      throw CBlockEditorException("Journal compaction failed, journal is kept -- " + err, EErrorCode::E_UI_BAD_FILE);
+    }
+  }
+
+  /// @return True if journal outgrew the snapshot and no compaction runs
+  bool CSchemeJournal::needsCompaction() const
+  {
+    return m_fd >= 0 && !m_compactor.joinable()
+        && m_size > std::max(MIN_COMPACTION, m_snapshotSize);
+  }
+
+  /**
+   * @brief Starts writing new snapshot on background thread. Journal is
+   *        replaced once the snapshot is in place.
+   * @param snapshot Scheme serialized at the last commit
+   */
+  void CSchemeJournal::compact(std::string snapshot)
+  {
+    if (m_compactor.joinable())
+    {
+      return;
+    }
+
+    m_compactHash = hash(snapshot);
+    m_compactSize = snapshot.size();
+
+    // Lets replay find its way if crash comes between snapshot and journal replacement
+    JournalRecord r;
+    r.m_op = JO_COMPACT;
+    r.m_hash = m_compactHash;
+    append(r);
+    ::fsync(m_fd);
+    m_lastCommit = m_size;
+
+    m_tail.clear();
+    m_tailCommit = 0;
+    m_compactDone = false;
+    m_compactor = std::thread([this, data = std::move(snapshot)]() {
+      TRACE_THREAD("compactor");
+      TRACE_SPAN("compact");
+      try
+      {
+        writeSnapshot(m_schemeFile, data);
+      }
+      catch (CBlockEditorException& e)
+      {
+        m_compactError = e.what();
+      }
+      m_compactDone = true;
+    });
+  }
+
+  /**
+   * @brief Replaces journal after compaction wrote the snapshot
+   * @param wait Wait for compaction, otherwise return if it still runs
+   */
+  void CSchemeJournal::finishCompaction(bool wait)
+  {
+    if (!m_compactor.joinable() || (!wait && !m_compactDone))
+    {
+      return;
+    }
+    m_compactor.join();
+
+    if (m_compactError.empty())
+    {
+      try
+      {
+        std::string head = header(m_compactHash);
+        replaceFile(m_journalFile, head + m_tail);
+
+        int fd = ::open(m_journalFile.c_str(), O_WRONLY | O_APPEND);
+        if (fd < 0)
+        {
+          throw CBlockEditorException("Cannot open journal " + m_journalFile + " -- " + std::strerror(errno), EErrorCode::E_UI_BAD_FILE);
+        }
+        if (m_fd >= 0)
+        {
+          ::close(m_fd);
+        }
+        m_fd = fd;
+        m_size = head.size() + m_tail.size();
+        m_lastCommit = head.size() + m_tailCommit;
+        m_snapshotHash = m_compactHash;
+        m_snapshotSize = m_compactSize;
+      }
+      catch (CBlockEditorException& e)
+      {
+        // Old journal still has all records after compaction record
+        m_compactError = e.what();
+      }
+    }
+
+    m_tail.clear();
+    m_tailCommit = 0;
+  }
+
+  /// @return Scheme file the journal belongs to
+  const std::string& CSchemeJournal::getSchemeFile() const
+  {
+    return m_schemeFile;
+  }
+}
@@ -0,0 +1,131 @@
+/**
+ *		@file 		SchemeJournal.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Append-only binary journal of scheme edits stored next to
+ *              the scheme file, replayed on top of the last full snapshot
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BlockType.hpp"
+#include "Port.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  ///
+  /// Kind of journal record
+  ///
+  enum EJournalOp
+  {
+    JO_ADD_BLOCK = 1,   /**< Block m_blockID of m_type/m_text was added */
+    JO_REMOVE_BLOCK,    /**< Block m_blockID was removed */
+    JO_ADD_PORT,        /**< Output of m_blockID was connected to m_port of m_otherID */
+    JO_REMOVE_PORT,     /**< Connection added by JO_ADD_PORT was removed */
+    JO_INPUT_VALUE,     /**< m_value was assigned to m_port of m_blockID by input block m_otherID */
+    JO_INPUT_ARRAY,     /**< Values from file m_text were assigned, same as JO_INPUT_VALUE */
+    JO_REMOVE_INPUT,    /**< Value of m_port of m_blockID was removed */
+    JO_POSITION,        /**< Block m_blockID was moved to m_x, m_y */
+    JO_COMMIT,          /**< Scheme was saved, preceding records are part of the saved scheme */
+    JO_COMPACT,         /**< Snapshot with hash m_hash contains all preceding records */
+    JO_REMOVE_BLOCKS,   /**< Blocks with IDs listed in m_text were removed */
+    JO_CLEAR,           /**< All blocks were removed */
+    JO_REDUCTION,       /**< Reduction block m_blockID has m_x inputs and EReduceMode m_y */
+    JO_COLLAPSE,        /**< Trees of ADD and MUL blocks were collapsed to reductions */
+    JO_DEFINE_MACRO,    /**< Macro named by first line of m_text was defined from blocks listed after it */
+    JO_ADD_MACRO,       /**< Block m_blockID instancing macro m_text was added */
+  };
+
+  ///
+  /// One edit of the scheme, fields not used by the operation are zero
+  ///
+  struct JournalRecord
+  {
+    EJournalOp    m_op = JO_COMMIT;
+    Ports         m_port = Ports::P_INPUT1;
+    EBlockType    m_type = BT_INPUT;
+    ID            m_blockID = 0;
+    ID            m_otherID = 0;
+    int           m_x = 0, m_y = 0;
+    PortValue     m_value = .0;
+    uint64_t      m_hash = 0;
+    std::string   m_text;
+  };
+
+  ///
+  /// Journal of one scheme file. Records are appended to "<scheme>.journal"
+  /// as edits happen, save only appends commit record and syncs the file.
+  /// Journal header holds hash of the snapshot it continues, so journal left
+  /// from other version of the scheme file is never replayed. Compaction
+  /// writes new snapshot on background thread, edits made meanwhile are
+  /// written to both old journal and the journal which replaces it.
+  ///
+  class CSchemeJournal
+  {
+  public:
+    explicit CSchemeJournal(const std::string& schemeFile);
+    CSchemeJournal(const std::string& schemeFile, const std::string& snapshot);
+    ~CSchemeJournal();
+
+    CSchemeJournal(const CSchemeJournal&) = delete;
+    CSchemeJournal& operator=(const CSchemeJournal&) = delete;
+
+    static std::string  journalName(const std::string& schemeFile);
+    static uint64_t     hash(const std::string& data);
+    static std::string  readFile(const std::string& fileName);
+    static void         writeSnapshot(const std::string& fileName, const std::string& data);
+
+    size_t        replay(const std::function<void(const JournalRecord&)>& apply);
+    size_t        recover(const std::function<void(const JournalRecord&)>& apply);
+    size_t        unsavedCount() const;
+
+    void          open();
+    void          close(bool discardUnsaved);
+    bool          isOpen() const;
+
+    void          append(const JournalRecord&);
+    void          commit();
+    bool          needsCompaction() const;
+    void          compact(std::string snapshot);
+
+    const std::string& getSchemeFile() const;
+
+  private:
+    void          hashSnapshot();
+    void          finishCompaction(bool wait);
+
+    std::string               m_schemeFile;       /**< Scheme file the journal belongs to */
+    std::string               m_journalFile;      /**< "<scheme>.journal" */
+    uint64_t                  m_snapshotHash = 0; /**< Hash of snapshot the journal continues */
+    size_t                    m_snapshotSize = 0; /**< Size of snapshot, compaction threshold */
+    bool                      m_hashed = false;   /**< Snapshot hash and size are known */
+
+    bool                      m_matched = false;  /**< Journal on disk continues the snapshot */
+    size_t                    m_committedEnd = 0; /**< Offset after last commit record on disk */
+    size_t                    m_validEnd = 0;     /**< Offset after last undamaged record on disk */
+    std::vector<JournalRecord> m_unsaved;         /**< Records after last commit */
+    bool                      m_recovered = false;/**< m_unsaved were applied to scheme */
+
+    int                       m_fd = -1;          /**< Journal file open for appending */
+    size_t                    m_size = 0;         /**< Bytes of open journal */
+    size_t                    m_lastCommit = 0;   /**< Bytes of open journal up to last commit */
+
+    std::thread               m_compactor;        /**< Writes new snapshot */
+    std::atomic<bool>         m_compactDone{false};
+    std::string               m_compactError;     /**< Set by compactor, read after join */
+    uint64_t                  m_compactHash = 0;  /**< Hash of snapshot being written */
+    size_t                    m_compactSize = 0;  /**< Size of snapshot being written */
+    std::string               m_tail;             /**< Records appended during compaction */
+    size_t                    m_tailCommit = 0;   /**< Bytes of m_tail up to last commit */
+  };
+}
@@ -0,0 +1,63 @@
+/**
+ *		@file 		SchemeMemory.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Bytes of memory used by parts of scheme
+ */
+
+#include "SchemeMemory.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  /// @return Bytes of all parts, peaks not included
+  uint64_t SchemeMemory::getTotal() const
+  {
+    uint64_t total = 0;
+    for (auto it : m_bytes)
+    {
+      total += it;
+    }
+    return total;
+  }
+
+  /**
+   * @brief Characters of string stored outside of it. Short strings are
+   *        kept inline and take no memory besides the owner.
+   * @param s The string
+   * @return Bytes allocated by the string
+   */
+  uint64_t CMemoryCounter::stringBytes(const std::string& s)
+  {
+    const char *inlineBegin = reinterpret_cast<const char*>(&s);
+    const char *inlineEnd = inlineBegin + sizeof(s);
+    if (s.data() >= inlineBegin && s.data() < inlineEnd)
+    {
+      return 0;
+    }
+    return s.capacity() + 1;
+  }
+
+  /**
+   * @brief Array of values with its vector and control block, arrays
+   *        shared by blocks, ports and results are counted once
+   * @param pa The array
+   * @return Bytes of array, 0 if counted already or null
+   */
+  uint64_t CMemoryCounter::arrayBytes(const PortArrayPtr& pa)
+  {
+    uint64_t bytes = sharedBytes(pa);
+    return bytes ? bytes + vectorBytes(*pa) : 0;
+  }
+
+  /// @return Name of part, as printed in reports and exported stats
+  const char* memoryPartName(EMemoryPart part)
+  {
+    static const char *names[MP_COUNT] = {
+      "blocks", "ports", "strings", "arrays", "indexes", "actions", "snapshots", "macros"
+    };
+    return names[part];
+  }
+}
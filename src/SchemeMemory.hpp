@@ -0,0 +1,106 @@
+/**
+ *		@file 		SchemeMemory.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Bytes of memory used by parts of scheme
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "Port.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  ///
+  /// Parts of scheme memory is accounted to
+  ///
+  enum EMemoryPart
+  {
+    MP_BLOCKS = 0,      /**< Storage of blocks, input blocks included */
+    MP_PORTS,           /**< Ports, allocated one by one */
+    MP_STRINGS,         /**< Characters of names and file names, if not stored inline */
+    MP_ARRAYS,          /**< Values of vector-valued inputs and results, each array once */
+    MP_INDEXES,         /**< Hash indexes and free lists of slots and ports */
+    MP_ACTIONS,         /**< Results of the last run */
+    MP_SNAPSHOTS,       /**< Pages of snapshot nodes kept for the next snapshot */
+    MP_MACROS,          /**< Definitions of macros, shared by all their instances */
+    MP_COUNT
+  };
+
+  ///
+  /// Memory of scheme at one moment, with peaks since stats were reset
+  ///
+  struct SchemeMemory
+  {
+    uint64_t      m_bytes[MP_COUNT] = {};
+    uint64_t      m_blocks = 0;       /**< Blocks, input blocks included */
+    uint64_t      m_inputBlocks = 0;  /**< Input blocks holding values of input ports */
+    uint64_t      m_ports = 0;
+    uint64_t      m_loadPeak = 0;     /**< Highest bytes during load, parsed records included */
+    uint64_t      m_runPeak = 0;      /**< Highest bytes of buffers and results of one run */
+
+    uint64_t      getTotal() const;
+  };
+
+  ///
+  /// Counts bytes containers request from the allocator, laid out as the
+  /// standard library of GCC lays them out. Bookkeeping of the allocator
+  /// itself is not counted. Shared objects are counted by the first owner
+  /// only, so one counter is used for whole report.
+  ///
+  class CMemoryCounter
+  {
+  public:
+    static uint64_t stringBytes(const std::string&);
+
+    /// @return Bytes of elements, capacity included
+    template <typename T>
+    static uint64_t vectorBytes(const std::vector<T>& v)
+    {
+      return v.capacity() * sizeof(T);
+    }
+
+    /// @return Bytes of element buffers and of the map pointing to them
+    template <typename T>
+    static uint64_t dequeBytes(const std::deque<T>& d)
+    {
+      const uint64_t perBuffer = sizeof(T) < 512 ? 512 / sizeof(T) : 1;
+      const uint64_t buffers = d.size() / perBuffer + 1;
+      return buffers * perBuffer * sizeof(T) + std::max<uint64_t>(8, buffers + 2) * sizeof(void*);
+    }
+
+    /// @return Bytes of buckets and nodes, hash codes are not cached for integral keys
+    template <typename M>
+    static uint64_t hashBytes(const M& m)
+    {
+      const uint64_t node = (sizeof(void*) + sizeof(typename M::value_type) + alignof(void*) - 1)
+                          / alignof(void*) * alignof(void*);
+      return (m.bucket_count() > 1 ? m.bucket_count() * sizeof(void*) : 0) + m.size() * node;
+    }
+
+    /// @return Bytes of object made by std::make_shared, if not counted yet
+    template <typename T>
+    uint64_t sharedBytes(const std::shared_ptr<T>& p)
+    {
+      return p && m_seen.insert(p.get()).second ? sizeof(T) + 2 * sizeof(int) + sizeof(void*) : 0;
+    }
+
+    uint64_t      arrayBytes(const PortArrayPtr&);
+
+  private:
+    std::unordered_set<const void*> m_seen;     /**< Shared objects counted already */
+  };
+
+  const char*   memoryPartName(EMemoryPart);
+}
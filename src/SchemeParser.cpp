@@ -0,0 +1,302 @@
+/**
+ *		@file 		SchemeParser.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Parallel parsing of text scheme files, file is split at
+ *              record boundaries and chunks are parsed on multiple threads
+ */
+
+#include <fstream>
+#include <thread>
+#include <algorithm>
+
+#include "SchemeParser.hpp"
+#include "ArrayFile.hpp"
+#include "BlockEditorException.hpp"
+#include "SchemeTrace.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  namespace
+  {
+    /// Files smaller than this per thread are not worth splitting
+    const std::streamoff MIN_CHUNK_SIZE = 1 << 20;
+
+    /**
+     * @brief Finds start of first "Type:" line at or after offset
+     * @param fd Opened scheme file
+     * @param offset Where to start looking
+     * @param size Size of file
+     * @return Offset of record start, size of file if there is none
+     */
+    std::streamoff findRecordStart(std::ifstream& fd, std::streamoff offset, std::streamoff size)
+    {
+      std::string line;
+      std::streamoff pos;
+
+      if (offset == 0)
+      {
+        return 0;
+      }
+
+      // Skip rest of line containing offset-1, then we are at line start
+      fd.clear();
+      fd.seekg(offset - 1);
+      if (!std::getline(fd, line))
+      {
+        return size;
+      }
+      pos = offset + line.size();
+
+      while (std::getline(fd, line))
+      {
+        if (line.compare(0, 5, "Type:") == 0)
+        {
+          return pos;
+        }
+        pos += line.size() + 1;
+      }
+
+      return size;
+    }
+
+    ///
+    /// Read only stream buffer over memory, the memory isnt copied
+    ///
+    class CMemoryBuffer : public std::streambuf
+    {
+    public:
+      CMemoryBuffer(const char *data, size_t size)
+      {
+        char *begin = const_cast<char*>(data);
+        setg(begin, begin, begin + size);
+      }
+    };
+
+    /**
+     * @brief Parses lines of stream in range <begin, end) into records
+     * @param fd Stream positioned at offset begin
+     * @param begin Offset of first line
+     * @param end Offset where chunk ends
+     * @param chunk Where parsed records are stored
+     */
+    void parseChunk(std::istream& fd, std::streamoff begin, std::streamoff end, SchemeChunk& chunk)
+    {
+      TRACE_SPAN("parseChunk");
+      std::string delimiter = ":";
+      std::string line, token1, token2;
+      std::streamoff pos = begin;
+      SchemeRecord rec;
+
+      while (pos < end && std::getline(fd, line))
+      {
+        pos += line.size() + 1;
+        token1 = line.substr(0, line.find(delimiter));
+        token2 = line.substr(line.find(delimiter) + 1);
+
+        try
+        {
+          if (token1 == "Type")
+          {
+            rec.m_bt = static_cast<EBlockType>(std::stoi(token2));
+            rec.m_fields |= RF_TYPE;
+          }
+          else if (token1 == "ID")
+          {
+            rec.m_blockID = std::stoul(token2, nullptr, 0);
+            rec.m_fields |= RF_ID;
+            chunk.m_maxID = std::max(chunk.m_maxID, rec.m_blockID);
+          }
+          else if (token1 == "Position X")
+          {
+            rec.m_x = std::stoi(token2);
+            rec.m_fields |= RF_X;
+          }
+          else if (token1 == "Position Y")
+          {
+            rec.m_y = std::stoi(token2);
+            rec.m_fields |= RF_Y;
+          }
+          else if (token1 == "Input value")
+          {
+            if (token2 == "None") continue;
+            rec.m_value = stod(token2);
+            rec.m_fields |= RF_VALUE;
+          }
+          else if (token1 == "Input file")
+          {
+            rec.m_file = token2;
+            rec.m_array = loadArrayFile(rec.m_file);
+            rec.m_fields |= RF_FILE;
+          }
+          else if (token1 == "Type name")
+          {
+            rec.m_tn = std::string(token2);
+            rec.m_fields |= RF_TYPE_NAME;
+          }
+          else if (token1 == "Macro")
+          {
+            rec.m_macro = token2;
+            rec.m_fields |= RF_MACRO;
+          }
+          else if (token1 == "Macro input")
+          {
+            rec.m_param = std::stoul(token2);
+            if (rec.m_param < 1 || rec.m_param > MAX_INPUTS)
+            {
+              throw CBlockEditorException("Bad number of macro input " + token2, EErrorCode::E_UI_BAD_FILE);
+            }
+            rec.m_fields |= RF_PARAM;
+          }
+          else if (token1 == "Input 1 ID")
+          {
+            if (token2 == "None") continue;
+            rec.m_input1 = std::stoi(token2);
+            rec.m_fields |= RF_INPUT1;
+            chunk.m_maxPortID = std::max(chunk.m_maxPortID, rec.m_input1);
+          }
+          else if (token1 == "Input 2 ID")
+          {
+            if (token2 == "None") continue;
+            rec.m_input2 = std::stoi(token2);
+            rec.m_fields |= RF_INPUT2;
+            chunk.m_maxPortID = std::max(chunk.m_maxPortID, rec.m_input2);
+          }
+          else if (token1.size() > 9 && token1.compare(0, 6, "Input ") == 0
+                     && token1.compare(token1.size() - 3, 3, " ID") == 0)
+          {
+            // Inputs of reduction block past the second, "Input <n> ID"
+            size_t n = std::stoul(token1.substr(6, token1.size() - 9));
+            if (n < 3 || n > MAX_INPUTS)
+            {
+              throw CBlockEditorException("Bad number of input " + std::to_string(n), EErrorCode::E_UI_BAD_FILE);
+            }
+            ID id = NO_PORT;
+            if (token2 != "None")
+            {
+              id = std::stoi(token2);
+              chunk.m_maxPortID = std::max(chunk.m_maxPortID, id);
+            }
+            rec.m_more.emplace_back(n, id);
+          }
+          else if (token1 == "Reduction")
+          {
+            if (token2 == "kahan")
+              rec.m_mode = RM_KAHAN;
+            else if (token2 == "pairwise")
+              rec.m_mode = RM_PAIRWISE;
+            else if (token2 == "plain")
+              rec.m_mode = RM_PLAIN;
+            else
+              throw CBlockEditorException("Unknown reduction " + token2, EErrorCode::E_UI_BAD_FILE);
+            rec.m_fields |= RF_MODE;
+          }
+          else if (token1 == "Output ID")
+          {
+            if (token2 != "None")
+            {
+              rec.m_output = std::stoi(token2);
+              rec.m_fields |= RF_OUTPUT;
+              chunk.m_maxPortID = std::max(chunk.m_maxPortID, rec.m_output);
+            }
+
+            rec.m_complete = true;
+            chunk.m_records.push_back(std::move(rec));
+            rec = SchemeRecord{};
+          }
+          else
+          {
+            throw CBlockEditorException("", EErrorCode::E_UI_BAD_FILE);
+          }
+        } catch (std::exception& e)
+        {
+          chunk.m_failed = true;
+          chunk.m_error = e.what();
+          return;
+        }
+      }
+
+      // Record continues in next chunk
+      if (rec.m_fields != 0 || !rec.m_more.empty())
+      {
+        chunk.m_records.push_back(std::move(rec));
+      }
+    }
+  }
+
+  /**
+   * @brief Splits scheme file at record boundaries ("Type:" lines) and parses
+   *        the parts in parallel. Chunks are returned in file order.
+   * @param fileName Name of scheme file
+   * @param threads Count of threads, 0 means count of hardware threads
+   * @return Parsed chunks
+   */
+  std::vector<SchemeChunk> parseSchemeFile(const std::string& fileName, unsigned threads)
+  {
+    std::ifstream fd(fileName, std::ios::binary | std::ios::ate);
+    if (!fd.is_open())
+    {
+      throw CBlockEditorException(std::string("Could not open file " + fileName), EErrorCode::E_UI_BAD_FILE);
+    }
+
+    std::streamoff size = fd.tellg();
+
+    if (threads == 0)
+    {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(std::max<std::streamoff>(1,
+                std::min<std::streamoff>(threads, size / MIN_CHUNK_SIZE)));
+
+    // Boundaries are found the same way from evenly spaced offsets
+    std::vector<std::streamoff> bounds{0};
+    for (unsigned i = 1; i < threads; i++)
+    {
+      bounds.push_back(std::max(bounds.back(), findRecordStart(fd, size * i / threads, size)));
+    }
+    bounds.push_back(size);
+    fd.close();
+
+    std::vector<SchemeChunk> chunks(threads);
+    std::vector<std::thread> workers;
+
+    for (unsigned i = 1; i < threads; i++)
+    {
+      workers.emplace_back([&fileName, &bounds, &chunks, i] {
+        TRACE_THREAD("parser");
+        std::ifstream fd(fileName, std::ios::binary);
+        fd.seekg(bounds[i]);
+        parseChunk(fd, bounds[i], bounds[i + 1], chunks[i]);
+      });
+    }
+    std::ifstream fd0(fileName, std::ios::binary);
+    parseChunk(fd0, bounds[0], bounds[1], chunks[0]);
+
+    for (auto& it : workers)
+    {
+      it.join();
+    }
+
+    return chunks;
+  }
+
+  /**
+   * @brief Parses scheme in the save file format held in memory, on the
+   *        calling thread
+   * @param data Text of the scheme, not copied
+   * @param size Length of the text
+   * @return Parsed chunk, only one
+   */
+  std::vector<SchemeChunk> parseSchemeText(const char *data, size_t size)
+  {
+    CMemoryBuffer buffer(data, size);
+    std::istream fd(&buffer);
+    std::vector<SchemeChunk> chunks(1);
+
+    parseChunk(fd, 0, static_cast<std::streamoff>(size), chunks[0]);
+    return chunks;
+  }
+}
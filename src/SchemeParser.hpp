@@ -0,0 +1,93 @@
+/**
+ *		@file 		SchemeParser.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Parallel parsing of text scheme files, file is split at
+ *              record boundaries and chunks are parsed on multiple threads
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BlockType.hpp"
+#include "Port.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  ///
+  /// Which lines of record were present in the file
+  ///
+  enum ERecordField
+  {
+    RF_TYPE       = 1 << 0,
+    RF_ID         = 1 << 1,
+    RF_X          = 1 << 2,
+    RF_Y          = 1 << 3,
+    RF_TYPE_NAME  = 1 << 4,
+    RF_VALUE      = 1 << 5,
+    RF_FILE       = 1 << 6,
+    RF_INPUT1     = 1 << 7,
+    RF_INPUT2     = 1 << 8,
+    RF_OUTPUT     = 1 << 9,
+    RF_MODE       = 1 << 10,
+    RF_MACRO      = 1 << 11,
+    RF_PARAM      = 1 << 12
+  };
+
+  /// Input of reduction block which isnt connected, on "Input <n> ID:None" line
+  const ID NO_PORT = static_cast<ID>(-1);
+
+  ///
+  /// Lines of one block as they were read, record is closed by "Output ID"
+  /// line. Fields missing in record keep value of previous record, which is
+  /// resolved when chunks are merged in file order.
+  ///
+  struct SchemeRecord
+  {
+    unsigned      m_fields = 0;       /**< Mask of ERecordField present in record */
+    bool          m_complete = false; /**< Record was closed by "Output ID" line */
+
+    EBlockType    m_bt = BT_INPUT;
+    ID            m_blockID = 0;
+    int           m_x = 0, m_y = 0;
+    PortValue     m_value = .0;
+    TypeName      m_tn;
+    std::string   m_file;
+    PortArrayPtr  m_array;
+
+    ID            m_input1 = 0;       /**< Port IDs, valid if field is present */
+    ID            m_input2 = 0;
+    ID            m_output = 0;
+
+    /// Inputs past the second of reduction block, number and port ID or NO_PORT
+    std::vector<std::pair<size_t, ID>> m_more;
+    EReduceMode   m_mode = RM_PLAIN;
+
+    /// Macro the block is part of, or which macro block is instance of,
+    /// these fields belong to one record only
+    std::string   m_macro;
+    size_t        m_param = 0;        /**< Input of macro, input blocks of the body only */
+  };
+
+  ///
+  /// Records parsed from one part of file. The last record may be incomplete,
+  /// it is continued by the first record of the next chunk.
+  ///
+  struct SchemeChunk
+  {
+    std::vector<SchemeRecord> m_records;
+    ID            m_maxID = 0;        /**< Max block ID on any "ID" line */
+    ID            m_maxPortID = 0;    /**< Max port ID on any port line */
+    bool          m_failed = false;   /**< Parsing stopped at bad line */
+    std::string   m_error;            /**< Why parsing failed */
+  };
+
+  std::vector<SchemeChunk>  parseSchemeFile(const std::string&, unsigned threads = 0);
+  std::vector<SchemeChunk>  parseSchemeText(const char *, size_t);
+}
@@ -39,12 +39,12 @@ namespace BlockEditorLogic
       SchemePart(EBlockType bt, ID blockID, std::pair<int, int> coords,
         Port inPort1, Port inPort2, Port outPort, PortValue inVal1,
         PortValue inVal2, ID inBlock1, ID inBlock2, ID outBlock, Ports which,
-        TypeName tn)
+        TypeName tn, std::string inFile1 = "", std::string inFile2 = "")
         :
         m_bt{bt}, m_blockID{blockID}, m_coords{coords}, m_inPort1{inPort1},
         m_inPort2{inPort2}, m_outPort{outPort}, m_inVal1{inVal1}, m_inVal2{inVal2},
         m_inBlock1{inBlock1}, m_inBlock2{inBlock2}, m_outBlock{outBlock}, m_which{which},
-        m_tn{tn}
+        m_tn{tn}, m_inFile1{inFile1}, m_inFile2{inFile2}
        {
 
        }
@@ -66,5 +66,8 @@ namespace BlockEditorLogic
       Ports               m_which;
 
       TypeName            m_tn;
+
+      std::string         m_inFile1;  /**< File with array of values, if input 1 has array */
+      std::string         m_inFile2;  /**< File with array of values, if input 2 has array */
     };
 }
\ No newline at end of file
@@ -0,0 +1,201 @@
+/**
+ *		@file 		SchemeProfile.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Hardware performance counters of profiled phases
+ */
+
+#include "SchemeProfile.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+#ifdef __linux__
+  /// Generic hardware events of the counters, by EPerfCounter
+  static const uint64_t PERF_CONFIG[PC_COUNT] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+  };
+
+  /**
+   * @brief Opens counter of the calling thread, glibc has no wrapper
+   * @param config Hardware event
+   * @param group Leader of group, -1 opens the leader
+   * @return File descriptor, -1 with errno set on failure
+   */
+  static int openCounter(uint64_t config, int group)
+  {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = group == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID
+                     | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+  }
+#endif
+
+  /**
+   * @brief Opens the counters, cycles lead the group. Other counters the
+   *        CPU does not have are left out.
+   */
+  CPerfGroup::CPerfGroup()
+    : m_ids{}
+  {
+    for (int i = 0; i < PC_COUNT; i++)
+    {
+      m_fds[i] = -1;
+    }
+
+#ifdef __linux__
+    m_fds[PC_CYCLES] = openCounter(PERF_CONFIG[PC_CYCLES], -1);
+    if (m_fds[PC_CYCLES] == -1)
+    {
+      m_error = std::string("perf_event_open failed -- ") + std::strerror(errno);
+      if (errno == EACCES || errno == EPERM)
+      {
+        m_error += ", see /proc/sys/kernel/perf_event_paranoid";
+      }
+      else if (errno == ENOENT || errno == ENODEV)
+      {
+        m_error += ", CPU has no counters, e.g. in a virtual machine";
+      }
+      return;
+    }
+    if (ioctl(m_fds[PC_CYCLES], PERF_EVENT_IOC_ID, &m_ids[PC_CYCLES]) == -1)
+    {
+      m_error = std::string("Cannot get ID of counter -- ") + std::strerror(errno);
+      close(m_fds[PC_CYCLES]);
+      m_fds[PC_CYCLES] = -1;
+      return;
+    }
+
+    for (int i = PC_CYCLES + 1; i < PC_COUNT; i++)
+    {
+      m_fds[i] = openCounter(PERF_CONFIG[i], m_fds[PC_CYCLES]);
+      if (m_fds[i] != -1 && ioctl(m_fds[i], PERF_EVENT_IOC_ID, &m_ids[i]) == -1)
+      {
+        close(m_fds[i]);
+        m_fds[i] = -1;
+      }
+    }
+#else
+    m_error = "Hardware counters are supported on Linux only";
+#endif
+  }
+
+  /**
+   * @brief Closes the counters
+   */
+  CPerfGroup::~CPerfGroup()
+  {
+#ifdef __linux__
+    for (int i = 0; i < PC_COUNT; i++)
+    {
+      if (m_fds[i] != -1)
+      {
+        close(m_fds[i]);
+      }
+    }
+#endif
+  }
+
+  /// @return True if hardware counters are counted, wall time only otherwise
+  bool CPerfGroup::available() const
+  {
+    return m_fds[PC_CYCLES] != -1;
+  }
+
+  /// @return Why hardware counters are not available, empty if they are
+  const std::string& CPerfGroup::getError() const
+  {
+    return m_error;
+  }
+
+  /**
+   * @brief Resets and starts all counters of the group at once
+   */
+  void CPerfGroup::start()
+  {
+#ifdef __linux__
+    if (available())
+    {
+      ioctl(m_fds[PC_CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ioctl(m_fds[PC_CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+    m_start = std::chrono::steady_clock::now();
+  }
+
+  /**
+   * @brief Stops all counters of the group at once
+   * @return Counters since start
+   */
+  PerfSample CPerfGroup::stop()
+  {
+    PerfSample s;
+    s.m_wallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - m_start).count();
+
+#ifdef __linux__
+    if (!available())
+    {
+      return s;
+    }
+    ioctl(m_fds[PC_CYCLES], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // nr, time enabled, time running, then value and ID of each counter
+    std::vector<uint64_t> data(3 + 2 * PC_COUNT);
+    ssize_t n = read(m_fds[PC_CYCLES], data.data(), data.size() * sizeof(uint64_t));
+    if (n < static_cast<ssize_t>(3 * sizeof(uint64_t)) || data[2] == 0)
+    {
+      // Group never got on the CPU, e.g. all counters are taken by others
+      return s;
+    }
+
+    uint64_t enabled = data[1], running = data[2];
+    for (uint64_t i = 0; i < data[0] && i < PC_COUNT; i++)
+    {
+      uint64_t value = data[3 + 2 * i], id = data[4 + 2 * i];
+      for (int c = 0; c < PC_COUNT; c++)
+      {
+        if (m_fds[c] != -1 && m_ids[c] == id)
+        {
+          s.m_counted[c] = true;
+          s.m_values[c] = running < enabled
+                        ? static_cast<uint64_t>(static_cast<double>(value) * enabled / running)
+                        : value;
+        }
+      }
+    }
+#endif
+    return s;
+  }
+
+  /// @return Name of counter, as printed in reports
+  const char* CPerfGroup::counterName(EPerfCounter c)
+  {
+    static const char* names[PC_COUNT] = {"cycles", "instructions", "cache misses", "branch misses"};
+    return names[c];
+  }
+}
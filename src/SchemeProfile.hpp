@@ -0,0 +1,71 @@
+/**
+ *		@file 		SchemeProfile.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Hardware performance counters of profiled phases
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  ///
+  /// Counted hardware events
+  ///
+  enum EPerfCounter
+  {
+    PC_CYCLES = 0,      /**< CPU cycles, leader of the group */
+    PC_INSTRUCTIONS,    /**< Retired instructions */
+    PC_CACHE_MISSES,    /**< Last level cache misses */
+    PC_BRANCH_MISSES,   /**< Mispredicted branches */
+    PC_COUNT
+  };
+
+  ///
+  /// Counters of one measured interval. Counters the CPU does not have, or
+  /// all of them if counting is not permitted, are not counted.
+  ///
+  struct PerfSample
+  {
+    uint64_t      m_wallNs = 0;
+    bool          m_counted[PC_COUNT] = {};
+    uint64_t      m_values[PC_COUNT] = {};  /**< Scaled up if counters were multiplexed */
+  };
+
+  ///
+  /// Group of counters started and stopped together by perf_event_open,
+  /// so the counters of one interval are comparable. Only the calling
+  /// thread in user space is counted. Where counters cannot be opened, the
+  /// group measures wall time only and getError tells why.
+  ///
+  class CPerfGroup
+  {
+  public:
+    CPerfGroup();
+    ~CPerfGroup();
+
+    CPerfGroup(const CPerfGroup&) = delete;
+    CPerfGroup& operator=(const CPerfGroup&) = delete;
+
+    bool          available() const;
+    const std::string& getError() const;
+
+    void          start();
+    PerfSample    stop();
+
+    static const char* counterName(EPerfCounter);
+
+  private:
+    int                       m_fds[PC_COUNT];  /**< Counters, -1 if not opened */
+    uint64_t                  m_ids[PC_COUNT];  /**< Kernel IDs, to match values read from group */
+    std::string               m_error;          /**< Why counters are not available */
+    std::chrono::steady_clock::time_point m_start;
+  };
+}
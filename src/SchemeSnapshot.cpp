@@ -0,0 +1,376 @@
+/**
+ *		@file 		SchemeSnapshot.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Immutable snapshot of scheme topology, evaluated without
+ *              touching the live scheme
+ */
+
+#include "SchemeSnapshot.hpp"
+
+#include "ArrayOperation.hpp"
+#include "BlockEditorException.hpp"
+#include "Error.hpp"
+#include "IntegerOperation.hpp"
+#include "SchemeTrace.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  /// Blocks evaluated between checks of cancel flag and progress reports
+  const size_t PROGRESS_STRIDE = 1024;
+
+  /**
+   * @brief Snapshot made of pages of nodes
+   * @param version Version of scheme
+   * @param pages Pages of nodes, shared with other snapshots
+   * @param stats Stats of the scheme, may be null
+   */
+  CSchemeSnapshot::CSchemeSnapshot(uint64_t version, std::vector<PagePtr> pages, StatsPtr stats)
+    : m_version{version}, m_pages{std::move(pages)}, m_stats{std::move(stats)}
+  {
+
+  }
+
+  /// @return Version of scheme the snapshot was taken at
+  uint64_t CSchemeSnapshot::getVersion() const
+  {
+    return m_version;
+  }
+
+  /// @return Stats evaluations of the snapshot are counted in, may be null
+  CSchemeStats* CSchemeSnapshot::getStats() const
+  {
+    return m_stats.get();
+  }
+
+  /// @return Count of slots, used and unused
+  size_t CSchemeSnapshot::getSlotCount() const
+  {
+    return m_pages.size() * PAGE_SIZE;
+  }
+
+  /// @return Pages of nodes, PAGE_SIZE slots each
+  const std::vector<CSchemeSnapshot::PagePtr>& CSchemeSnapshot::getPages() const
+  {
+    return m_pages;
+  }
+
+  /**
+   * @brief Snapshot of the same version with values of some input blocks
+   *        replaced. Pages with those blocks are copied, others are shared,
+   *        this snapshot stays as it is.
+   * @param values Slots of input blocks with their new values
+   * @return The new snapshot
+   */
+  SnapshotPtr CSchemeSnapshot::withValues(const std::vector<SlotValue>& values) const
+  {
+    std::vector<PagePtr> pages = m_pages;
+    std::vector<std::shared_ptr<Page>> copied(pages.size());
+
+    for (auto& it : values)
+    {
+      if (it.m_slot >= getSlotCount() || getNode(it.m_slot).m_bt != BT_INPUT || !getNode(it.m_slot).m_used)
+      {
+        throw CBlockEditorException("Slot doesnt hold input block", EErrorCode::E_INTERN);
+      }
+
+      size_t page = it.m_slot / PAGE_SIZE;
+      if (!copied[page])
+      {
+        copied[page] = std::make_shared<Page>(*m_pages[page]);
+        pages[page] = copied[page];
+      }
+      SnapshotNode& node = (*copied[page])[it.m_slot % PAGE_SIZE];
+      node.m_value = it.m_value;
+      node.m_array = it.m_array;
+    }
+
+    return std::make_shared<const CSchemeSnapshot>(m_version, std::move(pages), m_stats);
+  }
+
+  /// @return Node in slot
+  const SnapshotNode& CSchemeSnapshot::getNode(size_t slot) const
+  {
+    return (*m_pages[slot / PAGE_SIZE])[slot % PAGE_SIZE];
+  }
+
+  /**
+   * @brief Evaluates the snapshot in context of its own
+   * @param cancel Evaluation stops with E_CANCELLED once flag is set
+   * @param progress Called periodically from the evaluating thread
+   * @return Results of blocks in order they were computed
+   */
+  std::deque<CBlockAction> CSchemeSnapshot::run(const std::atomic<bool> *cancel,
+                                                const Progress& progress) const
+  {
+    CEvalContext ctx;
+    run(ctx, cancel, progress);
+    return ctx.takeActions();
+  }
+
+  /**
+   * @brief Evaluates the snapshot. Values of ports are kept in the
+   *        context, so any number of runs can go on at the same time, each
+   *        in its own context. Blocks are computed in topological order,
+   *        each one once.
+   * @param ctx Context of the run, results are left there
+   * @param cancel Evaluation stops with E_CANCELLED once flag is set
+   * @param progress Called periodically from the evaluating thread
+   */
+  void CSchemeSnapshot::run(CEvalContext& ctx, const std::atomic<bool> *cancel,
+                            const Progress& progress) const
+  {
+    TRACE_SPAN("run");
+    CStatTimer timer(m_stats.get(), ST_RUN);
+    COpMeter meter;
+    size_t n = getSlotCount();
+    ctx.reset(n, m_version);
+
+    std::deque<CBlockAction>& actions = ctx.m_actions;
+    std::vector<PortValue>& values = ctx.m_values;
+    std::vector<PortInt>& integers = ctx.m_integers;
+    std::vector<PortArrayPtr>& arrays = ctx.m_arrays;
+    std::vector<size_t>& consumer = ctx.m_consumer;       // port is shared by one producer and one consumer
+    std::vector<uint32_t>& waiting = ctx.m_waiting;       // inputs not computed yet
+    std::vector<size_t>& ready = ctx.m_ready;
+    std::vector<PortValue>& operands = ctx.m_operands;
+    std::vector<PortInt>& intOperands = ctx.m_intOperands;
+    std::vector<ReduceOperand>& arrayOperands = ctx.m_arrayOperands;
+    MacroScratch&             macro = ctx.m_macro;
+    size_t                    blocks = 0;
+    CMemoryCounter            results;            // arrays computed by this run
+    uint64_t                  resultBytes = 0;
+
+    // INT & HEX blocks compute in integers, other producers (input blocks) have value only
+    auto integer = [this, &values, &integers](size_t in) {
+      return getNode(in).m_integral ? integers[in] : toInteger(values[in]);
+    };
+
+    // Blocks waiting for inputs, inputs are ready right away
+    {
+      TRACE_SPAN("run: discover");
+      for (size_t i = 0; i < n; i++)
+      {
+        const SnapshotNode& node = getNode(i);
+        if (!node.m_used)
+        {
+          continue;
+        }
+        blocks++;
+
+        if (node.m_bt == BT_INPUT)
+        {
+          values[i] = node.m_value;
+          arrays[i] = node.m_array;
+          ready.push_back(i);
+          continue;
+        }
+
+        size_t count = node.getInputCount();
+        for (size_t k = 0; k < count; k++)
+        {
+          size_t in = node.getInput(k);
+          if (in == NO_SLOT)
+          {
+            throw CBlockEditorException(
+              "Input value missing for some blocks. Make sure all input ports are either connected or have a value assigned.",
+               EErrorCode::E_UI_NOT_CON);
+          }
+          consumer[in] = i;
+        }
+        waiting[i] = count;
+
+        // Macro may compute from constants only
+        if (count == 0)
+        {
+          ready.push_back(i);
+        }
+      }
+    }
+
+    // Inputs first, then blocks as their inputs get computed
+    TRACE_SPAN("run: evaluate");
+    for (size_t next = 0; next < ready.size(); next++)
+    {
+      if (next % PROGRESS_STRIDE == 0)
+      {
+        if (cancel && cancel->load(std::memory_order_relaxed))
+        {
+          meter.flush(m_stats.get(), false);
+          throw CBlockEditorException("Computation was cancelled", EErrorCode::E_CANCELLED);
+        }
+        if (progress)
+        {
+          progress(next, blocks);
+        }
+      }
+
+      size_t i = ready[next];
+      const SnapshotNode& node = getNode(i);
+
+      if (node.m_bt == BT_MACRO)
+      {
+        // Inputs of instance are inputs of the compiled body
+        bool array = false;
+        macro.m_params.resize(node.getInputCount());
+        for (size_t k = 0; k < node.getInputCount(); k++)
+        {
+          size_t in = node.getInput(k);
+          MacroValue& param = macro.m_params[k];
+          param.m_value = values[in];
+          param.m_array = arrays[in];
+          param.m_integer = node.m_integral && !arrays[in] ? integer(in) : 0;
+          array = array || arrays[in];
+        }
+        bool timed = meter.timed(array);
+        auto start = timed ? COpMeter::Clock::now() : COpMeter::Clock::time_point();
+
+        MacroValue result;
+        node.m_macro->evaluate(macro, result);
+        if (array)
+        {
+          for (auto& it : macro.m_params)
+          {
+            it.m_array.reset();
+          }
+        }
+
+        if (result.m_array)
+        {
+          arrays[i] = std::move(result.m_array);
+          actions.push_back(CBlockAction{node.m_blockID, arrays[i]});
+          resultBytes += results.arrayBytes(arrays[i]);
+        }
+        else if (node.m_integral)
+        {
+          integers[i] = result.m_integer;
+          values[i] = result.m_value;
+          actions.push_back(CBlockAction{node.m_blockID, result.m_integer});
+        }
+        else
+        {
+          values[i] = result.m_value;
+          actions.push_back(CBlockAction{node.m_blockID, result.m_value});
+        }
+
+        meter.count(node.m_bt, array, timed ? COpMeter::Clock::now() - start : COpMeter::Clock::duration::zero());
+      }
+      else if (node.m_bt != BT_INPUT)
+      {
+        size_t in1 = node.m_input1, in2 = node.m_input2;
+
+        bool array = arrays[in1] || arrays[in2];
+        for (size_t k = 0; k < node.m_more.size() && !array; k++)
+        {
+          array = arrays[node.m_more[k]] != nullptr;
+        }
+        bool timed = meter.timed(array);
+        auto start = timed ? COpMeter::Clock::now() : COpMeter::Clock::time_point();
+
+        // Vector-valued ports, operation is performed element-wise
+        if (array)
+        {
+          if (isReduction(node.m_bt))
+          {
+            arrayOperands.clear();
+            for (size_t k = 0; k < node.getInputCount(); k++)
+            {
+              size_t in = node.getInput(k);
+              arrayOperands.push_back(ReduceOperand{arrays[in].get(), values[in],
+                                                    node.m_integral && !arrays[in] ? integer(in) : 0});
+            }
+            arrays[i] = node.m_integral ? performIntegerArrayReduction(node.m_bt, arrayOperands)
+                                        : performArrayReduction(node.m_bt, arrayOperands, node.m_mode);
+          }
+          else if (node.m_integral)
+          {
+            arrays[i] = performIntegerArrayOperation(node.m_bt, arrays[in1], arrays[in1] ? 0 : integer(in1),
+                                                     arrays[in2], arrays[in2] ? 0 : integer(in2));
+          }
+          else
+          {
+            arrays[i] = performArrayOperation(node.m_bt, arrays[in1], values[in1],
+                                              arrays[in2], values[in2]);
+          }
+          actions.push_back(CBlockAction{node.m_blockID, arrays[i]});
+          resultBytes += results.arrayBytes(arrays[i]);
+        }
+        else if (node.m_integral)
+        {
+          PortInt pi;
+          if (isReduction(node.m_bt))
+          {
+            intOperands.clear();
+            for (size_t k = 0; k < node.getInputCount(); k++)
+            {
+              intOperands.push_back(integer(node.getInput(k)));
+            }
+            pi = performIntegerReduction(node.m_bt, intOperands.data(), intOperands.size());
+          }
+          else
+          {
+            pi = performIntegerOperation(node.m_bt, integer(in1), integer(in2));
+          }
+          integers[i] = pi;
+          values[i] = static_cast<PortValue>(pi);
+          actions.push_back(CBlockAction{node.m_blockID, pi});
+        }
+        else
+        {
+          PortValue pv;
+          if (isReduction(node.m_bt))
+          {
+            operands.clear();
+            for (size_t k = 0; k < node.getInputCount(); k++)
+            {
+              operands.push_back(values[node.getInput(k)]);
+            }
+            pv = performScalarReduction(node.m_bt, operands.data(), operands.size(), node.m_mode);
+          }
+          else
+          {
+            pv = performScalarOperation(node.m_bt, values[in1], values[in2]);
+          }
+          values[i] = pv;
+          actions.push_back(CBlockAction{node.m_blockID, pv});
+        }
+
+        meter.count(node.m_bt, array, timed ? COpMeter::Clock::now() - start : COpMeter::Clock::duration::zero());
+      }
+
+      size_t c = consumer[i];
+      if (c != NO_SLOT && --waiting[c] == 0)
+      {
+        ready.push_back(c);
+      }
+    }
+
+    // Blocks waiting for each other were never computed
+    if (ready.size() != blocks)
+    {
+      meter.flush(m_stats.get(), false);
+      throw CBlockEditorException("Detected cycle in the scheme", EErrorCode::E_UI_CYCLE);
+    }
+    meter.flush(m_stats.get(), true);
+    if (progress)
+    {
+      progress(blocks, blocks);
+    }
+
+    // Buffers only grow, all of them are at their largest now
+    if (m_stats)
+    {
+      m_stats->peak(SP_RUN_BYTES, resultBytes + CMemoryCounter::dequeBytes(actions)
+                    + CMemoryCounter::vectorBytes(values) + CMemoryCounter::vectorBytes(integers)
+                    + CMemoryCounter::vectorBytes(arrays)
+                    + CMemoryCounter::vectorBytes(consumer) + CMemoryCounter::vectorBytes(waiting)
+                    + CMemoryCounter::vectorBytes(ready) + CMemoryCounter::vectorBytes(operands)
+                    + CMemoryCounter::vectorBytes(intOperands)
+                    + CMemoryCounter::vectorBytes(arrayOperands)
+                    + CMemoryCounter::vectorBytes(macro.m_params) + CMemoryCounter::vectorBytes(macro.m_steps));
+    }
+  }
+}
@@ -0,0 +1,125 @@
+/**
+ *		@file 		SchemeSnapshot.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Immutable snapshot of scheme topology, evaluated without
+ *              touching the live scheme
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "BlockAction.hpp"
+#include "BlockType.hpp"
+#include "EvalContext.hpp"
+#include "MacroDefinition.hpp"
+#include "Port.hpp"
+#include "SchemeStats.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  /// Slot without block, or input port without producer
+  const size_t NO_SLOT = static_cast<size_t>(-1);
+
+  ///
+  /// Block as seen by evaluation. Every block of the scheme keeps its slot
+  /// while it exists, inputs refer to the producing blocks by slot.
+  ///
+  struct SnapshotNode
+  {
+    bool          m_used = false;       /**< Slot holds a block */
+    ID            m_blockID = 0;
+    EBlockType    m_bt = BT_INPUT;
+    bool          m_integral = false;   /**< Results are truncated (INT & HEX) */
+    size_t        m_input1 = NO_SLOT;   /**< Slot of block connected to input 1 */
+    size_t        m_input2 = NO_SLOT;   /**< Slot of block connected to input 2 */
+    std::vector<size_t> m_more;         /**< Slots of inputs past the second, reductions only */
+    EReduceMode   m_mode = RM_PLAIN;    /**< Order of summation of SUM block */
+    bool          m_connected = false;  /**< Output is connected to other block */
+    PortValue     m_value = .0;         /**< Value of input block */
+    PortArrayPtr  m_array;              /**< Values of input block, if it has array */
+    MacroPtr      m_macro;              /**< Definition of macro block */
+
+    /// @return Count of inputs, 0 for input block
+    size_t        getInputCount() const
+    {
+      return m_bt == BT_INPUT ? 0 : m_macro ? m_macro->getInputCount() : 2 + m_more.size();
+    }
+
+    /// @return Slot of block connected to input k, from 0
+    size_t        getInput(size_t k) const
+    {
+      return k == 0 ? m_input1 : k == 1 ? m_input2 : m_more[k - 2];
+    }
+  };
+
+  ///
+  /// Value replacing the one assigned to input port, see
+  /// CBlockScheme::withInputs
+  ///
+  struct InputValue
+  {
+    ID            m_blockID = 0;
+    Ports         m_port = Ports::P_INPUT1;
+    PortValue     m_value = .0;
+  };
+
+  ///
+  /// Value replacing the one of input block in slot
+  ///
+  struct SlotValue
+  {
+    size_t        m_slot = NO_SLOT;
+    PortValue     m_value = .0;
+    PortArrayPtr  m_array;            /**< Values, if it is array */
+  };
+
+  ///
+  /// Snapshot of the scheme at one version. Nodes are stored in fixed size
+  /// pages shared by consecutive snapshots, edit of the scheme makes only
+  /// the pages of edited blocks to be built again. Snapshot is never
+  /// changed after it was published, so it can be evaluated on any thread
+  /// while the scheme is edited.
+  ///
+  class CSchemeSnapshot
+  {
+  public:
+    static const size_t PAGE_SIZE = 256;
+
+    using Page    = std::vector<SnapshotNode>;
+    using PagePtr = std::shared_ptr<const Page>;
+
+    /// Called with count of evaluated blocks and count of all blocks
+    using Progress = std::function<void(size_t, size_t)>;
+
+    CSchemeSnapshot(uint64_t version, std::vector<PagePtr> pages, StatsPtr stats = nullptr);
+
+    uint64_t      getVersion() const;
+    CSchemeStats* getStats() const;
+    size_t        getSlotCount() const;
+    const SnapshotNode& getNode(size_t slot) const;
+
+    std::deque<CBlockAction> run(const std::atomic<bool> *cancel = nullptr,
+                                 const Progress& progress = Progress()) const;
+    void          run(CEvalContext& ctx, const std::atomic<bool> *cancel = nullptr,
+                      const Progress& progress = Progress()) const;
+    const std::vector<PagePtr>& getPages() const;
+    std::shared_ptr<const CSchemeSnapshot> withValues(const std::vector<SlotValue>&) const;
+
+  private:
+    uint64_t                  m_version;    /**< Version of scheme the snapshot was taken at */
+    std::vector<PagePtr>      m_pages;      /**< Pages of nodes, PAGE_SIZE slots each */
+    StatsPtr                  m_stats;      /**< Stats of the scheme, evaluations are counted there */
+  };
+
+  using SnapshotPtr = std::shared_ptr<const CSchemeSnapshot>;
+}
@@ -0,0 +1,308 @@
+/**
+ *		@file 		SchemeStats.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Counters and timers of scheme phases, always on
+ */
+
+#include "SchemeStats.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+#include "BlockEditorException.hpp"
+#include "Error.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  /// Names of counters in exported stats, with help texts
+  static const char *COUNTER_NAMES[SC_COUNT][2] = {
+    {"load_blocks_total",     "Blocks read from scheme files"},
+    {"save_bytes_total",      "Bytes of scheme files written"},
+    {"run_passes_total",      "Evaluations which computed all blocks"},
+    {"run_blocks_total",      "Blocks computed"},
+    {"snapshot_pages_total",  "Snapshot pages built again"},
+    {"index_lookups_total",   "Lookups in hash indexes of the scheme"},
+    {"scan_lookups_total",    "Blocks searched by ID by scanning the scheme"},
+    {"scan_steps_total",      "Blocks visited by scans"},
+  };
+
+  /// Names of phases in exported stats
+  static const char *TIMER_NAMES[ST_COUNT] = {
+    "load", "load_parse", "get_parts", "snapshot", "run", "save"
+  };
+
+  /// Names of block types in exported stats
+  static const char *OP_NAMES[OP_TYPES] = {
+    "input", "add", "sub", "mul", "div", "pow", "sum", "product", "min", "max", "macro"
+  };
+
+  /**
+   * @brief Stats with all counters zero
+   */
+  CSchemeStats::CSchemeStats()
+  {
+    reset();
+  }
+
+  /**
+   * @brief Adds to counter
+   */
+  void CSchemeStats::add(EStatCounter counter, uint64_t n)
+  {
+    m_counters[counter].fetch_add(n, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Adds time spent in phase
+   * @param timer The phase
+   * @param ns Nanoseconds spent in it
+   */
+  void CSchemeStats::addTime(EStatTimer timer, uint64_t ns)
+  {
+    m_timerCount[timer].fetch_add(1, std::memory_order_relaxed);
+    m_timerTotal[timer].fetch_add(ns, std::memory_order_relaxed);
+
+    uint64_t max = m_timerMax[timer].load(std::memory_order_relaxed);
+    while (ns > max && !m_timerMax[timer].compare_exchange_weak(max, ns, std::memory_order_relaxed))
+    {
+    }
+  }
+
+  /**
+   * @brief Adds computed blocks of one type
+   * @param bt Type of the blocks
+   * @param blocks Count of the blocks
+   * @param ns Estimated time of their operations
+   */
+  void CSchemeStats::addOps(EBlockType bt, uint64_t blocks, uint64_t ns)
+  {
+    m_opBlocks[bt].fetch_add(blocks, std::memory_order_relaxed);
+    m_opNs[bt].fetch_add(ns, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Raises peak to value, if value is higher
+   */
+  void CSchemeStats::peak(EStatPeak which, uint64_t value)
+  {
+    uint64_t max = m_peaks[which].load(std::memory_order_relaxed);
+    while (value > max && !m_peaks[which].compare_exchange_weak(max, value, std::memory_order_relaxed))
+    {
+    }
+  }
+
+  /**
+   * @brief Reads all counters. Counters are read one by one, updates made
+   *        meanwhile may be seen only by some of them.
+   */
+  SchemeStats CSchemeStats::get() const
+  {
+    SchemeStats s;
+
+    for (size_t i = 0; i < SC_COUNT; i++)
+    {
+      s.m_counters[i] = m_counters[i].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < ST_COUNT; i++)
+    {
+      s.m_timers[i].m_count = m_timerCount[i].load(std::memory_order_relaxed);
+      s.m_timers[i].m_totalNs = m_timerTotal[i].load(std::memory_order_relaxed);
+      s.m_timers[i].m_maxNs = m_timerMax[i].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < OP_TYPES; i++)
+    {
+      s.m_ops[i].m_blocks = m_opBlocks[i].load(std::memory_order_relaxed);
+      s.m_ops[i].m_estimatedNs = m_opNs[i].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < SP_COUNT; i++)
+    {
+      s.m_peaks[i] = m_peaks[i].load(std::memory_order_relaxed);
+    }
+
+    return s;
+  }
+
+  /**
+   * @brief Sets all counters to zero
+   */
+  void CSchemeStats::reset()
+  {
+    for (auto& it : m_counters)   it.store(0, std::memory_order_relaxed);
+    for (auto& it : m_timerCount) it.store(0, std::memory_order_relaxed);
+    for (auto& it : m_timerTotal) it.store(0, std::memory_order_relaxed);
+    for (auto& it : m_timerMax)   it.store(0, std::memory_order_relaxed);
+    for (auto& it : m_opBlocks)   it.store(0, std::memory_order_relaxed);
+    for (auto& it : m_opNs)       it.store(0, std::memory_order_relaxed);
+    for (auto& it : m_peaks)      it.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Writes stats in Prometheus text format. File is written next to
+   *        the target and renamed over it, so it is never read half written.
+   * @param s Stats to write
+   * @param m Memory of the scheme, peaks are taken from the stats
+   * @param fileName Target file
+   */
+  void CSchemeStats::writePrometheus(const SchemeStats& s, const SchemeMemory& m, const std::string& fileName)
+  {
+    std::string tmp = fileName + ".tmp";
+    {
+      std::ofstream os(tmp);
+      if (!os.is_open())
+      {
+        throw CBlockEditorException("Could not write stats to " + fileName, EErrorCode::E_UI_BAD_FILE);
+      }
+
+      for (size_t i = 0; i < SC_COUNT; i++)
+      {
+        os << "# HELP blockeditor_" << COUNTER_NAMES[i][0] << " " << COUNTER_NAMES[i][1] << "\n"
+           << "# TYPE blockeditor_" << COUNTER_NAMES[i][0] << " counter\n"
+           << "blockeditor_" << COUNTER_NAMES[i][0] << " " << s.m_counters[i] << "\n";
+      }
+
+      os << "# HELP blockeditor_phase_calls_total Times the phase was entered\n"
+         << "# TYPE blockeditor_phase_calls_total counter\n";
+      for (size_t i = 0; i < ST_COUNT; i++)
+      {
+        os << "blockeditor_phase_calls_total{phase=\"" << TIMER_NAMES[i] << "\"} " << s.m_timers[i].m_count << "\n";
+      }
+      os << "# HELP blockeditor_phase_seconds_total Time spent in the phase\n"
+         << "# TYPE blockeditor_phase_seconds_total counter\n";
+      for (size_t i = 0; i < ST_COUNT; i++)
+      {
+        os << "blockeditor_phase_seconds_total{phase=\"" << TIMER_NAMES[i] << "\"} " << s.m_timers[i].m_totalNs / 1e9 << "\n";
+      }
+      os << "# HELP blockeditor_phase_max_seconds Longest time spent in the phase at once\n"
+         << "# TYPE blockeditor_phase_max_seconds gauge\n";
+      for (size_t i = 0; i < ST_COUNT; i++)
+      {
+        os << "blockeditor_phase_max_seconds{phase=\"" << TIMER_NAMES[i] << "\"} " << s.m_timers[i].m_maxNs / 1e9 << "\n";
+      }
+
+      os << "# HELP blockeditor_op_blocks_total Blocks computed by operation\n"
+         << "# TYPE blockeditor_op_blocks_total counter\n";
+      for (size_t i = BT_ADD; i < OP_TYPES; i++)
+      {
+        os << "blockeditor_op_blocks_total{op=\"" << OP_NAMES[i] << "\"} " << s.m_ops[i].m_blocks << "\n";
+      }
+      os << "# HELP blockeditor_op_seconds_total Time of operations, scalar ones estimated from samples\n"
+         << "# TYPE blockeditor_op_seconds_total counter\n";
+      for (size_t i = BT_ADD; i < OP_TYPES; i++)
+      {
+        os << "blockeditor_op_seconds_total{op=\"" << OP_NAMES[i] << "\"} " << s.m_ops[i].m_estimatedNs / 1e9 << "\n";
+      }
+
+      os << "# HELP blockeditor_memory_bytes Memory of the scheme by part\n"
+         << "# TYPE blockeditor_memory_bytes gauge\n";
+      for (size_t i = 0; i < MP_COUNT; i++)
+      {
+        os << "blockeditor_memory_bytes{part=\"" << memoryPartName(static_cast<EMemoryPart>(i)) << "\"} " << m.m_bytes[i] << "\n";
+      }
+      os << "# HELP blockeditor_memory_blocks Blocks of the scheme, input blocks included\n"
+         << "# TYPE blockeditor_memory_blocks gauge\n"
+         << "blockeditor_memory_blocks " << m.m_blocks << "\n";
+      os << "# HELP blockeditor_peak_bytes Highest memory during the phase\n"
+         << "# TYPE blockeditor_peak_bytes gauge\n"
+         << "blockeditor_peak_bytes{phase=\"load\"} " << s.m_peaks[SP_LOAD_BYTES] << "\n"
+         << "blockeditor_peak_bytes{phase=\"run\"} " << s.m_peaks[SP_RUN_BYTES] << "\n";
+
+      if (!os.flush())
+      {
+        throw CBlockEditorException("Could not write stats to " + fileName, EErrorCode::E_UI_BAD_FILE);
+      }
+    }
+
+    if (std::rename(tmp.c_str(), fileName.c_str()) != 0)
+    {
+      throw CBlockEditorException("Could not write stats to " + fileName, EErrorCode::E_UI_BAD_FILE);
+    }
+  }
+
+  /**
+   * @brief Starts timing phase
+   * @param stats Stats to add the time to, nothing is timed if null
+   * @param timer The phase
+   */
+  CStatTimer::CStatTimer(CSchemeStats *stats, EStatTimer timer)
+    : m_stats{stats}, m_timer{timer}
+  {
+    if (m_stats)
+    {
+      m_start = std::chrono::steady_clock::now();
+    }
+  }
+
+  /**
+   * @brief Adds time since construction to the stats
+   */
+  CStatTimer::~CStatTimer()
+  {
+    if (m_stats)
+    {
+      auto d = std::chrono::steady_clock::now() - m_start;
+      m_stats->addTime(m_timer, std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+    }
+  }
+
+  /**
+   * @brief Counts computed block
+   * @param bt Type of the block
+   * @param array True if the operation was performed on arrays
+   * @param d Time of the operation if it was timed, zero otherwise
+   */
+  void COpMeter::count(EBlockType bt, bool array, Clock::duration d)
+  {
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+    if (array)
+    {
+      m_arrayNs[bt] += ns;
+    }
+    else
+    {
+      m_scalars[bt]++;
+      if (timed(false))
+      {
+        m_sampled[bt]++;
+        m_sampledNs[bt] += ns;
+      }
+    }
+    m_blocks[bt]++;
+    m_computed++;
+  }
+
+  /**
+   * @brief Adds counted operations to the stats and starts counting again
+   * @param stats Stats, nothing is added if null
+   * @param pass True if all blocks of the scheme were computed
+   */
+  void COpMeter::flush(CSchemeStats *stats, bool pass)
+  {
+    if (stats)
+    {
+      for (size_t i = 0; i < OP_TYPES; i++)
+      {
+        if (m_blocks[i])
+        {
+          // Scalar operations take time of the sampled ones on average
+          uint64_t ns = m_arrayNs[i];
+          if (m_sampled[i])
+          {
+            ns += static_cast<uint64_t>(static_cast<double>(m_sampledNs[i]) / m_sampled[i] * m_scalars[i]);
+          }
+          stats->addOps(static_cast<EBlockType>(i), m_blocks[i], ns);
+        }
+      }
+      stats->add(SC_RUN_BLOCKS, m_computed);
+      if (pass)
+      {
+        stats->add(SC_RUN_PASSES);
+      }
+    }
+
+    *this = COpMeter();
+  }
+}
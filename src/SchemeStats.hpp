@@ -0,0 +1,167 @@
+/**
+ *		@file 		SchemeStats.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Counters and timers of scheme phases, always on
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "BlockType.hpp"
+#include "SchemeMemory.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  ///
+  /// Counted events
+  ///
+  enum EStatCounter
+  {
+    SC_LOAD_BLOCKS = 0, /**< Blocks read from scheme files */
+    SC_SAVE_BYTES,      /**< Bytes of scheme files written */
+    SC_RUN_PASSES,      /**< Evaluations which computed all blocks */
+    SC_RUN_BLOCKS,      /**< Blocks computed, input blocks excluded */
+    SC_SNAPSHOT_PAGES,  /**< Snapshot pages built again */
+    SC_INDEX_LOOKUPS,   /**< Lookups of slots and port owners in hash indexes */
+    SC_SCAN_LOOKUPS,    /**< Blocks searched by ID by scanning the scheme */
+    SC_SCAN_STEPS,      /**< Blocks visited by those scans */
+    SC_COUNT
+  };
+
+  ///
+  /// Timed phases
+  ///
+  enum EStatTimer
+  {
+    ST_LOAD = 0,        /**< openScheme, parse and journal replay included */
+    ST_LOAD_PARSE,      /**< Parsing of scheme file */
+    ST_GET_PARTS,       /**< getParts */
+    ST_SNAPSHOT,        /**< Building snapshot of the scheme */
+    ST_RUN,             /**< Evaluation of snapshot */
+    ST_SAVE,            /**< Writing scheme file or committing journal */
+    ST_COUNT
+  };
+
+  ///
+  /// Highest values seen
+  ///
+  enum EStatPeak
+  {
+    SP_LOAD_BYTES = 0,  /**< Memory of scheme and parsed records during load */
+    SP_RUN_BYTES,       /**< Memory of buffers and results of one run */
+    SP_COUNT
+  };
+
+  /// Count of block types, operations are counted by type
+  const size_t OP_TYPES = BT_MACRO + 1;
+
+  ///
+  /// Time spent in phase
+  ///
+  struct TimerStats
+  {
+    uint64_t      m_count = 0;        /**< Times the phase was entered */
+    uint64_t      m_totalNs = 0;
+    uint64_t      m_maxNs = 0;
+  };
+
+  ///
+  /// Operations of one block type
+  ///
+  struct OpStats
+  {
+    uint64_t      m_blocks = 0;       /**< Blocks computed */
+    uint64_t      m_estimatedNs = 0;  /**< Time, estimated from sampled scalar operations */
+  };
+
+  ///
+  /// Values of all counters at one moment
+  ///
+  struct SchemeStats
+  {
+    uint64_t      m_counters[SC_COUNT] = {};
+    TimerStats    m_timers[ST_COUNT];
+    OpStats       m_ops[OP_TYPES];
+    uint64_t      m_peaks[SP_COUNT] = {};
+  };
+
+  ///
+  /// Counters of one scheme. Updates are relaxed atomic additions, so the
+  /// stats are updated from evaluating threads and read at any time.
+  ///
+  class CSchemeStats
+  {
+  public:
+    /// Every n-th scalar operation is timed, array operations always
+    static const uint64_t OP_SAMPLE = 64;
+
+    CSchemeStats();
+
+    void          add(EStatCounter, uint64_t n = 1);
+    void          addTime(EStatTimer, uint64_t ns);
+    void          addOps(EBlockType, uint64_t blocks, uint64_t ns);
+    void          peak(EStatPeak, uint64_t value);
+
+    SchemeStats   get() const;
+    void          reset();
+
+    static void   writePrometheus(const SchemeStats&, const SchemeMemory&, const std::string&);
+
+  private:
+    std::atomic<uint64_t>     m_counters[SC_COUNT];
+    std::atomic<uint64_t>     m_timerCount[ST_COUNT];
+    std::atomic<uint64_t>     m_timerTotal[ST_COUNT];
+    std::atomic<uint64_t>     m_timerMax[ST_COUNT];
+    std::atomic<uint64_t>     m_opBlocks[OP_TYPES];
+    std::atomic<uint64_t>     m_opNs[OP_TYPES];
+    std::atomic<uint64_t>     m_peaks[SP_COUNT];
+  };
+
+  using StatsPtr = std::shared_ptr<CSchemeStats>;
+
+  ///
+  /// Times phase from construction to destruction, on monotonic clock
+  ///
+  class CStatTimer
+  {
+  public:
+    CStatTimer(CSchemeStats *stats, EStatTimer timer);
+    ~CStatTimer();
+
+  private:
+    CSchemeStats             *m_stats;
+    EStatTimer                m_timer;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+  ///
+  /// Operations counted by one evaluation, added to the stats at once
+  ///
+  class COpMeter
+  {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /// @return True if operation computed next should be timed
+    bool          timed(bool array) const { return array || m_computed % CSchemeStats::OP_SAMPLE == 0; }
+    void          count(EBlockType, bool array, Clock::duration);
+    void          flush(CSchemeStats *stats, bool pass);
+
+  private:
+    uint64_t      m_computed = 0;
+    uint64_t      m_blocks[OP_TYPES] = {};
+    uint64_t      m_arrayNs[OP_TYPES] = {};       /**< Time of all array operations */
+    uint64_t      m_scalars[OP_TYPES] = {};       /**< Count of scalar operations */
+    uint64_t      m_sampled[OP_TYPES] = {};       /**< Count of timed scalar operations */
+    uint64_t      m_sampledNs[OP_TYPES] = {};     /**< Time of timed scalar operations */
+  };
+}
@@ -0,0 +1,158 @@
+/**
+ *		@file 		SchemeTrace.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Spans of work written as Chrome trace events, viewed in
+ *              chrome://tracing or Perfetto
+ */
+
+#include "SchemeTrace.hpp"
+
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+#include "BlockEditorException.hpp"
+#include "Error.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  std::atomic<bool> CTracer::s_enabled{false};
+
+  ///
+  /// Recorded span or name of thread
+  ///
+  struct TraceEvent
+  {
+    const char   *m_name;
+    unsigned      m_thread;
+    int64_t       m_begin;      /**< Microseconds since start of the trace, -1 for thread name */
+    int64_t       m_duration;
+  };
+
+  /// Trace being recorded, guarded by its mutex
+  static struct
+  {
+    std::mutex                m_mutex;
+    std::string               m_fileName;
+    CTracer::Clock::time_point m_start;
+    std::vector<TraceEvent>   m_events;
+  } s_trace;
+
+  /**
+   * @return Small number identifying the calling thread in the trace
+   */
+  static unsigned threadNumber()
+  {
+    static std::atomic<unsigned> next{1};
+    thread_local unsigned number = next.fetch_add(1);
+    return number;
+  }
+
+  /**
+   * @brief Starts recording spans, previous recording is dropped
+   * @param fileName File stop() writes the trace to
+   */
+  void CTracer::start(const std::string& fileName)
+  {
+#ifndef BLOCKEDITOR_TRACE
+    throw CBlockEditorException("Tracing is not built in, build with TRACE=1", EErrorCode::E_INTERN);
+#endif
+    std::lock_guard<std::mutex> lock(s_trace.m_mutex);
+    s_trace.m_fileName = fileName;
+    s_trace.m_start = Clock::now();
+    s_trace.m_events.clear();
+    s_trace.m_events.push_back(TraceEvent{"main", threadNumber(), -1, 0});
+    s_enabled = true;
+  }
+
+  /**
+   * @brief Stops recording and writes the trace. Spans still open are not
+   *        in the trace.
+   */
+  void CTracer::stop()
+  {
+    std::vector<TraceEvent> events;
+    std::string fileName;
+    {
+      std::lock_guard<std::mutex> lock(s_trace.m_mutex);
+      if (!s_enabled)
+      {
+        return;
+      }
+      s_enabled = false;
+      events.swap(s_trace.m_events);
+      fileName = s_trace.m_fileName;
+    }
+
+    std::ofstream os(fileName);
+    if (!os.is_open())
+    {
+      throw CBlockEditorException("Could not write trace to " + fileName, EErrorCode::E_UI_BAD_FILE);
+    }
+
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (size_t i = 0; i < events.size(); i++)
+    {
+      const TraceEvent& e = events[i];
+      if (e.m_begin < 0)
+      {
+        os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << e.m_thread
+           << ",\"args\":{\"name\":\"" << e.m_name << "\"}}";
+      }
+      else
+      {
+        os << "{\"name\":\"" << e.m_name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.m_thread
+           << ",\"ts\":" << e.m_begin << ",\"dur\":" << e.m_duration << "}";
+      }
+      os << (i + 1 < events.size() ? ",\n" : "\n");
+    }
+    os << "]}\n";
+
+    if (!os.flush())
+    {
+      throw CBlockEditorException("Could not write trace to " + fileName, EErrorCode::E_UI_BAD_FILE);
+    }
+  }
+
+  /**
+   * @brief Adds span of the calling thread
+   * @param name Name of the span, must live until stop()
+   * @param begin Start of the span
+   * @param end End of the span
+   */
+  void CTracer::record(const char *name, Clock::time_point begin, Clock::time_point end)
+  {
+    unsigned thread = threadNumber();
+    std::lock_guard<std::mutex> lock(s_trace.m_mutex);
+    if (!s_enabled)
+    {
+      return;
+    }
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    s_trace.m_events.push_back(TraceEvent{name, thread,
+          duration_cast<microseconds>(begin - s_trace.m_start).count(),
+          duration_cast<microseconds>(end - begin).count()});
+  }
+
+  /**
+   * @brief Names the calling thread in the trace
+   * @param name Name of the thread, must live until stop()
+   */
+  void CTracer::nameThread(const char *name)
+  {
+    if (!enabled())
+    {
+      return;
+    }
+
+    unsigned thread = threadNumber();
+    std::lock_guard<std::mutex> lock(s_trace.m_mutex);
+    s_trace.m_events.push_back(TraceEvent{name, thread, -1, 0});
+  }
+}
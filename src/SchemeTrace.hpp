@@ -0,0 +1,89 @@
+/**
+ *		@file 		SchemeTrace.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Spans of work written as Chrome trace events, viewed in
+ *              chrome://tracing or Perfetto
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+///
+/// Spans are recorded only if built with BLOCKEDITOR_TRACE (make TRACE=1),
+/// otherwise the macros expand to nothing. Built in, recording costs one
+/// relaxed load per span until CTracer::start is called.
+///
+#ifdef BLOCKEDITOR_TRACE
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+/// Records span from here to the end of the scope, name must be a literal
+#define TRACE_SPAN(name) BlockEditorLogic::CTraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name)
+/// Names the current thread in the trace, name must be a literal
+#define TRACE_THREAD(name) BlockEditorLogic::CTracer::nameThread(name)
+#else
+#define TRACE_SPAN(name) do {} while (0)
+#define TRACE_THREAD(name) do {} while (0)
+#endif
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  ///
+  /// Collects spans of all threads from start() to stop(), which writes
+  /// them to the file as complete events
+  ///
+  class CTracer
+  {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    static void   start(const std::string&);
+    static void   stop();
+
+    /// @return True if spans are being recorded
+    static bool   enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    static void   record(const char*, Clock::time_point, Clock::time_point);
+    static void   nameThread(const char*);
+
+  private:
+    static std::atomic<bool>  s_enabled;
+  };
+
+  ///
+  /// Span from construction to destruction, see TRACE_SPAN
+  ///
+  class CTraceSpan
+  {
+  public:
+    explicit CTraceSpan(const char *name)
+      : m_name{CTracer::enabled() ? name : nullptr}
+    {
+      if (m_name)
+      {
+        m_begin = CTracer::Clock::now();
+      }
+    }
+
+    ~CTraceSpan()
+    {
+      if (m_name)
+      {
+        CTracer::record(m_name, m_begin, CTracer::Clock::now());
+      }
+    }
+
+    CTraceSpan(const CTraceSpan&) = delete;
+    CTraceSpan& operator=(const CTraceSpan&) = delete;
+
+  private:
+    const char               *m_name;
+    CTracer::Clock::time_point m_begin;
+  };
+}
@@ -0,0 +1,377 @@
+/**
+ *		@file 		StreamEngine.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Streaming dataflow mode, pushes input samples through
+ *              scheme continuously in chunks
+ */
+
+#include <thread>
+#include <limits>
+#include <exception>
+
+#include "StreamEngine.hpp"
+#include "SchemeTrace.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  /**
+   * @brief Constructor of streaming engine
+   * @param scheme Scheme to evaluate, must not be modified while streaming
+   * @param chunkSize Count of samples read from each input at once
+   * @param queueDepth Max count of chunks waiting between reading, evaluation and writing
+   */
+  CStreamEngine::CStreamEngine(CBlockScheme& scheme, std::size_t chunkSize, std::size_t queueDepth)
+    : m_scheme(scheme)
+    , m_chunkSize{chunkSize ? chunkSize : 1}
+    , m_chunks{queueDepth}
+    , m_results{queueDepth}
+  {
+
+  }
+
+  /**
+   * @brief Feeds input port of block from stream. Port has to be free
+   *        (neither connected nor with value assigned)
+   * @param blockID ID of block
+   * @param whichPort Which of input ports
+   * @param is Stream with samples
+   * @param format Encoding of samples
+   */
+  void CStreamEngine::bindInput(ID blockID, Ports whichPort, std::istream& is, EStreamFormat format)
+  {
+    if (whichPort == Ports::P_OUTPUT)
+    {
+      throw CBlockEditorException("Only input ports can be fed from stream", EErrorCode::E_INTERN);
+    }
+
+    m_bindings.push_back(Binding{blockID, whichPort, &is, format});
+  }
+
+  /**
+   * @brief Streams all inputs through scheme until any of them ends. Each
+   *        line of output holds results of output blocks for one sample.
+   * @param os Stream for results
+   * @return Statistics of streaming
+   */
+  StreamStats CStreamEngine::run(std::ostream& os)
+  {
+    std::vector<ID> outputs;
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    std::size_t attached = 0;
+
+    // Keeps the first failure of any thread
+    auto fail = [&error, &errorMutex] {
+      std::lock_guard<std::mutex> lock(errorMutex);
+      if (!error) error = std::current_exception();
+    };
+
+    if (m_bindings.empty())
+    {
+      throw CBlockEditorException("No input port is fed from stream", EErrorCode::E_INTERN);
+    }
+
+    m_stats = StreamStats{};
+
+    // Queues are closed at the end of previous run
+    m_chunks.reopen();
+    m_results.reopen();
+
+    try
+    {
+      // Streamed ports get input blocks whose values are replaced by each chunk
+      for (auto& it : m_bindings)
+      {
+        m_scheme.addInputValue(it.m_blockID, .0, it.m_port);
+        attached++;
+      }
+
+      outputs = m_scheme.getOutputBlocks();
+      if (outputs.empty())
+      {
+        throw CBlockEditorException("Scheme hasnt any output block", EErrorCode::E_UI_NOT_CON);
+      }
+
+      auto start = Clock::now();
+
+      std::thread reader([this, &fail] {
+        TRACE_THREAD("stream reader");
+        try
+        {
+          readChunks();
+        }
+        catch (...)
+        {
+          fail();
+          m_results.close();
+        }
+        m_chunks.close();
+      });
+
+      std::thread writer([this, &os, &outputs, &fail] {
+        TRACE_THREAD("stream writer");
+        try
+        {
+          writeResults(os, outputs);
+        }
+        catch (...)
+        {
+          fail();
+          m_chunks.close();
+          m_results.close();
+        }
+      });
+
+      try
+      {
+        evaluateChunks(outputs);
+      }
+      catch (...)
+      {
+        fail();
+        m_chunks.close();
+      }
+      m_results.close();
+
+      reader.join();
+      writer.join();
+
+      m_stats.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+      if (m_stats.seconds > .0)
+      {
+        m_stats.samplesPerSecond = m_stats.samples / m_stats.seconds;
+      }
+      if (m_stats.chunks > 0)
+      {
+        m_stats.avgLatencyMs /= m_stats.chunks;
+      }
+    }
+    catch (...)
+    {
+      fail();
+    }
+
+    // Leave scheme as it was
+    for (std::size_t i = 0; i < attached; i++)
+    {
+      m_scheme.removeInputValue(m_bindings[i].m_blockID, m_bindings[i].m_port);
+    }
+
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
+
+    return m_stats;
+  }
+
+  /**
+   * @brief Reads up to chunk size samples from input
+   * @param binding Input to read from
+   * @param pa Where samples are stored
+   * @return Count of read samples, zero at the end of stream
+   */
+  std::size_t CStreamEngine::readSamples(Binding& binding, PortArray& pa)
+  {
+    std::istream& is = *binding.m_is;
+
+    if (binding.m_format == EStreamFormat::SF_BINARY)
+    {
+      pa.resize(m_chunkSize);
+      is.read(reinterpret_cast<char*>(pa.data()), m_chunkSize * sizeof(PortValue));
+      if (is.gcount() % sizeof(PortValue) != 0)
+      {
+        throw CBlockEditorException(std::string("Incomplete sample at the end of stream of block ")
+                  + std::to_string(binding.m_blockID), EErrorCode::E_UI_BAD_FILE);
+      }
+      pa.resize(is.gcount() / sizeof(PortValue));
+      return pa.size();
+    }
+
+    pa.clear();
+    pa.reserve(m_chunkSize);
+    while (pa.size() < m_chunkSize)
+    {
+      int c = is.peek();
+      if (c == std::char_traits<char>::eof())
+      {
+        break;
+      }
+      if (c == ',' || c == ';' || isspace(c))
+      {
+        is.get();
+        continue;
+      }
+
+      PortValue pv;
+      if (!(is >> pv))
+      {
+        throw CBlockEditorException(std::string("Bad sample in stream of block ")
+                  + std::to_string(binding.m_blockID), EErrorCode::E_UI_BAD_FILE);
+      }
+      pa.push_back(pv);
+    }
+    return pa.size();
+  }
+
+  /**
+   * @brief Reads chunks from all inputs in lockstep, stops at the end of
+   *        the shortest input. Waits while evaluation is behind.
+   */
+  void CStreamEngine::readChunks()
+  {
+    while (true)
+    {
+      TRACE_SPAN("read chunk");
+      Chunk chunk;
+      std::vector<PortArray> samples(m_bindings.size());
+      chunk.m_size = m_chunkSize;
+      chunk.m_read = Clock::now();
+
+      for (std::size_t i = 0; i < m_bindings.size(); i++)
+      {
+        chunk.m_size = std::min(chunk.m_size, readSamples(m_bindings[i], samples[i]));
+      }
+
+      if (chunk.m_size == 0)
+      {
+        return;
+      }
+
+      // Inputs of different length, samples over the shortest are dropped
+      for (auto& it : samples)
+      {
+        it.resize(chunk.m_size);
+        chunk.m_inputs.push_back(std::make_shared<PortArray>(std::move(it)));
+      }
+
+      if (!m_chunks.push(std::move(chunk)))
+      {
+        return;
+      }
+    }
+  }
+
+  /**
+   * @brief Evaluates read chunks through scheme and passes results of
+   *        output blocks to writer
+   * @param outputs IDs of output blocks
+   */
+  void CStreamEngine::evaluateChunks(const std::vector<ID>& outputs)
+  {
+    std::unordered_map<ID, std::size_t> column;
+    for (std::size_t i = 0; i < outputs.size(); i++)
+    {
+      column[outputs[i]] = i;
+    }
+
+    // Slots of streamed inputs are found once, each chunk only replaces
+    // their values in snapshot taken before streaming
+    SnapshotPtr snap = m_scheme.snapshot();
+    std::vector<SlotValue> values;
+    for (auto& it : m_bindings)
+    {
+      values.push_back(SlotValue{m_scheme.getInputSlot(*snap, it.m_blockID, it.m_port), .0, nullptr});
+    }
+
+    // Buffers of evaluation are reused by all chunks
+    CEvalContext ctx;
+    Chunk chunk;
+    std::vector<bool> computed(outputs.size());
+    while (m_chunks.pop(chunk))
+    {
+      TRACE_SPAN("evaluate chunk");
+      for (std::size_t i = 0; i < values.size(); i++)
+      {
+        values[i].m_array = chunk.m_inputs[i];
+      }
+
+      Result result{std::vector<CBlockAction>(outputs.size(), CBlockAction{0}),
+                    chunk.m_size, chunk.m_read};
+      snap->withValues(values)->run(ctx);
+      computed.assign(outputs.size(), false);
+      for (auto& it : ctx.getActions())
+      {
+        auto col = column.find(it.getID());
+        if (col != column.end())
+        {
+          result.m_outputs[col->second] = it;
+          computed[col->second] = true;
+        }
+      }
+      for (std::size_t i = 0; i < outputs.size(); i++)
+      {
+        if (!computed[i])
+        {
+          throw CBlockEditorException("Output block " + std::to_string(outputs[i]) + " wasnt computed",
+                                      EErrorCode::E_RUNTIME_ERROR);
+        }
+      }
+
+      // Drop inputs of evaluated chunk, keeps memory bounded
+      chunk.m_inputs.clear();
+      for (auto& it : values)
+      {
+        it.m_array.reset();
+      }
+
+      if (!m_results.push(std::move(result)))
+      {
+        return;
+      }
+    }
+  }
+
+  /**
+   * @brief Writes results of output blocks, one line per sample
+   * @param os Stream for results
+   * @param outputs IDs of output blocks
+   */
+  void CStreamEngine::writeResults(std::ostream& os, const std::vector<ID>& outputs)
+  {
+    os.precision(std::numeric_limits<PortValue>::digits10);
+
+    for (std::size_t i = 0; i < outputs.size(); i++)
+    {
+      os << "Block " << outputs[i] << (i + 1 < outputs.size() ? "," : "\n");
+    }
+
+    Result result;
+    while (m_results.pop(result))
+    {
+      TRACE_SPAN("write chunk");
+      for (std::size_t s = 0; s < result.m_size; s++)
+      {
+        for (std::size_t i = 0; i < result.m_outputs.size(); i++)
+        {
+          const CBlockAction& a = result.m_outputs[i];
+          if (a.isInteger())
+          {
+            os << a.getInteger();
+          }
+          else
+          {
+            os << (a.hasArray() ? (*a.getArray())[s] : a.getValue());
+          }
+          os << (i + 1 < result.m_outputs.size() ? ',' : '\n');
+        }
+      }
+      os.flush();
+
+      double latency = std::chrono::duration<double, std::milli>(Clock::now() - result.m_read).count();
+      m_stats.avgLatencyMs += latency;
+      m_stats.maxLatencyMs = std::max(m_stats.maxLatencyMs, latency);
+      m_stats.samples += result.m_size;
+      m_stats.chunks++;
+    }
+
+    if (!os)
+    {
+      throw CBlockEditorException("Writing results of stream failed", EErrorCode::E_RUNTIME_ERROR);
+    }
+  }
+}
@@ -0,0 +1,107 @@
+/**
+ *		@file 		StreamEngine.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Streaming dataflow mode, pushes input samples through
+ *              scheme continuously in chunks
+ */
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+
+#include "BlockScheme.hpp"
+#include "BoundedQueue.hpp"
+
+///
+/// Namespace with implementation of logic of an application
+///
+namespace BlockEditorLogic
+{
+  ///
+  /// Encoding of samples in input stream
+  ///
+  enum class EStreamFormat
+  {
+    SF_TEXT,      /**< Numbers separated by whitespace, commas or semicolons */
+    SF_BINARY     /**< Raw doubles in native byte order */
+  };
+
+  ///
+  /// Statistics of finished streaming
+  ///
+  struct StreamStats
+  {
+    std::size_t   samples = 0;            /**< Samples pushed through scheme (per input) */
+    std::size_t   chunks = 0;             /**< Chunks evaluated */
+    double        seconds = .0;           /**< Wall time of streaming */
+    double        samplesPerSecond = .0;  /**< Sustained throughput */
+    double        avgLatencyMs = .0;      /**< Mean time from reading chunk to writing its results */
+    double        maxLatencyMs = .0;      /**< Worst time from reading chunk to writing its results */
+  };
+
+  ///
+  /// Feeds input ports of scheme from streams. Reading, evaluation and
+  /// writing run in separate threads connected by bounded queues, so
+  /// at most queueDepth chunks are in flight and slow consumer stalls
+  /// readers instead of growing memory.
+  ///
+  class CStreamEngine
+  {
+  public:
+    CStreamEngine() = delete;
+    CStreamEngine(CBlockScheme&, std::size_t chunkSize = 4096, std::size_t queueDepth = 4);
+    ~CStreamEngine() = default;
+
+    void          bindInput(ID, Ports, std::istream&, EStreamFormat format = EStreamFormat::SF_TEXT);
+    StreamStats   run(std::ostream&);
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    ///
+    /// Input port fed from stream
+    ///
+    struct Binding
+    {
+      ID              m_blockID;
+      Ports           m_port;
+      std::istream   *m_is;
+      EStreamFormat   m_format;
+    };
+
+    ///
+    /// Samples of all inputs read at once
+    ///
+    struct Chunk
+    {
+      std::vector<PortArrayPtr>  m_inputs;    /**< Samples of each binding */
+      std::size_t                m_size;      /**< Samples in chunk */
+      Clock::time_point          m_read;      /**< When reading of chunk started */
+    };
+
+    ///
+    /// Results of output blocks for one chunk
+    ///
+    struct Result
+    {
+      std::vector<CBlockAction>  m_outputs;   /**< Result of each output block */
+      std::size_t                m_size;      /**< Samples in chunk */
+      Clock::time_point          m_read;      /**< When reading of chunk started */
+    };
+
+    std::size_t   readSamples(Binding&, PortArray&);
+    void          readChunks();
+    void          evaluateChunks(const std::vector<ID>&);
+    void          writeResults(std::ostream&, const std::vector<ID>&);
+
+    CBlockScheme            &m_scheme;        /**< Evaluated scheme */
+    std::size_t             m_chunkSize;      /**< Samples read from each input at once */
+    std::vector<Binding>    m_bindings;       /**< Streamed input ports */
+    CBoundedQueue<Chunk>    m_chunks;         /**< Read chunks waiting for evaluation */
+    CBoundedQueue<Result>   m_results;        /**< Results waiting for writing */
+    StreamStats             m_stats;          /**< Statistics of running stream */
+  };
+}
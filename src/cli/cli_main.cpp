@@ -0,0 +1,623 @@
+/**
+ *		@file 		cli_main.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Headless tool running schemes without GUI
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "../BlockScheme.hpp"
+#include "../SchemeBench.hpp"
+#include "../SchemeProfile.hpp"
+#include "../StreamEngine.hpp"
+#include "../SchemeTrace.hpp"
+
+using namespace BlockEditorLogic;
+
+/**
+ * @brief Prints usage of the tool
+ */
+static void usage()
+{
+  std::cerr << "Usage:\n"
+            << "  blockeditor-cli run <scheme> [-m] [-s <file>] [-t <file>]\n"
+            << "  blockeditor-cli stream <scheme> -i <block>:<port>=<file|-> [-i ...]\n"
+            << "                  [-b] [-c <chunk>] [-q <depth>] [-o <file>] [-s <file>]\n"
+            << "                  [-t <file>]\n"
+            << "  blockeditor-cli profile <chain|tree|wide|macro> <blocks> [-r <runs>]\n"
+            << "                  [-o <file>] [-s <file>] [-t <file>]\n"
+            << "  blockeditor-cli collapse <scheme> [-o <file>]\n"
+            << "  blockeditor-cli concurrent <scheme> [-j <threads>] [-r <runs>]\n"
+            << "\n"
+            << "  -m  print memory used by parts of the scheme, with peaks of load and run\n"
+            << "  -i  feed input port (1|2, any of reduction block) of block from file or stdin\n"
+            << "  -b  inputs are raw binary doubles instead of text\n"
+            << "  -c  samples read from each input at once (default 4096)\n"
+            << "  -q  chunks in flight between stages (default 4)\n"
+            << "  -o  write results to file instead of stdout, generated scheme for profile,\n"
+            << "      collapsed scheme instead of the scheme itself for collapse\n"
+            << "  -r  measured runs of load, run and save (default 5), runs of each thread\n"
+            << "      for concurrent (default 100)\n"
+            << "  -j  threads evaluating the scheme at once (default hardware threads)\n"
+            << "  -s  write counters and timers to file in Prometheus text format\n"
+            << "  -t  write Chrome trace of the run to file (needs make TRACE=1)\n";
+}
+
+/**
+ * @brief Prints memory report, bytes per block exclude input blocks
+ * @param os Stream to print to
+ * @param m The report
+ */
+static void printMemory(std::ostream& os, const SchemeMemory& m)
+{
+  double blocks = std::max<uint64_t>(1, m.m_blocks - m.m_inputBlocks);
+
+  os << "Memory:   " << m.getTotal() << " bytes, " << m.m_blocks - m.m_inputBlocks << " blocks, "
+     << m.m_inputBlocks << " input blocks, " << m.m_ports << " ports" << std::endl
+     << std::fixed << std::setprecision(1);
+  for (int i = 0; i < MP_COUNT; i++)
+  {
+    os << "  " << std::left << std::setw(16) << memoryPartName(static_cast<EMemoryPart>(i)) << std::right
+       << std::setw(14) << m.m_bytes[i] << std::setw(12) << m.m_bytes[i] / blocks << " B/block" << std::endl;
+  }
+  os << "  " << std::left << std::setw(16) << "total" << std::right
+     << std::setw(14) << m.getTotal() << std::setw(12) << m.getTotal() / blocks << " B/block" << std::endl
+     << "  " << std::left << std::setw(16) << "peak load" << std::right
+     << std::setw(14) << m.m_loadPeak << std::setw(12) << m.m_loadPeak / blocks << " B/block" << std::endl
+     << "  " << std::left << std::setw(16) << "peak run" << std::right
+     << std::setw(14) << m.m_runPeak << std::setw(12) << m.m_runPeak / blocks << " B/block"
+     << " (buffers and results of one run)" << std::endl;
+}
+
+/**
+ * @brief Runs scheme once and prints results of all blocks
+ * @param file Scheme file
+ * @param args Options of run command
+ * @return Exit code
+ */
+static int runScheme(std::string file, const std::vector<std::string>& args)
+{
+  CBlockScheme scheme;
+  std::string stats;
+  bool memory = false;
+
+  for (std::size_t i = 0; i < args.size(); i++)
+  {
+    if (args[i] == "-m")
+    {
+      memory = true;
+    }
+    else if (i + 1 < args.size() && args[i] == "-s")
+    {
+      stats = args[++i];
+    }
+    else if (i + 1 < args.size() && args[i] == "-t")
+    {
+      CTracer::start(args[++i]);
+    }
+    else
+    {
+      usage();
+      return 1;
+    }
+  }
+
+  scheme.openScheme(file);
+
+  for (auto& it : scheme.run())
+  {
+    std::cout << "Block " << it.getID() << ": "
+              << (it.hasArray() ? summarizeArray(*it.getArray())
+                  : it.isInteger() ? std::to_string(it.getInteger()) : std::to_string(it.getValue()))
+              << std::endl;
+  }
+
+  if (memory)
+  {
+    printMemory(std::cerr, scheme.getMemory());
+  }
+  if (!stats.empty())
+  {
+    scheme.exportStats(stats);
+  }
+  CTracer::stop();
+  return 0;
+}
+
+/**
+ * @brief Streams inputs through scheme
+ * @param file Scheme file
+ * @param args Options of stream command
+ * @return Exit code
+ */
+static int streamScheme(std::string file, const std::vector<std::string>& args)
+{
+  CBlockScheme scheme;
+  std::vector<std::unique_ptr<std::ifstream>> inputs;
+  std::vector<std::pair<std::pair<ID, Ports>, std::string>> bindings;
+  std::size_t chunk = 4096, depth = 4;
+  EStreamFormat format = EStreamFormat::SF_TEXT;
+  std::string output, statsFile;
+
+  for (std::size_t i = 0; i < args.size(); i++)
+  {
+    if (args[i] == "-b")
+    {
+      format = EStreamFormat::SF_BINARY;
+    }
+    else if (i + 1 < args.size() && args[i] == "-c")
+    {
+      chunk = std::stoul(args[++i]);
+    }
+    else if (i + 1 < args.size() && args[i] == "-q")
+    {
+      depth = std::stoul(args[++i]);
+    }
+    else if (i + 1 < args.size() && args[i] == "-o")
+    {
+      output = args[++i];
+    }
+    else if (i + 1 < args.size() && args[i] == "-s")
+    {
+      statsFile = args[++i];
+    }
+    else if (i + 1 < args.size() && args[i] == "-t")
+    {
+      CTracer::start(args[++i]);
+    }
+    else if (i + 1 < args.size() && args[i] == "-i")
+    {
+      // <block>:<port>=<file>
+      std::string spec = args[++i];
+      auto colon = spec.find(':');
+      auto eq = spec.find('=');
+      if (colon == std::string::npos || eq == std::string::npos || eq < colon)
+      {
+        usage();
+        return 1;
+      }
+      ID block = std::stoul(spec.substr(0, colon));
+      int port = std::stoi(spec.substr(colon + 1, eq - colon - 1));
+      if (port < 1 || static_cast<size_t>(port) > MAX_INPUTS)
+      {
+        usage();
+        return 1;
+      }
+      bindings.push_back({{block, inputPort(port)}, spec.substr(eq + 1)});
+    }
+    else
+    {
+      usage();
+      return 1;
+    }
+  }
+
+  scheme.openScheme(file);
+  CStreamEngine engine(scheme, chunk, depth);
+
+  for (auto& it : bindings)
+  {
+    if (it.second == "-")
+    {
+      engine.bindInput(it.first.first, it.first.second, std::cin, format);
+      continue;
+    }
+
+    inputs.emplace_back(new std::ifstream(it.second, std::ios::binary));
+    if (!inputs.back()->is_open())
+    {
+      throw CBlockEditorException("Could not open input stream " + it.second, EErrorCode::E_UI_BAD_FILE);
+    }
+    engine.bindInput(it.first.first, it.first.second, *inputs.back(), format);
+  }
+
+  StreamStats stats;
+  if (output.empty())
+  {
+    stats = engine.run(std::cout);
+  }
+  else
+  {
+    std::ofstream os(output);
+    stats = engine.run(os);
+  }
+
+  std::cerr << "Samples:    " << stats.samples << " in " << stats.chunks << " chunks" << std::endl
+            << "Throughput: " << stats.samplesPerSecond << " samples/s" << std::endl
+            << "Latency:    " << stats.avgLatencyMs << " ms avg, " << stats.maxLatencyMs << " ms max" << std::endl;
+
+  if (!statsFile.empty())
+  {
+    scheme.exportStats(statsFile);
+  }
+  CTracer::stop();
+  return 0;
+}
+
+/**
+ * @brief Adds counters of one interval to the total
+ * @param total Counters of all intervals of phase
+ * @param s Counters of the interval
+ */
+static void addSample(PerfSample& total, const PerfSample& s)
+{
+  total.m_wallNs += s.m_wallNs;
+  for (int c = 0; c < PC_COUNT; c++)
+  {
+    total.m_counted[c] = s.m_counted[c];
+    total.m_values[c] += s.m_values[c];
+  }
+}
+
+/**
+ * @brief Generates scheme and measures loading, evaluation and saving of
+ *        it by hardware counters, or by wall time where they arent
+ *        permitted. Loading parses on one thread, as only the calling
+ *        thread is counted.
+ * @param shape Shape of generated scheme
+ * @param args Count of blocks and options of profile command
+ * @return Exit code
+ */
+static int profileScheme(std::string shape, const std::vector<std::string>& args)
+{
+  CBlockScheme scheme;
+  std::string file, statsFile;
+  std::size_t runs = 5;
+  bool keep = false;
+
+  if (args.empty())
+  {
+    usage();
+    return 1;
+  }
+  std::size_t blocks = std::stoul(args[0]);
+
+  for (std::size_t i = 1; i < args.size(); i++)
+  {
+    if (i + 1 < args.size() && args[i] == "-r")
+    {
+      runs = std::stoul(args[++i]);
+    }
+    else if (i + 1 < args.size() && args[i] == "-o")
+    {
+      file = args[++i];
+      keep = true;
+    }
+    else if (i + 1 < args.size() && args[i] == "-s")
+    {
+      statsFile = args[++i];
+    }
+    else if (i + 1 < args.size() && args[i] == "-t")
+    {
+      CTracer::start(args[++i]);
+    }
+    else
+    {
+      usage();
+      return 1;
+    }
+  }
+  if (blocks == 0 || runs == 0)
+  {
+    usage();
+    return 1;
+  }
+
+  generateBenchScheme(scheme, parseBenchShape(shape), blocks);
+
+  if (!keep)
+  {
+    const char *dir = std::getenv("TMPDIR");
+    file = std::string(dir ? dir : "/tmp") + "/blockeditor-profile-XXXXXX";
+    int fd = mkstemp(&file[0]);
+    if (fd == -1)
+    {
+      throw CBlockEditorException("Cannot create temporary file " + file, EErrorCode::E_UI_BAD_FILE);
+    }
+    close(fd);
+  }
+
+  const char *phases[] = {"load", "run", "save"};
+  PerfSample total[3];
+  CPerfGroup perf;
+
+  try
+  {
+    // First round only warms up caches and allocator
+    scheme.saveScheme(CBlockScheme::Coords(), file);
+    for (std::size_t r = 0; r <= runs; r++)
+    {
+      PerfSample s[3];
+
+      perf.start();
+      scheme.openScheme(file, 1);
+      s[0] = perf.stop();
+
+      perf.start();
+      scheme.run();
+      s[1] = perf.stop();
+
+      perf.start();
+      scheme.saveScheme(CBlockScheme::Coords(), file);
+      s[2] = perf.stop();
+
+      for (int p = 0; r > 0 && p < 3; p++)
+      {
+        addSample(total[p], s[p]);
+      }
+    }
+  }
+  catch (...)
+  {
+    if (!keep)
+    {
+      std::remove(file.c_str());
+    }
+    throw;
+  }
+
+  if (!keep)
+  {
+    std::remove(file.c_str());
+  }
+
+  std::cout << "Scheme:   " << shape << ", " << blocks << " blocks, " << runs << " runs" << std::endl;
+  if (perf.available())
+  {
+    std::cout << "Counters: per block, user space of the main thread" << std::endl;
+  }
+  else
+  {
+    std::cout << "Counters: not available, wall time only (" << perf.getError() << ")" << std::endl;
+  }
+
+  std::cout << std::left << std::setw(8) << "phase" << std::right
+            << std::setw(12) << "ms/run" << std::setw(12) << "ns/block";
+  for (int c = 0; c < PC_COUNT; c++)
+  {
+    std::cout << std::setw(15) << CPerfGroup::counterName(static_cast<EPerfCounter>(c));
+  }
+  std::cout << std::setw(8) << "IPC" << std::endl;
+
+  double n = static_cast<double>(runs) * blocks;
+  std::cout << std::fixed << std::setprecision(2);
+  for (int p = 0; p < 3; p++)
+  {
+    const PerfSample& s = total[p];
+    std::cout << std::left << std::setw(8) << phases[p] << std::right
+              << std::setw(12) << s.m_wallNs / 1e6 / runs
+              << std::setw(12) << s.m_wallNs / n;
+    for (int c = 0; c < PC_COUNT; c++)
+    {
+      std::cout << std::setw(15);
+      if (s.m_counted[c])
+      {
+        std::cout << s.m_values[c] / n;
+      }
+      else
+      {
+        std::cout << "-";
+      }
+    }
+
+    std::cout << std::setw(8);
+    if (s.m_counted[PC_CYCLES] && s.m_counted[PC_INSTRUCTIONS] && s.m_values[PC_CYCLES])
+    {
+      std::cout << static_cast<double>(s.m_values[PC_INSTRUCTIONS]) / s.m_values[PC_CYCLES];
+    }
+    else
+    {
+      std::cout << "-";
+    }
+    std::cout << std::endl;
+  }
+  printMemory(std::cout, scheme.getMemory());
+
+  if (!statsFile.empty())
+  {
+    scheme.exportStats(statsFile);
+  }
+  CTracer::stop();
+  return 0;
+}
+
+/**
+ * @brief Replaces chains of ADD and MUL blocks by reduction blocks, see
+ *        CBlockScheme::collapseReductions, and saves the scheme
+ * @param file Scheme file
+ * @param args Options of collapse command
+ * @return Exit code
+ */
+static int collapseScheme(std::string file, const std::vector<std::string>& args)
+{
+  CBlockScheme scheme;
+  std::string out = file;
+
+  for (std::size_t i = 0; i < args.size(); i++)
+  {
+    if (i + 1 < args.size() && args[i] == "-o")
+    {
+      out = args[++i];
+    }
+    else
+    {
+      usage();
+      return 1;
+    }
+  }
+
+  scheme.openScheme(file);
+  std::size_t before = scheme.getMemory().m_blocks;
+  std::size_t removed = scheme.collapseReductions();
+  scheme.saveScheme(CBlockScheme::Coords(), out);
+
+  std::cout << "Removed " << removed << " of " << before << " blocks, saved to " << out << std::endl;
+  return 0;
+}
+
+/**
+ * @brief Results of two runs are the same, bit for bit, so NaNs match too
+ */
+static bool sameActions(const std::deque<CBlockAction>& a, const std::deque<CBlockAction>& b)
+{
+  if (a.size() != b.size())
+  {
+    return false;
+  }
+  for (std::size_t i = 0; i < a.size(); i++)
+  {
+    if (a[i].getID() != b[i].getID() || a[i].isInteger() != b[i].isInteger() || a[i].hasArray() != b[i].hasArray())
+    {
+      return false;
+    }
+    if (a[i].isInteger() && a[i].getInteger() != b[i].getInteger())
+    {
+      return false;
+    }
+
+    PortValue x = a[i].getValue(), y = b[i].getValue();
+    std::size_t n = a[i].hasArray() ? a[i].getArray()->size() : 1;
+    if ((b[i].hasArray() ? b[i].getArray()->size() : 1) != n
+          || std::memcmp(a[i].hasArray() ? a[i].getArray()->data() : &x,
+                         b[i].hasArray() ? b[i].getArray()->data() : &y, n * sizeof(PortValue)) != 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Evaluates one scheme from many threads at once, each thread in its
+ *        own context, and checks every run against a run of one thread.
+ *        Built with make tsan, it checks that runs share no mutable state.
+ * @param file Scheme file
+ * @param args Options of concurrent command
+ * @return Exit code
+ */
+static int concurrentScheme(std::string file, const std::vector<std::string>& args)
+{
+  CBlockScheme scheme;
+  std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+  std::size_t runs = 100;
+
+  for (std::size_t i = 0; i < args.size(); i++)
+  {
+    if (i + 1 < args.size() && args[i] == "-j")
+    {
+      threads = std::max<std::size_t>(1, std::stoul(args[++i]));
+    }
+    else if (i + 1 < args.size() && args[i] == "-r")
+    {
+      runs = std::stoul(args[++i]);
+    }
+    else
+    {
+      usage();
+      return 1;
+    }
+  }
+
+  scheme.openScheme(file);
+
+  CEvalContext reference;
+  scheme.run(reference);
+
+  // Snapshot isnt published, so the threads also make their own at once
+  std::vector<std::size_t> differ(threads, 0);
+  std::vector<std::exception_ptr> errors(threads);
+  std::vector<std::thread> pool;
+  for (std::size_t t = 0; t < threads; t++)
+  {
+    pool.emplace_back([&, t] {
+      try
+      {
+        CEvalContext ctx;
+        for (std::size_t r = 0; r < runs; r++)
+        {
+          scheme.run(ctx);
+          differ[t] += !sameActions(ctx.getActions(), reference.getActions());
+        }
+      }
+      catch (...)
+      {
+        errors[t] = std::current_exception();
+      }
+    });
+  }
+  for (auto& it : pool)
+  {
+    it.join();
+  }
+
+  std::size_t total = 0;
+  for (std::size_t t = 0; t < threads; t++)
+  {
+    if (errors[t])
+    {
+      std::rethrow_exception(errors[t]);
+    }
+    total += differ[t];
+  }
+
+  std::cout << "Threads:  " << threads << ", " << runs << " runs each, "
+            << reference.getActions().size() << " results per run" << std::endl
+            << "Differ:   " << total << " runs" << std::endl;
+  return total == 0 ? 0 : 3;
+}
+
+int main(int argc, char *argv[])
+{
+  std::vector<std::string> args(argv + 1, argv + argc);
+
+  if (args.size() < 2)
+  {
+    usage();
+    return 1;
+  }
+
+  try
+  {
+    if (args[0] == "run")
+    {
+      return runScheme(args[1], std::vector<std::string>(args.begin() + 2, args.end()));
+    }
+    else if (args[0] == "stream")
+    {
+      return streamScheme(args[1], std::vector<std::string>(args.begin() + 2, args.end()));
+    }
+    else if (args[0] == "profile")
+    {
+      return profileScheme(args[1], std::vector<std::string>(args.begin() + 2, args.end()));
+    }
+    else if (args[0] == "collapse")
+    {
+      return collapseScheme(args[1], std::vector<std::string>(args.begin() + 2, args.end()));
+    }
+    else if (args[0] == "concurrent")
+    {
+      return concurrentScheme(args[1], std::vector<std::string>(args.begin() + 2, args.end()));
+    }
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 2;
+  }
+
+  usage();
+  return 1;
+}
@@ -0,0 +1,512 @@
+/**
+ *		@file 		EvalServer.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Evaluation of cached schemes for clients of UNIX socket
+ */
+
+#include "EvalServer.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../SchemeTrace.hpp"
+
+///
+/// Namespace with implementation of evaluation server
+///
+namespace BlockEditorServer
+{
+  /// Upper bounds of histogram buckets, in seconds
+  static const double BUCKET_BOUNDS[CLatencyHistogram::BUCKETS] = {
+    0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10
+  };
+
+  /// Longest request line accepted
+  const size_t MAX_LINE = 1 << 20;
+
+  /**
+   * @brief Histogram with no requests
+   */
+  CLatencyHistogram::CLatencyHistogram()
+  {
+    for (auto& it : m_counts)
+    {
+      it.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Counts request
+   * @param latency Time from receiving request to answering it
+   */
+  void CLatencyHistogram::add(Clock::duration latency)
+  {
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count();
+    size_t i = 0;
+    while (i < BUCKETS && ns > BUCKET_BOUNDS[i] * 1e9)
+    {
+      i++;
+    }
+    m_counts[i].fetch_add(1, std::memory_order_relaxed);
+    m_totalNs.fetch_add(ns, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Writes histogram in Prometheus text format, buckets cumulative
+   * @param os Stream to write to
+   * @param name Name of metric
+   */
+  void CLatencyHistogram::write(std::ostream& os, const std::string& name) const
+  {
+    uint64_t total = 0;
+    os << "# TYPE " << name << " histogram\n";
+    for (size_t i = 0; i <= BUCKETS; i++)
+    {
+      total += m_counts[i].load(std::memory_order_relaxed);
+      os << name << "_bucket{le=\"";
+      if (i < BUCKETS)
+      {
+        os << BUCKET_BOUNDS[i];
+      }
+      else
+      {
+        os << "+Inf";
+      }
+      os << "\"} " << total << "\n";
+    }
+    os << name << "_sum " << m_totalNs.load(std::memory_order_relaxed) / 1e9 << "\n"
+       << name << "_count " << total << "\n";
+  }
+
+  /**
+   * @brief Writes whole buffer to socket
+   * @return False if connection was closed
+   */
+  static bool sendAll(int fd, const std::string& data)
+  {
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+      ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+      if (n < 0 && errno == EINTR)
+      {
+        continue;
+      }
+      if (n <= 0)
+      {
+        return false;
+      }
+      sent += n;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Binds socket and starts evaluating threads
+   * @param options Options of server
+   */
+  CEvalServer::CEvalServer(const ServerOptions& options)
+    : m_options{options}, m_listen{-1}, m_cache{options.m_cacheSize}, m_tasks{options.m_queueDepth}
+  {
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (m_options.m_socket.empty() || m_options.m_socket.size() >= sizeof(addr.sun_path))
+    {
+      throw CBlockEditorException("Bad socket path " + m_options.m_socket, EErrorCode::E_UI_BAD_FILE);
+    }
+    std::strcpy(addr.sun_path, m_options.m_socket.c_str());
+
+    m_listen = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listen < 0)
+    {
+      throw CBlockEditorException(std::string("Cannot create socket -- ") + std::strerror(errno), EErrorCode::E_RUNTIME_ERROR);
+    }
+
+    // Socket left by server which didnt exit cleanly
+    unlink(m_options.m_socket.c_str());
+    if (bind(m_listen, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(m_listen, 64) != 0)
+    {
+      std::string err = std::strerror(errno);
+      close(m_listen);
+      throw CBlockEditorException("Cannot listen on " + m_options.m_socket + " -- " + err, EErrorCode::E_UI_BAD_FILE);
+    }
+
+    unsigned threads = m_options.m_threads ? m_options.m_threads : std::thread::hardware_concurrency();
+    for (unsigned i = 0; i < std::max(1u, threads); i++)
+    {
+      m_workers.emplace_back(&CEvalServer::work, this);
+    }
+  }
+
+  /**
+   * @brief Stops server and waits for all its threads
+   */
+  CEvalServer::~CEvalServer()
+  {
+    stop();
+
+    {
+      std::unique_lock<std::mutex> lock(m_connMutex);
+      m_connClosed.wait(lock, [this] { return m_connections.empty(); });
+    }
+    m_tasks.close();
+    for (auto& it : m_workers)
+    {
+      it.join();
+    }
+
+    close(m_listen);
+    unlink(m_options.m_socket.c_str());
+  }
+
+  /**
+   * @brief Accepts connections until server is stopped, each connection is
+   *        served by thread of its own
+   */
+  void CEvalServer::serve()
+  {
+    while (!m_stopped.load())
+    {
+      int fd = accept4(m_listen, nullptr, nullptr, SOCK_CLOEXEC);
+      if (fd < 0)
+      {
+        if (errno == EINTR || errno == ECONNABORTED)
+        {
+          continue;
+        }
+        if (m_stopped.load())
+        {
+          break;
+        }
+        throw CBlockEditorException(std::string("Cannot accept connection -- ") + std::strerror(errno), EErrorCode::E_RUNTIME_ERROR);
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(m_connMutex);
+        m_connections.insert(fd);
+      }
+      std::thread(&CEvalServer::serveConnection, this, fd).detach();
+    }
+  }
+
+  /**
+   * @brief Stops accepting connections and closes open ones, requests
+   *        being evaluated are still answered. Can be called from any thread.
+   */
+  void CEvalServer::stop()
+  {
+    if (m_stopped.exchange(true))
+    {
+      return;
+    }
+    shutdown(m_listen, SHUT_RDWR);
+
+    std::lock_guard<std::mutex> lock(m_connMutex);
+    for (int fd : m_connections)
+    {
+      shutdown(fd, SHUT_RD);
+    }
+  }
+
+  /**
+   * @brief Reads requests from connection and answers them in order
+   * @param fd Connected socket, closed at the end
+   */
+  void CEvalServer::serveConnection(int fd)
+  {
+    std::string buffer;
+    char data[4096];
+
+    while (true)
+    {
+      size_t eol = buffer.find('\n');
+      if (eol == std::string::npos)
+      {
+        if (buffer.size() > MAX_LINE)
+        {
+          sendAll(fd, "ERR Request is too long\n");
+          break;
+        }
+        ssize_t n = read(fd, data, sizeof(data));
+        if (n < 0 && errno == EINTR)
+        {
+          continue;
+        }
+        if (n <= 0)
+        {
+          break;
+        }
+        buffer.append(data, n);
+        continue;
+      }
+
+      std::string line = buffer.substr(0, eol);
+      buffer.erase(0, eol + 1);
+      if (!line.empty() && line.back() == '\r')
+      {
+        line.pop_back();
+      }
+      if (line.empty())
+      {
+        continue;
+      }
+      if (!sendAll(fd, handle(line)))
+      {
+        break;
+      }
+    }
+
+    close(fd);
+    std::lock_guard<std::mutex> lock(m_connMutex);
+    m_connections.erase(fd);
+    m_connClosed.notify_all();
+  }
+
+  /**
+   * @brief Answers one request
+   * @param line Request without end of line
+   * @return Response, lines ended by end of line
+   */
+  std::string CEvalServer::handle(const std::string& line)
+  {
+    std::istringstream is(line);
+    std::string command, word;
+    is >> command;
+
+    if (command == "STATS")
+    {
+      std::string text = stats();
+      size_t lines = 0;
+      for (char c : text)
+      {
+        lines += c == '\n';
+      }
+      return "OK " + std::to_string(lines) + "\n" + text;
+    }
+    if (command != "RUN")
+    {
+      m_errors.fetch_add(1, std::memory_order_relaxed);
+      return "ERR Unknown request " + command + "\n";
+    }
+
+    TaskPtr task = std::make_shared<Task>();
+    task->m_received = Clock::now();
+    task->m_deadline = Clock::time_point::max();
+    unsigned deadline = m_options.m_deadlineMs;
+
+    try
+    {
+      if (!(is >> task->m_file))
+      {
+        throw CBlockEditorException("Scheme file is missing", EErrorCode::E_INTERN);
+      }
+      while (is >> word)
+      {
+        if (word.compare(0, 9, "deadline=") == 0)
+        {
+          deadline = std::stoul(word.substr(9));
+        }
+        else if (word.compare(0, 4, "out=") == 0)
+        {
+          task->m_outputs.push_back(std::stoul(word.substr(4)));
+        }
+        else if (word.compare(0, 3, "in=") == 0)
+        {
+          // in=<block>:<port>=<value>
+          auto colon = word.find(':'), eq = word.find('=', 3);
+          if (colon == std::string::npos || eq == std::string::npos || eq < colon)
+          {
+            throw CBlockEditorException("Bad input " + word, EErrorCode::E_INTERN);
+          }
+          InputValue in;
+          in.m_blockID = std::stoul(word.substr(3, colon - 3));
+          int port = std::stoi(word.substr(colon + 1, eq - colon - 1));
+          if (port < 1 || static_cast<size_t>(port) > MAX_INPUTS)
+          {
+            throw CBlockEditorException("Bad input port " + word, EErrorCode::E_INTERN);
+          }
+          in.m_port = inputPort(port);
+          in.m_value = std::stod(word.substr(eq + 1));
+          task->m_inputs.push_back(in);
+        }
+        else
+        {
+          throw CBlockEditorException("Unknown option " + word, EErrorCode::E_INTERN);
+        }
+      }
+    }
+    catch (std::exception& e)
+    {
+      m_errors.fetch_add(1, std::memory_order_relaxed);
+      return std::string("ERR ") + e.what() + "\n";
+    }
+
+    if (deadline)
+    {
+      task->m_deadline = task->m_received + std::chrono::milliseconds(deadline);
+    }
+
+    std::future<std::string> response = task->m_response.get_future();
+    if (!m_tasks.push(task))
+    {
+      return "ERR Server is stopping\n";
+    }
+    return response.get();
+  }
+
+  /**
+   * @brief Evaluating thread, keeps one context for all its requests
+   */
+  void CEvalServer::work()
+  {
+    TRACE_THREAD("evaluator");
+    CEvalContext ctx;
+    TaskPtr task;
+
+    while (m_tasks.pop(task))
+    {
+      std::string response;
+      try
+      {
+        response = evaluate(*task, ctx);
+        m_ok.fetch_add(1, std::memory_order_relaxed);
+      }
+      catch (CBlockEditorException& e)
+      {
+        if (e.getErrCode() == EErrorCode::E_CANCELLED)
+        {
+          m_missed.fetch_add(1, std::memory_order_relaxed);
+          response = "ERR Deadline exceeded\n";
+        }
+        else
+        {
+          m_errors.fetch_add(1, std::memory_order_relaxed);
+          response = std::string("ERR ") + e.what() + "\n";
+        }
+      }
+      catch (std::exception& e)
+      {
+        m_errors.fetch_add(1, std::memory_order_relaxed);
+        response = std::string("ERR ") + e.what() + "\n";
+      }
+
+      m_latency.add(Clock::now() - task->m_received);
+      task->m_response.set_value(std::move(response));
+      task.reset();
+    }
+  }
+
+  /**
+   * @brief Evaluates scheme of request. Evaluation past the deadline is
+   *        cancelled at the next check of its cancel flag.
+   * @param task The request
+   * @param ctx Context of evaluating thread
+   * @return Response
+   */
+  std::string CEvalServer::evaluate(Task& task, CEvalContext& ctx)
+  {
+    TRACE_SPAN("request");
+    std::atomic<bool> cancel{false};
+    auto expired = [&task] { return Clock::now() >= task.m_deadline; };
+
+    if (expired())
+    {
+      throw CBlockEditorException("Deadline exceeded while waiting", EErrorCode::E_CANCELLED);
+    }
+
+    CachedSchemePtr cached = m_cache.get(task.m_file);
+    SnapshotPtr snap = task.m_inputs.empty() ? cached->m_snapshot : cached->m_scheme->withInputs(task.m_inputs);
+
+    if (task.m_deadline == Clock::time_point::max())
+    {
+      snap->run(ctx);
+    }
+    else
+    {
+      snap->run(ctx, &cancel, [&](size_t, size_t) {
+        if (expired())
+        {
+          cancel.store(true, std::memory_order_relaxed);
+        }
+      });
+    }
+
+    // Results of requested blocks, in order they were requested
+    const std::vector<ID>& outputs = task.m_outputs.empty() ? cached->m_outputs : task.m_outputs;
+    std::unordered_map<ID, const CBlockAction*> results;
+    results.reserve(outputs.size());
+    for (ID id : outputs)
+    {
+      results.emplace(id, nullptr);
+    }
+    for (auto& it : ctx.getActions())
+    {
+      auto r = results.find(it.getID());
+      if (r != results.end())
+      {
+        r->second = &it;
+      }
+    }
+
+    std::ostringstream os;
+    os.precision(17);
+    os << "OK " << outputs.size() << "\n";
+    for (ID id : outputs)
+    {
+      const CBlockAction *a = results[id];
+      if (a == nullptr)
+      {
+        throw CBlockEditorException("Block " + std::to_string(id) + " has no result", EErrorCode::E_INTERN);
+      }
+      os << id;
+      if (a->hasArray())
+      {
+        for (PortValue v : *a->getArray())
+        {
+          os << " " << v;
+        }
+      }
+      else if (a->isInteger())
+      {
+        os << " " << a->getInteger();
+      }
+      else
+      {
+        os << " " << a->getValue();
+      }
+      os << "\n";
+    }
+    return os.str();
+  }
+
+  /**
+   * @brief Stats of server in Prometheus text format
+   */
+  std::string CEvalServer::stats() const
+  {
+    std::ostringstream os;
+    SchemeCacheStats cache = m_cache.getStats();
+
+    m_latency.write(os, "blockeditor_daemon_request_seconds");
+    os << "# TYPE blockeditor_daemon_requests_total counter\n"
+       << "blockeditor_daemon_requests_total{result=\"ok\"} " << m_ok.load() << "\n"
+       << "blockeditor_daemon_requests_total{result=\"error\"} " << m_errors.load() << "\n"
+       << "blockeditor_daemon_requests_total{result=\"deadline\"} " << m_missed.load() << "\n"
+       << "# TYPE blockeditor_daemon_cache_hits_total counter\n"
+       << "blockeditor_daemon_cache_hits_total " << cache.m_hits << "\n"
+       << "# TYPE blockeditor_daemon_cache_loads_total counter\n"
+       << "blockeditor_daemon_cache_loads_total " << cache.m_loads << "\n"
+       << "# TYPE blockeditor_daemon_cache_evictions_total counter\n"
+       << "blockeditor_daemon_cache_evictions_total " << cache.m_evictions << "\n"
+       << "# TYPE blockeditor_daemon_cache_schemes gauge\n"
+       << "blockeditor_daemon_cache_schemes " << cache.m_size << "\n";
+    return os.str();
+  }
+}
@@ -0,0 +1,125 @@
+/**
+ *		@file 		EvalServer.hpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Evaluation of cached schemes for clients of UNIX socket
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "../BoundedQueue.hpp"
+#include "../SchemeCache.hpp"
+
+///
+/// Namespace with implementation of evaluation server
+///
+namespace BlockEditorServer
+{
+  using namespace BlockEditorLogic;
+
+  using Clock = std::chrono::steady_clock;
+
+  ///
+  /// Histogram of request latencies with fixed buckets, updated without
+  /// locks from any thread
+  ///
+  class CLatencyHistogram
+  {
+  public:
+    static const size_t BUCKETS = 14;
+
+    CLatencyHistogram();
+
+    void          add(Clock::duration);
+    void          write(std::ostream&, const std::string& name) const;
+
+  private:
+    std::atomic<uint64_t>     m_counts[BUCKETS + 1];  /**< Last one is +Inf */
+    std::atomic<uint64_t>     m_totalNs{0};
+  };
+
+  ///
+  /// Options of server
+  ///
+  struct ServerOptions
+  {
+    std::string   m_socket;
+    unsigned      m_threads = 0;      /**< Evaluating threads, 0 means hardware threads */
+    size_t        m_cacheSize = 16;   /**< Schemes kept loaded */
+    size_t        m_queueDepth = 64;  /**< Requests waiting for evaluating thread */
+    unsigned      m_deadlineMs = 0;   /**< Deadline of requests without one, 0 is none */
+  };
+
+  ///
+  /// Server evaluating schemes on request. Each connection is served by
+  /// its own thread which reads requests line by line and answers them in
+  /// order, evaluation itself is done by the pool of evaluating threads.
+  /// Requests:
+  ///
+  ///   RUN <scheme> [deadline=<ms>] [in=<block>:<port>=<value>]... [out=<block>]...
+  ///   STATS
+  ///
+  /// RUN is answered by "OK <n>" and n lines "<block> <value>...", by
+  /// results of blocks with unconnected output if no out= was given.
+  /// STATS is answered by "OK <n>" and n lines of stats in Prometheus text
+  /// format. Failed request is answered by "ERR <message>".
+  ///
+  class CEvalServer
+  {
+  public:
+    explicit CEvalServer(const ServerOptions&);
+    ~CEvalServer();
+
+    void          serve();
+    void          stop();
+
+  private:
+    ///
+    /// Evaluation waiting for evaluating thread
+    ///
+    struct Task
+    {
+      std::string               m_file;
+      std::vector<InputValue>   m_inputs;
+      std::vector<ID>           m_outputs;
+      Clock::time_point         m_received;
+      Clock::time_point         m_deadline;     /**< max() if none */
+      std::promise<std::string> m_response;
+    };
+    using TaskPtr = std::shared_ptr<Task>;
+
+    void          work();
+    void          serveConnection(int fd);
+    std::string   handle(const std::string& line);
+    std::string   evaluate(Task& task, CEvalContext& ctx);
+    std::string   stats() const;
+
+    ServerOptions             m_options;
+    int                       m_listen;       /**< Listening socket */
+    std::atomic<bool>         m_stopped{false};
+    CSchemeCache              m_cache;
+    CBoundedQueue<TaskPtr>    m_tasks;
+    std::vector<std::thread>  m_workers;
+
+    std::mutex                m_connMutex;
+    std::condition_variable   m_connClosed;
+    std::unordered_set<int>   m_connections;  /**< Open connections, shut down by stop() */
+
+    CLatencyHistogram         m_latency;
+    std::atomic<uint64_t>     m_ok{0};
+    std::atomic<uint64_t>     m_errors{0};
+    std::atomic<uint64_t>     m_missed{0};     /**< Requests past their deadline */
+  };
+}
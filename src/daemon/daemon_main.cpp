@@ -0,0 +1,137 @@
+/**
+ *		@file 		daemon_main.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Long running server evaluating schemes, see CEvalServer
+ */
+
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+
+#include "EvalServer.hpp"
+#include "../SchemeTrace.hpp"
+
+using namespace BlockEditorServer;
+
+/**
+ * @brief Prints usage of the server
+ */
+static void usage()
+{
+  std::cerr << "Usage:\n"
+            << "  blockeditor-daemon -s <socket> [-j <threads>] [-c <schemes>] [-q <depth>]\n"
+            << "                     [-d <ms>] [-t <file>]\n"
+            << "\n"
+            << "  -s  UNIX socket to listen on\n"
+            << "  -j  evaluating threads (default hardware threads)\n"
+            << "  -c  schemes kept loaded (default 16)\n"
+            << "  -q  requests waiting for evaluating thread (default 64)\n"
+            << "  -d  deadline of requests which dont set one, in ms (default none)\n"
+            << "  -t  write Chrome trace to file at exit (needs make TRACE=1)\n"
+            << "\n"
+            << "Requests, one per line:\n"
+            << "  RUN <scheme> [deadline=<ms>] [in=<block>:<port>=<value>]... [out=<block>]...\n"
+            << "  STATS\n";
+}
+
+int main(int argc, char *argv[])
+{
+  std::vector<std::string> args(argv + 1, argv + argc);
+  ServerOptions options;
+  std::string trace;
+
+  try
+  {
+    for (std::size_t i = 0; i < args.size(); i++)
+    {
+      if (i + 1 < args.size() && args[i] == "-s")
+      {
+        options.m_socket = args[++i];
+      }
+      else if (i + 1 < args.size() && args[i] == "-j")
+      {
+        options.m_threads = std::stoul(args[++i]);
+      }
+      else if (i + 1 < args.size() && args[i] == "-c")
+      {
+        options.m_cacheSize = std::stoul(args[++i]);
+      }
+      else if (i + 1 < args.size() && args[i] == "-q")
+      {
+        options.m_queueDepth = std::stoul(args[++i]);
+      }
+      else if (i + 1 < args.size() && args[i] == "-d")
+      {
+        options.m_deadlineMs = std::stoul(args[++i]);
+      }
+      else if (i + 1 < args.size() && args[i] == "-t")
+      {
+        trace = args[++i];
+      }
+      else
+      {
+        usage();
+        return 1;
+      }
+    }
+  }
+  catch (std::exception&)
+  {
+    usage();
+    return 1;
+  }
+  if (options.m_socket.empty())
+  {
+    usage();
+    return 1;
+  }
+
+  // Signals are taken by one thread only, all threads inherit the mask
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  try
+  {
+    if (!trace.empty())
+    {
+      CTracer::start(trace);
+    }
+
+    CEvalServer server(options);
+    std::thread waiter([&server, &signals] {
+      int sig = 0;
+      sigwait(&signals, &sig);
+      server.stop();
+    });
+
+    // Server is destroyed only after the waiter is done with it
+    std::cerr << "Listening on " << options.m_socket << std::endl;
+    try
+    {
+      server.serve();
+    }
+    catch (...)
+    {
+      pthread_kill(waiter.native_handle(), SIGTERM);
+      waiter.join();
+      throw;
+    }
+    waiter.join();
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 2;
+  }
+
+  CTracer::stop();
+  return 0;
+}
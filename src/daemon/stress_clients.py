@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+#
+# @file    stress_clients.py
+# @date    19/10/2026
+# @author  Filip Kocica <xkocic01@fit.vutbr.cz>
+# @brief   Starts blockeditor-daemon and sends requests from parallel
+#          clients, replies to the same request have to be the same.
+#          'make tsan-check' runs it with the daemon built with
+#          ThreadSanitizer, which exits with an error on a data race.
+#
+# Usage: stress_clients.py <daemon> <scheme> [-c <clients>] [-r <requests>]
+#                          [-j <threads>] [-i <block>:<port>=<value>]...
+#
+
+import argparse
+import os
+import signal
+import socket
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+
+def connect(path, timeout):
+    """Connects to the socket, waits until the daemon listens."""
+    end = time.time() + timeout
+    while True:
+        s = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        try:
+            s.connect(path)
+            return s
+        except OSError:
+            s.close()
+            if time.time() > end:
+                raise
+            time.sleep(0.05)
+
+
+def request(f, line):
+    """Sends one request, returns the reply with all its lines."""
+    f.write(line + "\n")
+    f.flush()
+    head = f.readline()
+    if not head.startswith("OK "):
+        raise RuntimeError("%s: %s" % (line, head.strip() or "connection closed"))
+    return head + "".join(f.readline() for _ in range(int(head.split()[1])))
+
+
+def client(path, requests, count, replies, errors, n):
+    try:
+        with connect(path, 10) as s, s.makefile("rw") as f:
+            for i in range(count):
+                # Clients start at different requests, so all of them run at once
+                line = requests[(n + i) % len(requests)]
+                reply = request(f, line)
+                if line != "STATS":
+                    replies.setdefault(line, set()).add(reply)
+    except Exception as e:
+        errors.append("client %d: %s" % (n, e))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Parallel clients of blockeditor-daemon")
+    parser.add_argument("daemon")
+    parser.add_argument("scheme")
+    parser.add_argument("-c", type=int, default=16, help="parallel clients (default 16)")
+    parser.add_argument("-r", type=int, default=100, help="requests of each client (default 100)")
+    parser.add_argument("-j", type=int, default=4, help="evaluating threads of the daemon (default 4)")
+    parser.add_argument("-i", action="append", default=[], help="input override of some requests")
+    args = parser.parse_args()
+
+    scheme = os.path.abspath(args.scheme)
+    requests = ["RUN " + scheme, "RUN %s deadline=10000" % scheme, "STATS"]
+    requests += ["RUN %s in=%s" % (scheme, i) for i in args.i]
+
+    tmp = tempfile.mkdtemp(prefix="blockeditor-stress-")
+    path = os.path.join(tmp, "daemon.sock")
+    daemon = subprocess.Popen([args.daemon, "-s", path, "-j", str(args.j), "-c", "2"])
+
+    replies, errors = {}, []
+    try:
+        threads = [threading.Thread(target=client, args=(path, requests, args.r, replies, errors, n))
+                   for n in range(args.c)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+    finally:
+        daemon.send_signal(signal.SIGTERM)
+        code = daemon.wait()
+        os.rmdir(tmp)
+
+    for line, r in sorted(replies.items()):
+        if len(r) != 1:
+            errors.append("%d different replies to %s" % (len(r), line))
+    if code != 0:
+        errors.append("daemon exited with %d" % code)
+
+    for e in errors:
+        print("Error: " + e, file=sys.stderr)
+    print("Clients:  %d, %d requests each, %d errors" % (args.c, args.r, len(errors)))
+    return 1 if errors else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
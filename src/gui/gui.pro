@@ -27,6 +27,9 @@ DEFINES += QT_DEPRECATED_WARNINGS
 
 QMAKE_CXXFLAGS += -std=c++14
 
+# make TRACE=1, spans of the GUI are recorded too
+trace: DEFINES += BLOCKEDITOR_TRACE
+
 SOURCES += \
     ui_block.cpp \
     ui_main.cpp \
@@ -34,6 +37,7 @@ SOURCES += \
     mainwindow.cpp \
     ui_blockscheme.cpp \
     ui_blocklist.cpp \
+    ui_canvas.cpp \
     ui_compute.cpp \
     ui_port.cpp
 
@@ -45,6 +49,7 @@ HEADERS += \
     mainwindow.hpp \
     ui_blockscheme.hpp \
     ui_blocklist.hpp \
+    ui_canvas.hpp \
     ui_blocktype.hpp \
     ui_compute.hpp \
     ui_forward_declare.hpp \
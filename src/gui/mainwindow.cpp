@@ -14,11 +14,13 @@
 
 #include "ui_block.hpp"
 #include "ui_blocktype.hpp"
+#include "ui_connection.hpp"
+#include "ui_canvas.hpp"
 
 
 using namespace gui;
 
-/// Instatiates block_list, coputation, block_scheme and cursor.
+/// Instatiates block_list, coputation, block_scheme, cursor, connection_layer and canvas.
 /// @note Initialy generated using QtCreator. Modified by hand.
 
 MainWindow::MainWindow(QWidget *parent) :
@@ -30,10 +32,16 @@ MainWindow::MainWindow(QWidget *parent) :
     // Set white background
     ui->scrollAreaWidgetContents->setStyleSheet("background-color: rgb(230,230,230)");
 
-    block_list = new BlockList;
+    block_list = new BlockList(this);
     computation = new Compute(this);
     block_scheme = new BlockScheme(this);
     cursor = new Cursor;
+    connection_layer = new ConnectionLayer(ui->frame, this);
+
+    // takes place of the board when a large scheme is loaded
+    canvas = new SchemeCanvas(ui->centralWidget, this);
+    ui->verticalLayout->addWidget(canvas);
+    canvas->hide();
 
     setWindowTitle("Block Editor");
 
@@ -62,6 +70,9 @@ MainWindow::MainWindow(QWidget *parent) :
 /// @note Initialy generated using QtCreator. Modified by hand.
 MainWindow::~MainWindow()
 {
+    // closed without saving, unsaved edits are dropped from the journal
+    block_scheme->block_scheme.closeJournal();
+
     // delete all blocks
     block_list->delete_all();
 
@@ -174,8 +185,12 @@ void MainWindow::on_actionClear_triggered()
     // stop computation in case one is in progress
     computation->stop_computation();
 
-    // wipe all blocks
+    // wipe all blocks, the logic block scheme is cleared at once
     block_list->delete_all();
+
+    // blocks of the canvas exist only in the logic block scheme
+    canvas->clear();
+    show_canvas(false);
 }
 
 /// Save button clicked.
@@ -207,6 +222,16 @@ void gui::MainWindow::on_actionLoad_triggered()
     block_scheme->load_scheme(ui->frame, file.toStdString());
 }
 
+/**
+ * @brief Show the canvas instead of the board, or the board again.
+ * @param show True to show the canvas.
+ */
+void gui::MainWindow::show_canvas(bool show)
+{
+    ui->scrollArea->setVisible(!show);
+    canvas->setVisible(show);
+}
+
 /// Disables add/delete for computation.
 void gui::MainWindow::disable_editing()
 {
@@ -228,7 +253,7 @@ void gui::MainWindow::enable_editing()
 void gui::MainWindow::on_actionRun_triggered()
 {
     // if there are any blocks
-    if (!block_list->empty())
+    if (!block_list->empty() || !canvas->empty())
         if (computation->run_computation())
             disable_editing();
 }
@@ -238,7 +263,7 @@ void gui::MainWindow::on_actionRun_triggered()
 void gui::MainWindow::on_actionStep_triggered()
 {
     // if there are any blocks
-    if (!block_list->empty())
+    if (!block_list->empty() || !canvas->empty())
         if (computation->next_step())
             if (allow_editing)  // Used instead of can_edit, because of popup window
                 disable_editing();
@@ -293,15 +318,55 @@ void gui::MainWindow::on_actionSelect_pow_toggled(bool enabled)
     }
 }
 
-/// Checks if we can edit scheme (scheme is not running)
+/// Sum block selected.
+void gui::MainWindow::on_actionSelect_sum_toggled(bool enabled)
+{
+    if (enabled)
+    {
+        cursor->set_cursor(CURSOR_PLACE);
+        cursor->select_block(BLOCK_SUM);
+    }
+}
+
+/// Product block selected.
+void gui::MainWindow::on_actionSelect_product_toggled(bool enabled)
+{
+    if (enabled)
+    {
+        cursor->set_cursor(CURSOR_PLACE);
+        cursor->select_block(BLOCK_PRODUCT);
+    }
+}
+
+/// Min block selected.
+void gui::MainWindow::on_actionSelect_min_toggled(bool enabled)
+{
+    if (enabled)
+    {
+        cursor->set_cursor(CURSOR_PLACE);
+        cursor->select_block(BLOCK_MIN);
+    }
+}
+
+/// Max block selected.
+void gui::MainWindow::on_actionSelect_max_toggled(bool enabled)
+{
+    if (enabled)
+    {
+        cursor->set_cursor(CURSOR_PLACE);
+        cursor->select_block(BLOCK_MAX);
+    }
+}
+
+/// Called before the scheme is edited. Computation runs on a snapshot of the scheme,
+/// so editing is always allowed, results shown on blocks would be outdated and are hidden.
 /// @return True if scheme editing is allowed.
 bool gui::MainWindow::can_edit()
 {
   if (!allow_editing)
   {
-    QMessageBox err;
-    err.critical(0, "Cannot edit", "Modification is not allowed during computation. Press 'Stop' before editing.");
-    err.setFixedSize(500,200);
+    computation->scheme_edited();
+    enable_editing();
   }
 
   return allow_editing;
@@ -38,8 +38,11 @@ namespace gui {
         BlockList *block_list;      ///< The only BlockList instance in the program.
         BlockScheme *block_scheme;  ///< The only BlockSheme instance in the program.
         Cursor *cursor;             ///< The only Cursor instance in the program.
+        ConnectionLayer *connection_layer; ///< Paints all connections of the board.
+        SchemeCanvas *canvas;       ///< Shows large schemes instead of the board.
 
         bool can_edit();
+        void show_canvas(bool show);
 
     private slots:
 
@@ -60,6 +63,10 @@ namespace gui {
         void on_actionFloat_seleted_toggled(bool);
         void on_actionHex_selected_toggled(bool);
         void on_actionSelect_pow_toggled(bool);
+        void on_actionSelect_sum_toggled(bool);
+        void on_actionSelect_product_toggled(bool);
+        void on_actionSelect_min_toggled(bool);
+        void on_actionSelect_max_toggled(bool);
 
     private:
         Ui::MainWindow *ui; ///< pointer to the main window
@@ -8,8 +8,10 @@
 
 #include "ui_block.hpp"
 #include "ui_blocktype.hpp"
+#include "ui_connection.hpp"
 #include <QMenu>
 #include <QAction>
+#include <QStatusBar>
 
 using namespace gui;
 
@@ -21,12 +23,16 @@ using namespace gui;
  * @param t     Type of the block.
  * @param vt    Type of the block value.
  * @param loc   Screen location.
+ * @param logic_id ID of a block already present in the logic block scheme (loading). Negative to add a new one.
  */
-Block::Block(QWidget *parent, MainWindow* ui, BlockType t, ValueType vt, QPoint loc)
+Block::Block(QWidget *parent, MainWindow* ui, BlockType t, ValueType vt, QPoint loc, int logic_id)
     : QPushButton(parent), ui(ui), type(t), value_type(vt)
 {
-    // add into the logic block scheme
-    this->id = ui->block_scheme->add_block(type, value_type);
+    // add into the logic block scheme, unless it is there already
+    if (logic_id < 0)
+        this->id = ui->block_scheme->add_block(type, value_type);
+    else
+        this->id = logic_id;
 
     if (id == -1)
     {
@@ -60,6 +66,11 @@ Block::Block(QWidget *parent, MainWindow* ui, BlockType t, ValueType vt, QPoint
     loc.rx() -= size/2;
     loc.ry() -= size/2;
     this->move(loc);
+
+    // a new block may be saved before it is ever dragged
+    if (logic_id < 0)
+        ui->block_scheme->move_block(this);
+
     this->setStyleSheet(color_default + "font-size: 11px; border: 1px solid black; outline: none;");
     set_text(type, value_type);
     this->show();
@@ -87,6 +98,7 @@ Block::~Block()
 
     // remove from the block list
     ui->block_list->remove(id);
+    ui->connection_layer->cancel_move(this);
 
     // remove from the logic block scheme
     ui->block_scheme->remove_block(id);
@@ -97,32 +109,48 @@ Block::~Block()
  * @param t Type of the block.
  */
 void Block::set_text(BlockType t, ValueType vt)
+{
+    this->setText(type_text(t, vt));
+}
+
+/**
+ * @brief Text shown on a block, operation and value type.
+ * @param t Type of the block.
+ * @param vt Value type of the block.
+ * @return Text, e.g. "+\nFLT".
+ */
+QString Block::type_text(BlockType t, ValueType vt)
 {
     switch(t) {
         case BLOCK_ADD:
-            this->setText("+\n" +  valtype_to_str(vt));
-            break;
+            return "+\n" + valtype_to_str(vt);
         case BLOCK_SUB:
-            this->setText("-\n" + valtype_to_str(vt));
-            break;
+            return "-\n" + valtype_to_str(vt);
         case BLOCK_MUL:
-            this->setText("*\n" + valtype_to_str(vt));
-            break;
+            return "*\n" + valtype_to_str(vt);
         case BLOCK_DIV:
-            this->setText("/\n" + valtype_to_str(vt));
-            break;
+            return "/\n" + valtype_to_str(vt);
         case BLOCK_POW:
-            this->setText("^\n" + valtype_to_str(vt));
-            break;
+            return "^\n" + valtype_to_str(vt);
+        case BLOCK_SUM:
+            return "sum\n" + valtype_to_str(vt);
+        case BLOCK_PRODUCT:
+            return "prod\n" + valtype_to_str(vt);
+        case BLOCK_MIN:
+            return "min\n" + valtype_to_str(vt);
+        case BLOCK_MAX:
+            return "max\n" + valtype_to_str(vt);
+        case BLOCK_MACRO:
+            return "macro\n" + valtype_to_str(vt);
         default:
-            std::cerr << "Warning: Block::set_text: Unknown block type." << std::endl;
-            this->setText("?\n" + valtype_to_str(vt));
-            break;
+            std::cerr << "Warning: Block::type_text: Unknown block type." << std::endl;
+            return "?\n" + valtype_to_str(vt);
     }
 }
 
 /**
- * @brief Allows block repositioning using mouse dragging.
+ * @brief Allows block repositioning using mouse dragging. The block is
+ *        moved with the next display refresh, together with its connections.
  * @param event Not used.
  */
 void Block::mouseMoveEvent(QMouseEvent *event)
@@ -151,15 +179,7 @@ void Block::mouseMoveEvent(QMouseEvent *event)
 
             mouse_loc.rx() -= size/2;
             mouse_loc.ry() -= size/2;
-            move(mouse_loc);
-
-            // reposition connection lines
-            if (port_one->connected())
-                port_one->get_connection()->reposition();
-            if (port_two->connected())
-                port_two->get_connection()->reposition();
-            if (port_out->connected())
-                port_out->get_connection()->reposition();
+            ui->connection_layer->schedule_move(this, mouse_loc);
         }
 }
 
@@ -178,7 +198,7 @@ void Block::mousePressEvent(QMouseEvent *event)
         // delete
         if (ui->cursor->get_ctype() == CURSOR_DELETE && ui->can_edit())
         {
-            delete this;
+            delete_block();
         }
     }
     // right click
@@ -195,14 +215,36 @@ void Block::mousePressEvent(QMouseEvent *event)
             contextMenu.addAction(&action2);
         }
 
+        // queued, the menu and its actions are children of the block
         QAction action1("Delete", this);
-        connect(&action1, SIGNAL(triggered()), this, SLOT(deleteLater()));
+        connect(&action1, SIGNAL(triggered()), this, SLOT(delete_block()), Qt::QueuedConnection);
         contextMenu.addAction(&action1);
 
         contextMenu.exec(mapToGlobal(event->pos()));
     }
 }
 
+/**
+ * @brief Stores the position of the block after it was dragged.
+ * @param event Event type.
+ */
+void Block::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (hold_triggered)
+    {
+        // the last position may still wait for the display refresh
+        ui->connection_layer->flush_moves();
+        ui->block_scheme->move_block(this);
+
+        ui->statusBar()->showMessage(QString("Drag latency %1 ms, max %2 ms")
+                                     .arg(ui->connection_layer->get_latency(), 0, 'f', 1)
+                                     .arg(ui->connection_layer->get_latency_max(), 0, 'f', 1), 3000);
+        ui->connection_layer->reset_latency();
+    }
+
+    QPushButton::mouseReleaseEvent(event);
+}
+
 /**
  * @brief Catches events. Used to get the tap and hold event.
  * @param event Event type.
@@ -233,6 +275,12 @@ bool Block::gestureEvent(QGestureEvent *event)
 
 /// Convert value (double) to a string
 QString Block::value_to_string(double val)
+{
+    return value_to_string(val, value_type);
+}
+
+/// Convert value (double) of given value type to a string
+QString Block::value_to_string(double val, ValueType vt)
 {
     // convert value to string
     std::string s = std::to_string(val);
@@ -261,23 +309,58 @@ QString Block::value_to_string(double val)
 
     str = str.fromStdString(s);
     // If its hex value, convert it to 16 base
-    if (value_type == HEX)
+    if (vt == HEX)
     {
-      str = QString::number(str.toInt(), 16).toUpper();
+      str = QString::number(str.toLongLong(), 16).toUpper();
     }
 
     return str;
 }
 
+/// Convert scalar result of a block to a string, results of INT & HEX blocks are exact
+QString Block::result_to_string(const BlockEditorLogic::CBlockAction& action, ValueType vt)
+{
+    if (!action.isInteger())
+        return value_to_string(action.getValue(), vt);
+
+    qlonglong val = action.getInteger();
+    return vt == HEX ? QString::number(val, 16).toUpper() : QString::number(val);
+}
+
 /**
  * @brief   Display computation results for this block.
- * @details Creates two label covering the whole block. One shows the blok type and the other shows the result.
  * @param val   Result to be displayed.
  */
 void Block::display_result(double val)
 {
-    QString str = value_to_string(val);
+    show_result(value_to_string(val));
+}
+
+/**
+ * @brief   Display computation results for this block.
+ * @details Arrays are shown by their length on the block, the summary is shown on hover.
+ * @param action   Computed result to be displayed.
+ */
+void Block::display_result(const BlockEditorLogic::CBlockAction& action)
+{
+    if (!action.hasArray())
+    {
+        show_result(result_to_string(action, value_type));
+        return;
+    }
+
+    BlockEditorLogic::PortArrayPtr pa = action.getArray();
+    value_summary = QString::fromStdString(BlockEditorLogic::summarizeArray(*pa));
+    show_result("[" + QString::number(pa->size()) + "]");
+}
 
+/**
+ * @brief   Display computation results for this block.
+ * @details Creates two label covering the whole block. One shows the blok type and the other shows the result.
+ * @param str   Result to be displayed.
+ */
+void Block::show_result(QString str)
+{
     value_label = new QLabel(this);
     value_label->setText(str);
     value_label->move(0,size/2);
@@ -292,7 +375,6 @@ void Block::display_result(double val)
     value_label->show();
 
     type_label = new QLabel(this);
-    type_label->setText("+");
     type_label->resize(size, size/2);
     type_label->setStyleSheet("background-color: rgb(255,255,255);border-radius: 2px; border: 2px solid black;");
     type_label->setStyleSheet(
@@ -302,27 +384,7 @@ void Block::display_result(double val)
     );
     type_label->setAlignment(Qt::AlignCenter);
 
-    switch(type) {
-        case BLOCK_ADD:
-            type_label->setText("+\n" + valtype_to_str(value_type));
-            break;
-        case BLOCK_SUB:
-            type_label->setText("-\n" + valtype_to_str(value_type));
-            break;
-        case BLOCK_MUL:
-            type_label->setText("*\n" + valtype_to_str(value_type));
-            break;
-        case BLOCK_DIV:
-            type_label->setText("/\n" + valtype_to_str(value_type));
-            break;
-        case BLOCK_POW:
-            type_label->setText("^\n" + valtype_to_str(value_type));
-            break;
-        default:
-            std::cerr << "Warning: Block::display_result: Unknown block type." << std::endl;
-            this->setText("?\n" + valtype_to_str(value_type));
-            break;
-    }
+    type_label->setText(type_text(type, value_type));
     type_label->show();
 
     connect(&remove_highlight, SIGNAL(timeout()), this, SLOT(removeHighlight()));
@@ -355,6 +417,7 @@ void Block::hide_result()
         delete type_label;
         delete value_label;
     }
+    value_summary.clear();
     result_allocated = false;
 }
 
@@ -384,6 +447,12 @@ QPoint Block::pos() const
     return p;
 }
 
+/// Delete the block, it is removed from the logic block scheme the same way as a selection.
+void Block::delete_block()
+{
+    ui->block_list->delete_blocks({this});
+}
+
 /// Disconnect all connected ports
 void Block::disconnect_all()
 {
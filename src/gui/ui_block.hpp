@@ -26,7 +26,7 @@ namespace gui {
         Q_OBJECT
 
     public:
-        Block(QWidget *parent, MainWindow* ui, BlockType t, ValueType vt, QPoint mouse_loc);
+        Block(QWidget *parent, MainWindow* ui, BlockType t, ValueType vt, QPoint mouse_loc, int logic_id = -1);
         virtual ~Block();
 
         /// @return Block type
@@ -40,13 +40,19 @@ namespace gui {
         int get_id() const {return id;}
         /// @return Result value as string
         QString getValueString() {return value_label->text();}
+        /// @return Result value as string, summarized if the result is an array
+        QString getValueSummary() {return value_summary.isEmpty() ? value_label->text() : value_summary;}
         /// @return Result type as string
 	QString getTypeString() {return type_label->text();}
         /// @return Value type
 	ValueType getTypeName() {return value_type;}
         QString value_to_string(double val);
+        static QString value_to_string(double val, ValueType vt);
+        static QString result_to_string(const BlockEditorLogic::CBlockAction& action, ValueType vt);
+        static QString type_text(BlockType t, ValueType vt);
 
         void display_result(double val);
+        void display_result(const BlockEditorLogic::CBlockAction& action);
         void hide_result();
         /// @return True if there are results shown on the block
         bool has_result() {return result_allocated;}
@@ -60,7 +66,9 @@ namespace gui {
 
         void mouseMoveEvent(QMouseEvent *);
         void mousePressEvent(QMouseEvent *);
+        void mouseReleaseEvent(QMouseEvent *);
         void disconnect_all();
+        void delete_block();
 
     private slots:
         void removeHighlight();
@@ -76,6 +84,9 @@ namespace gui {
         bool result_allocated = false;
         QLabel *value_label = NULL; ///< to show compute results
         QLabel *type_label = NULL; ///< to show compute results
+        QString value_summary;     ///< Summary of the result, if the result is an array
+
+        void show_result(QString str);
 
         ValueType value_type; ///< Type of the block value
 
@@ -84,9 +95,9 @@ namespace gui {
         bool gestureEvent(QGestureEvent *event);
         bool hold_triggered = false; ///< tap and hold event flag
 
-        const int size = 70;    /// predefined block size
+        static const int size = 70;    /// predefined block size
 
-        QString valtype_to_str(ValueType vt);
+        static QString valtype_to_str(ValueType vt);
 
     protected:
         virtual bool event(QEvent *event);
@@ -6,51 +6,103 @@
  */
 
 #include "ui_blocklist.hpp"
+#include "ui_connection.hpp"
 #include <algorithm>
 #include <iostream>
 
 using namespace gui;
 
+/**
+ * @brief   Add a block to the list.
+ * @param b Block to add, its ID must be set already.
+ */
+void BlockList::add(Block* b)
+{
+    index[b->get_id()] = block_list.size();
+    block_list.push_back(b);
+}
+
 /**
  * @brief   Remove a block from the list.
+ * @details The last block takes place of the removed one, order of the list is not kept.
  * @param id ID of the block to remove.
  */
 void BlockList::remove(int id)
 {
-    for (auto i = block_list.begin(); i != block_list.end(); i++)
+    auto it = index.find(id);
+    if (it == index.end())
     {
-      if ((*i)->get_id() == id)
-      {
-          block_list.erase(i);
-          return ;
-      }
+        std::cerr << "Failed to remove block with ID: " << id << "." << std::endl;
+        return ;
     }
 
-    std::cerr << "Failed to remove block with ID: " << id << "." << std::endl;
+    size_t pos = it->second;
+    index.erase(it);
+
+    if (pos != block_list.size() - 1)
+    {
+        block_list[pos] = block_list.back();
+        index[block_list[pos]->get_id()] = pos;
+    }
+    block_list.pop_back();
 }
 
 /**
  * @brief Find a block in the list.
  * @param id ID of the block to find.
- * @return Pointer to the block.
+ * @return Pointer to the block, NULL if there is none.
  */
 Block* BlockList::find(int id)
 {
-    for (auto i : block_list)
-    {
-        if (i->get_id() == id)
-            return i;
-    }
-    return NULL;
+    auto it = index.find(id);
+    return it == index.end() ? NULL : block_list[it->second];
+}
+
+/**
+ * @brief Prepare the list for n more blocks, used when loading a scheme.
+ * @param n Count of blocks to be added.
+ */
+void BlockList::reserve(size_t n)
+{
+    block_list.reserve(block_list.size() + n);
+    index.reserve(index.size() + n);
+}
+
+/**
+ * @brief   Delete a selection of blocks.
+ * @details The blocks are removed from the logic block scheme in one pass,
+ *          then only their widgets are destroyed.
+ * @param blocks Blocks to delete.
+ */
+void BlockList::delete_blocks(std::vector<Block*> blocks)
+{
+    std::vector<BlockEditorLogic::ID> ids;
+    ids.reserve(blocks.size());
+    for (Block *b : blocks)
+        ids.push_back(b->get_id());
+
+    if (!ui->block_scheme->remove_blocks(ids))
+        return;
+
+    ui->block_scheme->set_detached(true);
+    for (Block *b : blocks)
+        delete b;
+    ui->block_scheme->set_detached(false);
 }
 
 /**
  * @brief Deletes all blocks inside of the list. "Delete" meaning physicaly destroy
+ * @details The logic block scheme is cleared at once, blocks of the canvas included.
  */
 void BlockList::delete_all()
 {
+    ui->block_scheme->remove_all_blocks();
+    ui->connection_layer->clear();
+
+    ui->block_scheme->set_detached(true);
     while (!block_list.empty())
     {
         delete (block_list.back());
     }
+    ui->block_scheme->set_detached(false);
 }
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <unordered_map>
+
 #include "ui_block.hpp"
 
 namespace gui {
@@ -15,12 +17,22 @@ namespace gui {
     class BlockList
     {
     public:
-        void add(Block* b){block_list.push_back(b);}
+        BlockList(MainWindow *ui) : ui(ui) {}
+
+        void add(Block* b);
         Block* find(int id);
         void remove(int id);
+        void reserve(size_t n);
+        void delete_blocks(std::vector<Block*> blocks);
         void delete_all();
         bool empty() {return block_list.empty();}
 
         std::vector<Block*> block_list;
+
+    private:
+        MainWindow *ui;
+
+        /// Position of the block in block_list by its ID
+        std::unordered_map<int, size_t> index;
     };
 }
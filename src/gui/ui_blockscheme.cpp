@@ -11,12 +11,15 @@
 #include <QMessageBox>
 
 #include "ui_connection.hpp"
+#include "ui_canvas.hpp"
+#include <QFileInfo>
 #include "cassert"
 
 #include "../Port.hpp"
 #include "../BlockAction.hpp"
 #include "../BlockEditorException.hpp"
 #include "../TypeName.hpp"
+#include "../SchemeTrace.hpp"
 
 using namespace gui;
 
@@ -45,8 +48,9 @@ int BlockScheme::add_block(BlockType t, ValueType vt)
 /**
  * @brief Insert value into a port in the logic block scheme.
  * @param s Port to set the value to.
+ * @return  False if the value could not be assigned.
  */
-void BlockScheme::set_port_value(Port *s)
+bool BlockScheme::set_port_value(Port *s)
 {
     BlockEditorLogic::Ports in_type;
     if (s->get_type() == TOP_IN)
@@ -58,14 +62,38 @@ void BlockScheme::set_port_value(Port *s)
 
     try
     {
-      block_scheme.addInputValue(s->get_block()->get_id(), s->get_value(), in_type);
+      if (s->has_value_file())
+        block_scheme.addInputArray(s->get_block()->get_id(), s->get_value_file().toStdString(), in_type);
+      else
+        block_scheme.addInputValue(s->get_block()->get_id(), s->get_value(), in_type);
     }
     catch(BlockEditorLogic::CBlockEditorException& e)
     {
       QMessageBox err;
       err.critical(0, "ERROR", e.what());
       err.setFixedSize(500,200);
+      return false;
     }
+    return true;
+}
+
+/**
+ * @brief Describe value assigned to a port. Arrays of values are summarized.
+ * @param s Port with the value.
+ * @return  Description of the value.
+ */
+QString BlockScheme::port_value_summary(Port *s)
+{
+    try
+    {
+      return QString::fromStdString(block_scheme.getInputSummary(s->get_block()->get_id(),
+        (s->get_type() == TOP_IN ? BlockEditorLogic::Ports::P_INPUT1 : BlockEditorLogic::Ports::P_INPUT2)));
+    }
+    catch(BlockEditorLogic::CBlockEditorException& e)
+    {
+      std::cerr << "port_value_summary: " << e.what() << std::endl;
+    }
+    return QString();
 }
 
 /**
@@ -93,6 +121,9 @@ void BlockScheme::remove_port_value(Port *s)
  */
 void BlockScheme::remove_block(int id)
 {
+    if (detached)
+        return;
+
     try
     {
       block_scheme.removeBlock(id);
@@ -105,6 +136,36 @@ void BlockScheme::remove_block(int id)
     }
 }
 
+/**
+ * @brief Remove blocks from the logic block scheme at once, with their
+ *        connections and port values.
+ * @param ids IDs of the blocks to delete.
+ * @return False if the blocks could not be removed, nothing was removed then.
+ */
+bool BlockScheme::remove_blocks(const std::vector<BlockEditorLogic::ID>& ids)
+{
+    try
+    {
+      block_scheme.removeBlocks(ids);
+    }
+    catch(BlockEditorLogic::CBlockEditorException& e)
+    {
+      QMessageBox err;
+      err.critical(0, "ERROR", e.what());
+      err.setFixedSize(500,200);
+      return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Remove all blocks from the logic block scheme.
+ */
+void BlockScheme::remove_all_blocks()
+{
+    block_scheme.removeAllBlocks();
+}
+
 /**
  * @brief Insert a connection into the logic block scheme.
  * @param from  Output port.
@@ -134,6 +195,9 @@ void BlockScheme::add_connection(Port *from, Port *to)
  */
 void BlockScheme::remove_connection(Port *from, Port *to)
 {
+    if (detached)
+        return;
+
     int id_from, id_to;
     BlockEditorLogic::Ports in_type;
 
@@ -159,11 +223,55 @@ void BlockScheme::remove_connection(Port *from, Port *to)
 }
 
 /**
- * @brief Trigger block scheme saving.
+ * @brief Store new block position in the logic block scheme.
+ * @param b Moved block.
+ */
+void BlockScheme::move_block(Block *b)
+{
+    move_block(b->get_id(), b->pos());
+}
+
+/**
+ * @brief Store new block position in the logic block scheme.
+ * @param id ID of the moved block.
+ * @param p  New position of the block center.
+ */
+void BlockScheme::move_block(int id, QPoint p)
+{
+    try
+    {
+      block_scheme.setPosition(id, {p.x(), p.y()});
+    }
+    catch(BlockEditorLogic::CBlockEditorException& e)
+    {
+      std::cerr << "move_block: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief Trigger block scheme saving. Saving into the file the scheme
+ *        was loaded from (or last saved to) only commits the edit journal.
  * @param file File name to save into (with path).
  */
 void BlockScheme::save_scheme(std::string file)
 {
+    TRACE_SPAN("BlockScheme::save_scheme");
+
+    if (block_scheme.isJournaled(file))
+    {
+        try
+        {
+          block_scheme.commitJournal();
+        }
+        catch(BlockEditorLogic::CBlockEditorException& e)
+        {
+          QMessageBox err;
+          err.critical(0, "ERROR", e.what());
+          err.setFixedSize(500,200);
+        }
+        return;
+    }
+
     BlockEditorLogic::CBlockScheme::Coords coords;
 
     // put all block locations into a container
@@ -175,10 +283,14 @@ void BlockScheme::save_scheme(std::string file)
         BlockEditorLogic::CBlockScheme::BlockCoord c {id, {p.x(), p.y()}};
         coords.push_back(c);
     }
+    ui->canvas->get_coords(coords);
 
     try
     {
       block_scheme.saveScheme(coords, file);
+
+      // following edits are recorded to the journal of the file
+      block_scheme.attachJournal(file);
     }
     catch(BlockEditorLogic::CBlockEditorException& e)
     {
@@ -204,6 +316,16 @@ BlockType BlockScheme::bltype_logic2gui(BlockEditorLogic::EBlockType t)
         return BLOCK_DIV;
     case BT_POW:
         return BLOCK_POW;
+    case BT_SUM:
+        return BLOCK_SUM;
+    case BT_PRODUCT:
+        return BLOCK_PRODUCT;
+    case BT_MIN:
+        return BLOCK_MIN;
+    case BT_MAX:
+        return BLOCK_MAX;
+    case BT_MACRO:
+        return BLOCK_MACRO;
     default:
         std::cerr << "Warning: bltype_logic2gui: Unknown block type. Returning default type." << std::endl;
         return BLOCK_ADD;
@@ -226,6 +348,16 @@ BlockEditorLogic::EBlockType BlockScheme::bltype_gui2logic(BlockType t)
         return BT_DIV;
     case BLOCK_POW:
         return BT_POW;
+    case BLOCK_SUM:
+        return BT_SUM;
+    case BLOCK_PRODUCT:
+        return BT_PRODUCT;
+    case BLOCK_MIN:
+        return BT_MIN;
+    case BLOCK_MAX:
+        return BT_MAX;
+    case BLOCK_MACRO:
+        return BT_MACRO;
     default:
         std::cerr << "Warning: bltype_gui2logic: Unknown block type. Returning default type." << std::endl;
         return BT_ADD;
@@ -238,8 +370,15 @@ BlockEditorLogic::EBlockType BlockScheme::bltype_gui2logic(BlockType t)
  */
 void BlockScheme::load_scheme(QWidget *window, std::string file)
 {
+    TRACE_SPAN("BlockScheme::load_scheme");
+
+    // unsaved edits of the current scheme are dropped
+    block_scheme.closeJournal();
+
     // clear the window by deleting all blocks
     ui->block_list->delete_all();
+    ui->canvas->clear();
+    ui->show_canvas(false);
 
       using namespace BlockEditorLogic;
 
@@ -247,7 +386,18 @@ void BlockScheme::load_scheme(QWidget *window, std::string file)
 
       try
       {
-        pb = block_scheme.loadScheme(file);
+        // the logic scheme is built once; gui only attaches to it
+        block_scheme.openScheme(file);
+
+        // edits which were not saved, left by a crash
+        size_t unsaved = block_scheme.unsavedEdits();
+        if (unsaved > 0 && QMessageBox::question(window, "Recover",
+                QString::number(unsaved) + " unsaved edits of this scheme were found. Recover them?") == QMessageBox::Yes)
+            block_scheme.recoverEdits();
+
+        // following edits are recorded to the journal of the file
+        block_scheme.attachJournal(file);
+        pb = block_scheme.getParts();
       }
       catch(BlockEditorLogic::CBlockEditorException& e)
       {
@@ -260,56 +410,115 @@ void BlockScheme::load_scheme(QWidget *window, std::string file)
         return;
       }
 
+      // widgets would be too slow for large schemes
+      if (pb.size() >= LARGE_SCHEME)
+      {
+        load_canvas(pb);
+        return;
+      }
+
       BlockType t;
 
+      ui->block_list->reserve(pb.size());
+
       /// First create all blocks
       for (auto& it : pb)
       {
         /// Logic block type to gui block type
         t = bltype_logic2gui(it.m_bt);
 
-        /// Save loaded position
-        QPoint p(it.m_coords.first, it.m_coords.second);
-
-        /// Set ID counter correctly
-        block_scheme.setID(it.m_blockID);
+        /// Loaded position is the top left corner, Block is placed by its center
+        QPoint p(it.m_coords.first + Block::size/2, it.m_coords.second + Block::size/2);
 
-        ValueType vt;
-        if (it.m_tn == "FLT") vt = FLOAT;
-        else if (it.m_tn == "INT") vt = INT;
-        else vt = HEX;
+        ValueType vt = valtype_logic2gui(it.m_tn);
 
-        /// Add new block
-        new Block(window, ui, t, vt, p);
+        /// Add new block which already exists in the logic scheme
+        new Block(window, ui, t, vt, p, it.m_blockID);
       }
 
-      /// In second iteration connect blocks together
+      /// In second iteration show connections and values
       for (auto& it : pb)
       {
-          Block *bl = ui->block_list->find(it.m_blockID);
+        Block *bl = ui->block_list->find(it.m_blockID);
 
         if (it.m_inPort1 == VALUE)
         {
-            bl->port_one->set_value(it.m_inVal1);
+            if (!it.m_inFile1.empty())
+                bl->port_one->attach_value_file(QString::fromStdString(it.m_inFile1));
+            else
+                bl->port_one->attach_value(it.m_inVal1);
         }
         else if (it.m_inPort1 == CONNECTION)
         {
             Block *in_bl = ui->block_list->find(it.m_inBlock1);
-            new Connection(window, ui, in_bl->port_out, bl->port_one);
+            new Connection(window, ui, in_bl->port_out, bl->port_one, true);
         }
 
         if (it.m_inPort2 == VALUE)
         {
-          bl->port_two->set_value(it.m_inVal2);
+          if (!it.m_inFile2.empty())
+            bl->port_two->attach_value_file(QString::fromStdString(it.m_inFile2));
+          else
+            bl->port_two->attach_value(it.m_inVal2);
         }
         else if (it.m_inPort2 == CONNECTION)
         {
           Block *in_bl = ui->block_list->find(it.m_inBlock2);
-          new Connection(window, ui, in_bl->port_out, bl->port_two);
+          new Connection(window, ui, in_bl->port_out, bl->port_two, true);
         }
       }
 }
 
+/**
+ * @brief Show loaded scheme in the canvas instead of the board.
+ * @param pb Parts of the loaded scheme.
+ */
+void BlockScheme::load_canvas(const BlockEditorLogic::CBlockScheme::PartBuffer& pb)
+{
+    TRACE_SPAN("BlockScheme::load_canvas");
+    using namespace BlockEditorLogic;
+
+    auto input = [](const std::string& file, double val, ValueType vt) -> QString {
+        if (!file.empty())
+            return "File: " + QFileInfo(QString::fromStdString(file)).fileName();
+        return Block::value_to_string(val, vt);
+    };
+
+    /// First create all blocks
+    for (auto& it : pb)
+    {
+        ValueType vt = valtype_logic2gui(it.m_tn);
+
+        ui->canvas->add_block(it.m_blockID, bltype_logic2gui(it.m_bt), vt,
+                              QPoint(it.m_coords.first, it.m_coords.second),
+                              it.m_inPort1 == VALUE ? input(it.m_inFile1, it.m_inVal1, vt) : QString(),
+                              it.m_inPort2 == VALUE ? input(it.m_inFile2, it.m_inVal2, vt) : QString());
+    }
+
+    /// Then connect them
+    for (auto& it : pb)
+    {
+        if (it.m_inPort1 == CONNECTION)
+            ui->canvas->add_connection(it.m_inBlock1, it.m_blockID, true);
+        if (it.m_inPort2 == CONNECTION)
+            ui->canvas->add_connection(it.m_inBlock2, it.m_blockID, false);
+    }
+
+    ui->canvas->finish_loading();
+    ui->show_canvas(true);
+}
+
+/// Converts logic value type to Gui value type
+ValueType BlockScheme::valtype_logic2gui(const std::string& tn)
+{
+    if (tn == BlockEditorLogic::TN_INTEGER)
+        return INT;
+    else if (tn == BlockEditorLogic::TN_FLOAT)
+        return FLOAT;
+    else
+        return HEX;
+}
+
 /// Converts Gui value type to logic value type
 std::string BlockScheme::valtype_gui2logic(ValueType vt)
 {
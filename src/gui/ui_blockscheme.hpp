@@ -17,10 +17,14 @@ namespace gui {
     {
     private:
         MainWindow *ui;
+        bool detached = false;  ///< Deleted widgets were already removed from the logic
 
         BlockType bltype_logic2gui(BlockEditorLogic::EBlockType t);
         BlockEditorLogic::EBlockType bltype_gui2logic(BlockType t);
         std::string valtype_gui2logic(ValueType vt);
+        ValueType valtype_logic2gui(const std::string& tn);
+
+        void load_canvas(const BlockEditorLogic::CBlockScheme::PartBuffer& pb);
 
     public:
         BlockScheme(MainWindow *ui) : ui(ui) {}
@@ -29,11 +33,18 @@ namespace gui {
         BlockEditorLogic::CBlockScheme block_scheme;
 
         int add_block(BlockType t, ValueType vt);
-        void set_port_value(Port *s);
+        bool set_port_value(Port *s);
+        QString port_value_summary(Port *s);
         void remove_port_value(Port *s);
         void remove_block(int id);
+        bool remove_blocks(const std::vector<BlockEditorLogic::ID>& ids);
+        void remove_all_blocks();
+        /// While set, deleted blocks and connections are not removed from the logic block scheme
+        void set_detached(bool d) {detached = d;}
         void add_connection(Port *from, Port *to);
         void remove_connection(Port *from, Port *to);
+        void move_block(Block *b);
+        void move_block(int id, QPoint p);
 
         void save_scheme(std::string file);
         void load_scheme(QWidget *window, std::string file);
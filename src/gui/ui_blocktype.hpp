@@ -16,7 +16,12 @@ namespace gui {
         BLOCK_SUB,
         BLOCK_DIV,
         BLOCK_MUL,
-        BLOCK_POW
+        BLOCK_POW,
+        BLOCK_SUM,      ///< Reductions, drawn with two inputs
+        BLOCK_PRODUCT,
+        BLOCK_MIN,
+        BLOCK_MAX,
+        BLOCK_MACRO     ///< Instance of macro, loaded from file only, drawn with two inputs
     };
 
     /// Enum of block value types
@@ -0,0 +1,481 @@
+/**
+ * @file    ui_canvas.cpp
+ * @date    19/10/2026
+ * @author  Filip Kocica <xkocic01@fit.vutbr.cz>
+ * @brief   Implementation of the canvas used for large schemes.
+ */
+
+#include "ui_canvas.hpp"
+#include "ui_block.hpp"
+#include "ui_connection.hpp"
+
+#include <QPainter>
+#include <QGraphicsSceneMouseEvent>
+#include <QStyleOptionGraphicsItem>
+#include <algorithm>
+#include <cmath>
+
+using namespace gui;
+
+/**
+ * @brief Block of the canvas.
+ * @param ui     MainWindow pointer.
+ * @param id     ID of the block in the logic block scheme.
+ * @param t      Type of the block.
+ * @param vt     Value type of the block.
+ * @param corner Position of the top left corner, as stored in the logic block scheme.
+ * @param in1    Value assigned to the first input port, empty if there is none.
+ * @param in2    Value assigned to the second input port, empty if there is none.
+ */
+CanvasBlock::CanvasBlock(MainWindow *ui, int id, BlockType t, ValueType vt, QPoint corner, QString in1, QString in2)
+    : ui(ui), id(id), value_type(vt)
+{
+    text = Block::type_text(t, vt);
+    in_value[0] = !in1.isEmpty();
+    in_value[1] = !in2.isEmpty();
+
+    if (in_value[0])
+        input_info += "Input 1: " + in1;
+    if (in_value[1])
+        input_info += QString(input_info.isEmpty() ? "" : "\n") + "Input 2: " + in2;
+
+    setPos(corner);
+    setFlags(ItemIsMovable | ItemSendsGeometryChanges);
+    update_tooltip();
+}
+
+/// @return Rectangle of the block with its ports.
+QRectF CanvasBlock::boundingRect() const
+{
+    return QRectF(0, 0, size, size);
+}
+
+/// Paint the block like Block looks, results replace the text.
+/// Zoomed out only a rectangle is drawn, red once the block has a result.
+void CanvasBlock::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    (void)widget;
+
+    qreal pixels = size * option->levelOfDetailFromTransform(painter->worldTransform());
+    if (pixels < LOD_DETAIL)
+    {
+        painter->fillRect(boundingRect(), has_result() ? QColor(200,60,60) : QColor(74,107,150));
+        return;
+    }
+
+    QFont font = painter->font();
+    font.setPixelSize(11);
+    painter->setFont(font);
+
+    painter->setPen(QPen(Qt::black, 1));
+    painter->setBrush(Qt::white);
+
+    if (has_result())
+    {
+        QRectF top(0, 0, size, size/2);
+        QRectF bottom(0, size/2, size, size/2);
+        painter->drawRect(top);
+        painter->drawRect(bottom);
+        painter->drawText(top, Qt::AlignCenter, text);
+        painter->drawText(bottom, Qt::AlignCenter, result);
+    }
+    else
+    {
+        painter->drawRect(boundingRect());
+        painter->drawText(boundingRect(), Qt::AlignCenter, text);
+    }
+
+    // ports
+    const QColor color_default(74,107,150);
+    const QColor color_has_value(30,190,30);
+    painter->fillRect(QRectF(port_pos(TOP_IN) - pos(), QSizeF(PORT_SIZE, PORT_SIZE)), in_value[0] ? color_has_value : color_default);
+    painter->fillRect(QRectF(port_pos(BOT_IN) - pos(), QSizeF(PORT_SIZE, PORT_SIZE)), in_value[1] ? color_has_value : color_default);
+    painter->fillRect(QRectF(port_pos(OUT) - pos(), QSizeF(PORT_SIZE, PORT_SIZE)), color_default);
+}
+
+/// @return Position of the block center.
+QPoint CanvasBlock::center() const
+{
+    return pos().toPoint() + QPoint(size/2, size/2);
+}
+
+/// @return Scene position of a port, placed the same way as ports of Block.
+QPoint CanvasBlock::port_pos(PortType type) const
+{
+    QPoint p = pos().toPoint();
+
+    if (type == BOT_IN)
+        p.ry() += size - PORT_SIZE;
+    else if (type == OUT)
+        p += QPoint(size - PORT_SIZE, size/2 - PORT_SIZE/2);
+
+    return p;
+}
+
+/// Attach a connection to a port, it is rerouted when the block moves.
+void CanvasBlock::attach(PortType type, CanvasConnection *c)
+{
+    connections[type - TOP_IN] = c;
+
+    if (type == OUT)
+        update_tooltip();
+}
+
+/**
+ * @brief   Display computation results for this block.
+ * @details Arrays are shown by their length on the block, the summary is shown on hover.
+ * @param action   Computed result to be displayed.
+ */
+void CanvasBlock::display_result(const BlockEditorLogic::CBlockAction& action)
+{
+    if (action.hasArray())
+    {
+        BlockEditorLogic::PortArrayPtr pa = action.getArray();
+        result_summary = QString::fromStdString(BlockEditorLogic::summarizeArray(*pa));
+        result = "[" + QString::number(pa->size()) + "]";
+    }
+    else
+    {
+        result_summary.clear();
+        result = Block::result_to_string(action, value_type);
+    }
+
+    update_tooltip();
+    update();
+}
+
+/// Hide the result.
+void CanvasBlock::hide_result()
+{
+    result.clear();
+    result_summary.clear();
+
+    update_tooltip();
+    update();
+}
+
+/// Show input values and the result on hover, also on the outgoing connection.
+void CanvasBlock::update_tooltip()
+{
+    QString tip = input_info;
+    if (has_result())
+        tip += QString(tip.isEmpty() ? "" : "\n") + "Value: " + get_result();
+    setToolTip(tip);
+
+    CanvasConnection *out = connections[OUT - TOP_IN];
+    if (out)
+        out->setToolTip("Value: " + (has_result() ? get_result() : QString("None")) + "\nType: " + text.mid(2));
+}
+
+/// Reroutes connections of the moved block.
+QVariant CanvasBlock::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    if (change == ItemPositionHasChanged)
+    {
+        for (auto c : connections)
+        {
+            if (c)
+                c->reroute();
+        }
+    }
+
+    return QGraphicsItem::itemChange(change, value);
+}
+
+/// Remember where dragging started.
+void CanvasBlock::mousePressEvent(QGraphicsSceneMouseEvent *event)
+{
+    press_pos = pos();
+    QGraphicsItem::mousePressEvent(event);
+}
+
+/// Stores the position of the block after it was dragged.
+void CanvasBlock::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
+{
+    QGraphicsItem::mouseReleaseEvent(event);
+
+    if (pos() == press_pos)
+        return;
+
+    ui->block_scheme->move_block(id, pos().toPoint());
+    ui->canvas->invalidate_density();
+
+    // extend the scene the block was moved outside
+    QRectF area = scene()->sceneRect();
+    if (!area.contains(sceneBoundingRect()))
+        scene()->setSceneRect(area.united(sceneBoundingRect().adjusted(-size, -size, size, size)));
+}
+
+/**
+ * @brief Connection of the canvas, from the output port to an input port.
+ * @param from   Block with the output port.
+ * @param to     Block with the input port.
+ * @param to_top True if the input port is the top one.
+ */
+CanvasConnection::CanvasConnection(CanvasBlock *from, CanvasBlock *to, bool to_top)
+    : from(from), to(to), to_top(to_top)
+{
+    // under the blocks
+    setZValue(-1);
+    reroute();
+}
+
+/// @return Rectangle bounding all lines.
+QRectF CanvasConnection::boundingRect() const
+{
+    return bounds;
+}
+
+/// @return Lines of the connection, used for hit-testing.
+QPainterPath CanvasConnection::shape() const
+{
+    QPainterPath path;
+    for (auto& l : lines)
+        path.addRect(l);
+    return path;
+}
+
+/// Paint the lines of the connection, zoomed out just a straight line.
+void CanvasConnection::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    (void)widget;
+
+    qreal pixels = CanvasBlock::size * option->levelOfDetailFromTransform(painter->worldTransform());
+    if (pixels < LOD_DETAIL)
+    {
+        // cosmetic pen, one pixel at any zoom
+        painter->setPen(QPen(Qt::black, 0));
+        painter->drawLine(straight);
+        return;
+    }
+
+    for (auto& l : lines)
+        painter->fillRect(l, Qt::black);
+}
+
+/// Route the lines again according to the current block positions.
+void CanvasConnection::reroute()
+{
+    prepareGeometryChange();
+
+    QPoint pfrom = from->port_pos(OUT);
+    QPoint pto = to->port_pos(to_top ? TOP_IN : BOT_IN);
+
+    lines = Connection::route(pfrom, pto, to_top);
+    straight = QLine(pfrom + QPoint(PORT_SIZE, PORT_SIZE/2), pto + QPoint(0, PORT_SIZE/2));
+
+    QRect b;
+    for (auto& l : lines)
+        b = b.united(l);
+    bounds = b;
+}
+
+/**
+ * @brief Canvas, hidden until a large scheme is loaded.
+ * @param parent Parent widget.
+ * @param ui     MainWindow pointer.
+ */
+SchemeCanvas::SchemeCanvas(QWidget *parent, MainWindow *ui) : QGraphicsView(parent), ui(ui)
+{
+    scene = new QGraphicsScene(this);
+    scene->setItemIndexMethod(QGraphicsScene::BspTreeIndex);
+    scene->setBackgroundBrush(QColor(230,230,230));
+    setScene(scene);
+
+    root = new CanvasRoot;
+    scene->addItem(root);
+
+    // dragging the background scrolls, dragging a block moves it
+    setDragMode(QGraphicsView::ScrollHandDrag);
+    setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+
+    // repaint only what changed, the items restore the painter themselves
+    setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+    setOptimizationFlags(QGraphicsView::DontSavePainterState | QGraphicsView::DontAdjustForAntialiasing);
+    setCacheMode(QGraphicsView::CacheBackground);
+}
+
+/**
+ * @brief Add a block which already exists in the logic scheme.
+ * @param id     ID of the block.
+ * @param t      Type of the block.
+ * @param vt     Value type of the block.
+ * @param corner Position of the top left corner, as stored in the logic block scheme.
+ * @param in1    Value assigned to the first input port, empty if there is none.
+ * @param in2    Value assigned to the second input port, empty if there is none.
+ */
+void SchemeCanvas::add_block(int id, BlockType t, ValueType vt, QPoint corner, QString in1, QString in2)
+{
+    CanvasBlock *b = new CanvasBlock(ui, id, t, vt, corner, in1, in2);
+    blocks[id] = b;
+    b->setParentItem(root);
+    density_dirty = true;
+}
+
+/**
+ * @brief Add a connection which already exists in the logic scheme.
+ * @param from   ID of the block with the output port.
+ * @param to     ID of the block with the input port.
+ * @param to_top True if the input port is the top one.
+ */
+void SchemeCanvas::add_connection(int from, int to, bool to_top)
+{
+    auto f = blocks.find(from);
+    auto t = blocks.find(to);
+    if (f == blocks.end() || t == blocks.end())
+        return;
+
+    CanvasConnection *c = new CanvasConnection(f->second, t->second, to_top);
+    f->second->attach(OUT, c);
+    t->second->attach(to_top ? TOP_IN : BOT_IN, c);
+    c->setParentItem(root);
+}
+
+/// All blocks were added, fit the scene to them.
+void SchemeCanvas::finish_loading()
+{
+    int margin = CanvasBlock::size;
+    scene->setSceneRect(scene->itemsBoundingRect().adjusted(-margin, -margin, margin, margin));
+    centerOn(scene->sceneRect().topLeft());
+}
+
+/// Remove all blocks, the logic block scheme is not changed.
+void SchemeCanvas::clear()
+{
+    with_result.clear();
+    blocks.clear();
+    scene->clear();
+    scene->setSceneRect(QRectF());
+    resetTransform();
+
+    root = new CanvasRoot;
+    scene->addItem(root);
+
+    density_shown = false;
+    density_dirty = true;
+    density = QImage();
+}
+
+/**
+ * @brief Show a computed result on its block.
+ * @param action Computed result.
+ * @return False if there is no such block.
+ */
+bool SchemeCanvas::display_result(const BlockEditorLogic::CBlockAction& action)
+{
+    auto it = blocks.find(action.getID());
+    if (it == blocks.end())
+        return false;
+
+    if (!it->second->has_result())
+        with_result.push_back(it->second);
+    it->second->display_result(action);
+    return true;
+}
+
+/// Hide all results, only the blocks showing one are visited.
+void SchemeCanvas::hide_results()
+{
+    for (auto b : with_result)
+        b->hide_result();
+    with_result.clear();
+}
+
+/// Add positions of all blocks, used when saving.
+void SchemeCanvas::get_coords(BlockEditorLogic::CBlockScheme::Coords& coords) const
+{
+    for (auto& it : blocks)
+    {
+        QPoint p = it.second->pos().toPoint();
+        coords.push_back(BlockEditorLogic::CBlockScheme::BlockCoord {it.first, {p.x(), p.y()}});
+    }
+}
+
+/// Ctrl + wheel zooms around the mouse, wheel alone scrolls.
+void SchemeCanvas::wheelEvent(QWheelEvent *event)
+{
+    if (!(event->modifiers() & Qt::ControlModifier))
+    {
+        QGraphicsView::wheelEvent(event);
+        return;
+    }
+
+    qreal factor = std::pow(1.0015, event->angleDelta().y());
+    qreal zoom = transform().m11() * factor;
+
+    if (zoom < min_zoom)
+        factor = min_zoom / transform().m11();
+    else if (zoom > max_zoom)
+        factor = max_zoom / transform().m11();
+
+    scale(factor, factor);
+    update_lod();
+    event->accept();
+}
+
+/// Switch between the items and the density image, by pixels per block.
+void SchemeCanvas::update_lod()
+{
+    bool show = CanvasBlock::size * transform().m11() < LOD_DENSITY;
+    if (show == density_shown)
+        return;
+
+    if (show && density_dirty)
+        make_density();
+
+    // hiding the parent hides all items, they are not even visited when painting
+    density_shown = show;
+    root->setVisible(!show);
+    viewport()->update();
+}
+
+/// Count blocks in cells of the scene and color the cells by the count.
+void SchemeCanvas::make_density()
+{
+    // cell of one block, the image is kept reasonably small
+    const int max_cells = 2048;
+    density_rect = scene->sceneRect();
+    qreal cell = std::max<qreal>(CanvasBlock::size,
+                                 std::max(density_rect.width(), density_rect.height()) / max_cells);
+
+    int w = std::max(1, static_cast<int>(std::ceil(density_rect.width() / cell)));
+    int h = std::max(1, static_cast<int>(std::ceil(density_rect.height() / cell)));
+
+    std::vector<unsigned> counts(static_cast<size_t>(w) * h, 0);
+    unsigned max_count = 0;
+
+    for (auto& it : blocks)
+    {
+        QPointF p = it.second->center() - density_rect.topLeft();
+        int x = std::min(w - 1, std::max(0, static_cast<int>(p.x() / cell)));
+        int y = std::min(h - 1, std::max(0, static_cast<int>(p.y() / cell)));
+
+        unsigned& c = counts[static_cast<size_t>(y) * w + x];
+        max_count = std::max(max_count, ++c);
+    }
+
+    // empty cells are transparent, blue to red as the density grows
+    density = QImage(w, h, QImage::Format_ARGB32);
+    density.fill(Qt::transparent);
+    for (int y = 0; y < h; y++)
+    {
+        QRgb *line = reinterpret_cast<QRgb*>(density.scanLine(y));
+        for (int x = 0; x < w; x++)
+        {
+            unsigned c = counts[static_cast<size_t>(y) * w + x];
+            if (c)
+                line[x] = QColor::fromHsvF(0.66 * (1.0 - qreal(c) / max_count), 1.0, 0.9).rgba();
+        }
+    }
+
+    density_dirty = false;
+}
+
+/// Draw the density image when zoomed out too far for the items.
+void SchemeCanvas::drawForeground(QPainter *painter, const QRectF &rect)
+{
+    (void)rect;
+
+    if (density_shown)
+        painter->drawImage(density_rect, density);
+}
@@ -0,0 +1,162 @@
+/**
+ * @file    ui_canvas.hpp
+ * @date    19/10/2026
+ * @author  Filip Kocica <xkocic01@fit.vutbr.cz>
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <QGraphicsView>
+#include <QGraphicsScene>
+#include <QGraphicsItem>
+#include <QWheelEvent>
+#include <QImage>
+
+#include "mainwindow.hpp"
+#include "ui_port.hpp"
+#include "ui_blocktype.hpp"
+
+/// Schemes with at least this many blocks are loaded into the canvas
+#define LARGE_SCHEME 2000
+
+/// Pixels per block from which blocks are drawn with text and ports
+#define LOD_DETAIL 24
+/// Pixels per block under which the canvas shows density of blocks instead of them
+#define LOD_DENSITY 8
+
+namespace gui {
+    class CanvasConnection;
+
+    /// Block drawn by the canvas, a light replacement of Block for large schemes.
+    class CanvasBlock : public QGraphicsItem
+    {
+    public:
+        CanvasBlock(MainWindow *ui, int id, BlockType t, ValueType vt, QPoint corner, QString in1, QString in2);
+
+        QRectF boundingRect() const override;
+        void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+        /// @return Block id
+        int get_id() const {return id;}
+        QPoint center() const;
+        QPoint port_pos(PortType type) const;
+
+        void attach(PortType type, CanvasConnection *c);
+        void display_result(const BlockEditorLogic::CBlockAction& action);
+        void hide_result();
+
+        /// @return Result shown on the block, summarized if the result is an array
+        QString get_result() const {return result_summary.isEmpty() ? result : result_summary;}
+        /// @return True if there is a result shown on the block
+        bool has_result() const {return !result.isEmpty();}
+
+        static const int size = 70;    ///< Same size as Block
+
+    protected:
+        QVariant itemChange(GraphicsItemChange change, const QVariant &value) override;
+        void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
+        void mouseReleaseEvent(QGraphicsSceneMouseEvent *event) override;
+
+    private:
+        MainWindow *ui;
+        int id;
+        ValueType value_type;
+
+        QString text;           ///< Operation and value type
+        QString result;         ///< Result, empty if there is none
+        QString result_summary; ///< Summary of the result, if the result is an array
+        bool in_value[2];       ///< Input ports with a value assigned
+        QString input_info;     ///< Values assigned to the input ports, shown on hover
+
+        CanvasConnection *connections[3] = {NULL, NULL, NULL}; ///< Connections by PortType
+        QPointF press_pos;      ///< Position when dragging started
+
+        void update_tooltip();
+    };
+
+    /// Parent of all items of the canvas, hiding it hides them all at once.
+    class CanvasRoot : public QGraphicsItem
+    {
+    public:
+        CanvasRoot() {setFlag(ItemHasNoContents);}
+
+        QRectF boundingRect() const override {return QRectF();}
+        void paint(QPainter *, const QStyleOptionGraphicsItem *, QWidget *) override {}
+    };
+
+    /// Connection drawn by the canvas, routed the same way as Connection.
+    class CanvasConnection : public QGraphicsItem
+    {
+    public:
+        CanvasConnection(CanvasBlock *from, CanvasBlock *to, bool to_top);
+
+        QRectF boundingRect() const override;
+        QPainterPath shape() const override;
+        void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+        void reroute();
+
+    private:
+        CanvasBlock *from;
+        CanvasBlock *to;
+        bool to_top;            ///< Connected to the top input port
+
+        QVector<QRect> lines;   ///< Lines making the connection
+        QLine straight;         ///< Straight line between the ports, drawn when zoomed out
+        QRectF bounds;          ///< Rectangle bounding all lines
+    };
+
+    /// Graphics view showing large schemes. Only the visible items are
+    /// painted and hit-tested, items are found through the spatial index of
+    /// the scene. Blocks can be moved and show computation results, ctrl +
+    /// wheel zooms. Detail of drawing follows the zoom: blocks with text and
+    /// ports when close, plain rectangles and straight connections further,
+    /// and an image of block density when even the rectangles would be too
+    /// small to see.
+    class SchemeCanvas : public QGraphicsView
+    {
+        Q_OBJECT
+
+    public:
+        SchemeCanvas(QWidget *parent, MainWindow *ui);
+
+        void add_block(int id, BlockType t, ValueType vt, QPoint corner, QString in1, QString in2);
+        void add_connection(int from, int to, bool to_top);
+        void finish_loading();
+        void clear();
+        /// @return True if there are no blocks
+        bool empty() const {return blocks.empty();}
+
+        bool display_result(const BlockEditorLogic::CBlockAction& action);
+        void hide_results();
+        void get_coords(BlockEditorLogic::CBlockScheme::Coords& coords) const;
+        /// Blocks were moved, density image has to be made again
+        void invalidate_density() {density_dirty = true;}
+
+    protected:
+        void wheelEvent(QWheelEvent *event) override;
+        void drawForeground(QPainter *painter, const QRectF &rect) override;
+
+    private:
+        MainWindow *ui;
+        QGraphicsScene *scene;
+        CanvasRoot *root;       ///< Parent of all blocks and connections
+
+        bool density_shown = false; ///< Items are hidden, density image is shown
+        bool density_dirty = true;  ///< Density image does not match the blocks
+        QImage density;             ///< Blocks per cell, as colors
+        QRectF density_rect;        ///< Scene area covered by the image
+
+        void update_lod();
+        void make_density();
+
+        std::unordered_map<int, CanvasBlock*> blocks; ///< Blocks by their ID
+        std::vector<CanvasBlock*> with_result;        ///< Blocks showing a result
+
+        const qreal min_zoom = 0.02;
+        const qreal max_zoom = 4.0;
+    };
+}
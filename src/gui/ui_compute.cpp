@@ -8,9 +8,13 @@
 
 #include "ui_compute.hpp"
 #include "ui_blocklist.hpp"
+#include "ui_canvas.hpp"
+#include "../SchemeTrace.hpp"
 #include <QObject>
 #include <QMessageBox>
+#include <QStatusBar>
 #include <QTime>
+#include <algorithm>
 
 using namespace gui;
 
@@ -24,93 +28,268 @@ void delay( int millisecondsToWait )
     }
 }
 
+/// Computes the remaining blocks, runs in the worker thread.
+void ComputeWorker::run()
+{
+    TRACE_THREAD("compute");
+    TRACE_SPAN("ComputeWorker::run");
+
+    try
+    {
+      results = evaluation->run(&cancel, [this](size_t done, size_t total) {
+          emit progress(static_cast<int>(done), static_cast<int>(total));
+      });
+    }
+    catch(BlockEditorLogic::CBlockEditorException& e)
+    {
+      failed = true;
+      if (e.getErrCode() != BlockEditorLogic::EErrorCode::E_CANCELLED)
+          error = e.what();
+    }
+    // nothing may escape QThread::run, it would terminate the application
+    catch(std::exception& e)
+    {
+      failed = true;
+      error = e.what();
+    }
+    catch(...)
+    {
+      failed = true;
+      error = "Unknown error during computation";
+    }
+}
+
 /**
- *  Run the computation and display all results at once (or all remaining results)
- *  @return True on success, False on exception
+ * @brief Constructor, places the progress bar into the status bar.
+ * @param ui MainWindow pointer.
  */
-bool Compute::run_computation()
+Compute::Compute(MainWindow *ui) : ui(ui)
+{
+    progress_bar = new QProgressBar(ui);
+    progress_bar->setMaximumWidth(200);
+    progress_bar->hide();
+    ui->statusBar()->addPermanentWidget(progress_bar);
+
+    // roughly one batch of results per frame
+    frame_timer.setInterval(16);
+    connect(&frame_timer, SIGNAL(timeout()), this, SLOT(display_batch()));
+}
+
+/// Destructor, stops the evaluation in progress.
+Compute::~Compute()
+{
+    cancel();
+}
+
+/// Start evaluation of the current scheme snapshot, no block is computed yet.
+void Compute::begin()
+{
+    evaluation = EvaluationPtr(ui->block_scheme->block_scheme.evaluate());
+    result_version = evaluation->getVersion();
+    computation_running = true;
+}
+
+/// Compute the remaining blocks of the evaluation in a worker thread.
+void Compute::start()
 {
-    // start computation and display all at once
     if (!computation_running)
+        begin();
+
+    worker = new ComputeWorker(evaluation);
+    connect(worker, SIGNAL(progress(int,int)), this, SLOT(computation_progress(int,int)));
+    connect(worker, SIGNAL(finished()), this, SLOT(computation_finished()));
+
+    steps_to_go.clear();
+
+    progress_bar->setValue(0);
+    progress_bar->show();
+
+    worker->start();
+}
+
+/// Cancel the evaluation in progress, returns once the worker stopped.
+void Compute::cancel()
+{
+    if (worker)
     {
-        computation_running = true;
+        worker->cancel = true;
+        worker->wait();
+        delete worker;
+        worker = NULL;
+        progress_bar->hide();
+    }
+}
 
-        BlockEditorLogic::CBlockScheme::ActionBuffer buff;
-        try
-        {
-          buff = ui->block_scheme->block_scheme.run();
-        }
-        catch(BlockEditorLogic::CBlockEditorException& e)
-        {
-          QMessageBox err;
-          err.critical(0, "Computation error", e.what());
-          err.setFixedSize(500,200);
-          computation_running = false;
-          return false;
-        }
+/// Worker finished, take over its results and start showing them.
+void Compute::computation_finished()
+{
+    TRACE_SPAN("Compute::computation_finished");
+
+    // finished signal of a cancelled worker
+    if (!worker || !worker->isFinished())
+        return;
+
+    ComputeWorker *w = worker;
+    worker = NULL;
+    w->deleteLater();
+    progress_bar->hide();
 
-        for (auto i : buff)
+    if (w->failed)
+    {
+        computation_running = false;
+        evaluation.reset();
+
+        if (!w->error.isEmpty())
         {
-            Block* bl = ui->block_list->find(i.getID());
-            bl->display_result(i.getValue());
+            QMessageBox err;
+            err.critical(0, "Computation error", w->error);
+            err.setFixedSize(500,200);
         }
+        return;
     }
-    // display remaining (finish stepping)
-    else
+
+    steps_to_go = std::move(w->results);
+
+    if (!results_current())
+        ui->statusBar()->showMessage("The scheme was edited during the computation, results are from its previous version.", 5000);
+
+    frame_timer.start();
+}
+
+/**
+ * @brief Update the progress bar.
+ * @param done  Evaluated blocks.
+ * @param total All blocks.
+ */
+void Compute::computation_progress(int done, int total)
+{
+    if (!worker)
+        return;
+
+    progress_bar->setMaximum(total);
+    progress_bar->setValue(done);
+}
+
+/// Show the next batch of results, keeps the window responsive.
+void Compute::display_batch()
+{
+    TRACE_SPAN("Compute::display_batch");
+    size_t n = std::min(steps_to_go.size(), batch_size);
+
+    for (size_t i = 0; i < n; i++)
     {
-        for (auto i : steps_to_go)
-        {
-            Block* bl = ui->block_list->find(i.getID());
-            bl->display_result(i.getValue());
-        }
-        steps_to_go.clear();
+        display(steps_to_go.front());
+        steps_to_go.pop_front();
     }
+
+    if (steps_to_go.empty())
+        frame_timer.stop();
+}
+
+/// Show one result on its block, if the block still exists
+void Compute::display(const BlockEditorLogic::CBlockAction& action)
+{
+    Block* bl = ui->block_list->find(action.getID());
+    if (bl)
+        bl->display_result(action);
+    else
+        ui->canvas->display_result(action);
+}
+
+/// @return True if the results were computed from the current version of the scheme
+bool Compute::results_current()
+{
+    return result_version == ui->block_scheme->block_scheme.getVersion();
+}
+
+/**
+ *  Run the computation and display all results (or all remaining results).
+ *  Results are shown once the evaluation in the worker thread finishes.
+ *  @return True if the computation was started
+ */
+bool Compute::run_computation()
+{
+    TRACE_SPAN("Compute::run_computation");
+
+    // scheme changed since the results were computed
+    if (computation_running && !worker && !results_current())
+        stop_computation();
+
+    if (worker)
+        return true;
+
+    if (!computation_running || !evaluation->finished())
+        start();
+    else
+        frame_timer.start();
+
     return true;
 }
 
 /**
- *  Run computation and display results one by one
- *  @return True on success, False on exception
+ *  Compute the next block and display its result. Only one block is
+ *  computed, the first step does not wait for the whole scheme.
+ *  @return True if the computation goes on
  */
 bool Compute::next_step()
 {
-    // first step setup - run computation
-    if (!computation_running)
-    {
-        computation_running = true;
+    TRACE_SPAN("Compute::next_step");
 
-        try
-        {
-          steps_to_go = ui->block_scheme->block_scheme.run();
-        }
-        catch(BlockEditorLogic::CBlockEditorException& e)
-        {
-          QMessageBox err;
-          err.critical(0, "Computation error", e.what());
-          err.setFixedSize(500,200);
-          computation_running = false;
-          return false;
-        }
-    }
+    // scheme changed since the results were computed
+    if (computation_running && !worker && !results_current())
+        stop_computation();
 
-    // no more steps remaining
-    if (steps_to_go.empty())
+    // Run computes all blocks already
+    if (worker)
+        return true;
+
+    // results of Run not shown yet
+    if (!steps_to_go.empty())
+    {
+        display(steps_to_go.front());
+        steps_to_go.pop_front();
         return true;
+    }
 
-    // display next step
-    auto step = steps_to_go.front();
+    if (!computation_running)
+        begin();
 
-    Block* bl = ui->block_list->find(step.getID());
-    bl->display_result(step.getValue());
+    if (evaluation->finished())
+        return true;
 
-    steps_to_go.pop_front();
+    try
+    {
+        display(evaluation->next());
+    }
+    catch(BlockEditorLogic::CBlockEditorException& e)
+    {
+        computation_running = false;
+        evaluation.reset();
+
+        QMessageBox err;
+        err.critical(0, "Computation error", e.what());
+        err.setFixedSize(500,200);
+        return false;
+    }
 
     return true;
 }
 
+/// Scheme is about to be edited. Evaluation in progress goes on with its
+/// snapshot, results already shown would be outdated and are hidden.
+void Compute::scheme_edited()
+{
+    if (!worker)
+        stop_computation();
+}
+
 /// Stop the computation and hide all results
 void Compute::stop_computation()
 {
+    cancel();
+    frame_timer.stop();
+    evaluation.reset();
+
     if (computation_running)
     {
         computation_running = false;
@@ -120,6 +299,7 @@ void Compute::stop_computation()
         {
             i->hide_result();
         }
+        ui->canvas->hide_results();
 
         // reset stepping
         steps_to_go.clear();
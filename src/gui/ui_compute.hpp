@@ -7,20 +7,71 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QProgressBar>
+
 #include "mainwindow.hpp"
 #include "ui_blockscheme.hpp"
 
 namespace gui {
 
+    using EvaluationPtr = std::shared_ptr<BlockEditorLogic::CSchemeEvaluation>;
+
+    /// Computes the remaining blocks of an evaluation outside of the UI thread.
+    class ComputeWorker : public QThread
+    {
+        Q_OBJECT
+
+    public:
+        ComputeWorker(EvaluationPtr evaluation) : evaluation(evaluation) {}
+
+        /// Set to stop the evaluation, checked periodically by the evaluation
+        std::atomic<bool> cancel{false};
+
+        /// Results, valid once the thread finished
+        BlockEditorLogic::CBlockScheme::ActionBuffer results;
+        /// Error message, empty on success or when cancelled
+        QString error;
+        /// Evaluation did not finish
+        bool failed = false;
+
+        /// @return Version of the scheme being evaluated
+        uint64_t get_version() const {return evaluation->getVersion();}
+
+    signals:
+        void progress(int done, int total);
+
+    protected:
+        void run() override;
+
+    private:
+        EvaluationPtr evaluation;
+    };
+
     /// Takes care of computation displaying.
-    class Compute
+    class Compute : public QObject
     {
+        Q_OBJECT
+
     public:
-        Compute(MainWindow *ui) : ui(ui) {}
+        Compute(MainWindow *ui);
+        ~Compute();
 
-        bool run_computation();      
+        bool run_computation();
         void stop_computation();
         bool next_step();
+        bool results_current();
+        void scheme_edited();
+
+    private slots:
+        void computation_finished();
+        void computation_progress(int done, int total);
+        void display_batch();
 
     private:
         MainWindow *ui;
@@ -28,9 +79,29 @@ namespace gui {
         /// computation in progress flag
         bool computation_running = false;
 
-        /// Queue of remaining results for stepping
+        /// Results computed by Run which were not shown yet
         BlockEditorLogic::CBlockScheme::ActionBuffer steps_to_go;
 
+        /// Evaluation of the scheme, Step computes one block of it
+        EvaluationPtr evaluation;
+
+        /// Version of the scheme snapshot the results were computed from
+        uint64_t result_version = 0;
+
+        /// Evaluation in progress, NULL when results are ready
+        ComputeWorker *worker = NULL;
+
+        /// Shows results in batches, one batch per frame
+        QTimer frame_timer;
+        /// Results shown in one frame
+        const size_t batch_size = 500;
+
+        QProgressBar *progress_bar;
+
+        void begin();
+        void start();
+        void cancel();
+        void display(const BlockEditorLogic::CBlockAction& action);
     };
 
 }
@@ -10,37 +10,290 @@
 #include "ui_connection.hpp"
 #include "ui_port.hpp"
 #include <QPainter>
-#include <QStyleOption>
+#include <QPaintEvent>
 #include <QMenu>
 #include <QAction>
+#include <QGuiApplication>
+#include <QScreen>
+#include <algorithm>
 #include <cassert>
 
 using namespace gui;
 
-Line::Line(QWidget *parent, MainWindow *ui, Connection *c) : QWidget(parent), ui(ui), part_of(c)
+/// Cell of the connection grid containing the coordinate, negative ones too.
+static int grid_cell(int v)
 {
-    // enable mouse hover over
-    this->setAttribute(Qt::WA_Hover);
+    return v >= 0 ? v / GRID_CELL : (v - GRID_CELL + 1) / GRID_CELL;
+}
+
+/// Key of the cell in the connection grid.
+static quint64 grid_key(int x, int y)
+{
+    return (quint64(quint32(x)) << 32) | quint32(y);
+}
+
+/**
+ * @brief Layer covering the whole board, placed under the blocks.
+ * @param board Frame with the blocks.
+ * @param ui    MainWindow pointer.
+ */
+ConnectionLayer::ConnectionLayer(QWidget *board, MainWindow *ui) : QWidget(board), ui(ui), board(board)
+{
+    // hovering over lines shows the info label
     setMouseTracking(true);
+
+    setGeometry(board->rect());
+    lower();
+
+    // follow the size of the board
+    board->installEventFilter(this);
+
+    labelShowConnectionInfo = new QLabel(board);
+    labelShowConnectionInfo->setMargin(5);
+    labelShowConnectionInfo->setStyleSheet("background-color: white; border: 1px solid black; font-size:12px;");
+    labelShowConnectionInfo->setAlignment(Qt::AlignCenter);
+    labelShowConnectionInfo->hide();
+    connect(&intervalShowConnectionInfo, SIGNAL(timeout()), labelShowConnectionInfo, SLOT(hide()));
+
+    // dragged blocks are moved at the display refresh rate
+    QScreen *screen = QGuiApplication::primaryScreen();
+    int rate = screen && screen->refreshRate() > 0 ? static_cast<int>(screen->refreshRate()) : 60;
+    move_timer.setInterval(1000 / rate);
+    move_timer.setSingleShot(true);
+    connect(&move_timer, SIGNAL(timeout()), this, SLOT(flush_moves()));
+}
+
+/// Add a connection to be painted.
+void ConnectionLayer::add(Connection *c)
+{
+    c->layer_index = connections.size();
+    connections.push_back(c);
+    index(c);
+    update(c->get_bounds());
+}
+
+/// Stop painting a connection, the last connection takes its place in the list.
+void ConnectionLayer::remove(Connection *c)
+{
+    size_t pos = c->layer_index;
+    if (pos >= connections.size() || connections[pos] != c)
+        return;
+
+    if (pos != connections.size() - 1)
+    {
+        connections[pos] = connections.back();
+        connections[pos]->layer_index = pos;
+    }
+    connections.pop_back();
+    unindex(c);
+
+    update(c->get_bounds());
+    labelShowConnectionInfo->hide();
+}
+
+/// Stop painting all connections at once, used when all blocks are deleted.
+void ConnectionLayer::clear()
+{
+    for (auto c : connections)
+        c->cells.clear();
+    connections.clear();
+    grid.clear();
+    update();
+    labelShowConnectionInfo->hide();
+}
+
+/// Put a connection into the cells its lines pass, a few pixels around
+/// the lines too, as Connection::contains matches them.
+void ConnectionLayer::index(Connection *c)
+{
+    for (auto& l : c->get_lines())
+    {
+        QRect r = l.adjusted(-LINE_THICKNESS, -LINE_THICKNESS, LINE_THICKNESS, LINE_THICKNESS);
+        for (int y = grid_cell(r.top()); y <= grid_cell(r.bottom()); y++)
+        {
+            for (int x = grid_cell(r.left()); x <= grid_cell(r.right()); x++)
+            {
+                quint64 key = grid_key(x, y);
+                if (std::find(c->cells.begin(), c->cells.end(), key) != c->cells.end())
+                    continue;
+                c->cells.push_back(key);
+                grid[key].push_back(c);
+            }
+        }
+    }
+}
+
+/// Take a connection out of all cells of the grid.
+void ConnectionLayer::unindex(Connection *c)
+{
+    for (quint64 key : c->cells)
+    {
+        auto cell = grid.find(key);
+        if (cell == grid.end())
+            continue;
+
+        auto& v = cell->second;
+        auto it = std::find(v.begin(), v.end(), c);
+        if (it != v.end())
+        {
+            *it = v.back();
+            v.pop_back();
+        }
+        if (v.empty())
+            grid.erase(cell);
+    }
+    c->cells.clear();
+}
+
+/**
+ * @brief Show the info label left of a point for a while.
+ * @param text  Text of the label.
+ * @param p     Point the label ends at, in board coordinates.
+ */
+void ConnectionLayer::show_info(const QString& text, QPoint p)
+{
+    labelShowConnectionInfo->setText(text);
+    labelShowConnectionInfo->adjustSize();
+    p.rx() -= labelShowConnectionInfo->width();
+    p.ry() -= labelShowConnectionInfo->height() / 2;
+    labelShowConnectionInfo->move(p);
+    labelShowConnectionInfo->raise();
+    labelShowConnectionInfo->show();
+    intervalShowConnectionInfo.start(1000);
+}
+
+/**
+ * @brief Move a dragged block with the next display refresh. Later moves
+ *        of the same block replace the earlier ones.
+ * @param b Dragged block.
+ * @param p New position of the block, top left corner.
+ */
+void ConnectionLayer::schedule_move(Block *b, QPoint p)
+{
+    if (pending_moves.empty() && !measure_paint)
+        move_clock.start();
+
+    pending_moves[b] = p;
+
+    if (!move_timer.isActive())
+        move_timer.start();
+}
+
+/// Forget a pending move of a block which is being destroyed.
+void ConnectionLayer::cancel_move(Block *b)
+{
+    pending_moves.erase(b);
+}
+
+/// Move all dragged blocks, route their connections again and repaint
+/// the old and new lines at once.
+void ConnectionLayer::flush_moves()
+{
+    move_timer.stop();
+    if (pending_moves.empty())
+        return;
+
+    QRegion dirty;
+    for (auto& m : pending_moves)
+    {
+        Block *b = m.first;
+        b->move(m.second);
+
+        for (Port *p : {b->port_one, b->port_two, b->port_out})
+        {
+            if (p->connected())
+            {
+                Connection *c = p->get_connection();
+                unindex(c);
+                dirty += c->reposition();
+                index(c);
+            }
+        }
+    }
+    pending_moves.clear();
+
+    if (dirty.isEmpty())
+    {
+        // nothing of the layer to repaint, blocks are repainted by Qt
+        record_latency();
+        return;
+    }
+
+    measure_paint = true;
+    update(dirty);
+}
+
+/// Time from the first move event of the batch until now.
+void ConnectionLayer::record_latency()
+{
+    latency_last = move_clock.nsecsElapsed() / 1e6;
+    latency_max = std::max(latency_max, latency_last);
+    measure_paint = false;
 }
 
-/// Allows the widget to be show.
-void Line::paintEvent(QPaintEvent* event)
+/// Paint the lines of connections in the repainted area.
+void ConnectionLayer::paintEvent(QPaintEvent *event)
 {
-    (void)event;
     QPainter painter(this);
-    QStyleOption StyleOpt;
+    QRect area = event->rect();
+
+    // connection passing several cells is painted once
+    paint_stamp++;
+    for (int y = grid_cell(area.top()); y <= grid_cell(area.bottom()); y++)
+    {
+        for (int x = grid_cell(area.left()); x <= grid_cell(area.right()); x++)
+        {
+            auto cell = grid.find(grid_key(x, y));
+            if (cell == grid.end())
+                continue;
+
+            for (auto c : cell->second)
+            {
+                if (c->paint_stamp == paint_stamp || !c->get_bounds().intersects(area))
+                    continue;
+                c->paint_stamp = paint_stamp;
+
+                for (auto& l : c->get_lines())
+                    painter.fillRect(l, Qt::black);
+            }
+        }
+    }
 
-    StyleOpt.initFrom(this);
-    style()->drawPrimitive(QStyle::PE_Widget, &StyleOpt, &painter, this);
+    if (measure_paint)
+        record_latency();
+}
+
+/// @return Connection with a line at the point, NULL if there is none.
+Connection *ConnectionLayer::hit(QPoint p)
+{
+    auto cell = grid.find(grid_key(grid_cell(p.x()), grid_cell(p.y())));
+    if (cell == grid.end())
+        return NULL;
+
+    // the last added connection is preferred, as when the list was scanned
+    Connection *found = NULL;
+    for (auto c : cell->second)
+    {
+        if (c->contains(p) && (!found || c->layer_index > found->layer_index))
+            found = c;
+    }
+    return found;
 }
 
 /**
  * @brief Allows connectinos to be deleted using the mouse.
+ *        Clicks outside of the lines go to the board.
  * @param event Event type.
  */
-void Line::mousePressEvent(QMouseEvent *event)
+void ConnectionLayer::mousePressEvent(QMouseEvent *event)
 {
+    Connection *c = hit(event->pos());
+    if (!c)
+    {
+        event->ignore();
+        return;
+    }
+
     // editing allowed
     if (ui->can_edit())
     {
@@ -49,7 +302,7 @@ void Line::mousePressEvent(QMouseEvent *event)
             if (ui->cursor->get_ctype() == CURSOR_DELETE)
             {
                 // delete the whole connection
-                delete part_of;
+                delete c;
             }
         }
         else if (event->button() == Qt::RightButton)
@@ -58,7 +311,7 @@ void Line::mousePressEvent(QMouseEvent *event)
             QMenu contextMenu(tr("Context menu"), this);
             contextMenu.setStyleSheet("background-color: rgb(150,150,150);");
             QAction action1("Delete", this);
-            connect(&action1, SIGNAL(triggered()), part_of, SLOT(delete_triggered()));
+            connect(&action1, SIGNAL(triggered()), c, SLOT(delete_triggered()));
             contextMenu.addAction(&action1);
             contextMenu.exec(mapToGlobal(event->pos()));
         }
@@ -66,9 +319,22 @@ void Line::mousePressEvent(QMouseEvent *event)
 }
 
 /// Catches mouse hovering over a line to show a info label.
-void Line::mouseMoveEvent(QMouseEvent * /* unused */)
+void ConnectionLayer::mouseMoveEvent(QMouseEvent *event)
+{
+    Connection *c = hit(event->pos());
+    if (c)
+        c->showLineInfo();
+    else
+        event->ignore();
+}
+
+/// Keeps the layer as large as the board.
+bool ConnectionLayer::eventFilter(QObject *watched, QEvent *event)
 {
-    part_of->showLineInfo();
+    if (watched == board && event->type() == QEvent::Resize)
+        setGeometry(board->rect());
+
+    return QWidget::eventFilter(watched, event);
 }
 
 /** @details    Removes the connetion from the logic block sheme.
@@ -76,6 +342,10 @@ void Line::mouseMoveEvent(QMouseEvent * /* unused */)
  */
 Connection::~Connection()
 {
+    // failed connection, nothing to remove
+    if (!created)
+        return;
+
     // remove the connection from the logic block scheme
     ui->block_scheme->remove_connection(from, to);
 
@@ -83,15 +353,8 @@ Connection::~Connection()
     from->port_disconnect();
     to->port_disconnect();
 
-    delete l1;
-    delete l2;
-    delete l3;
-    delete l4;
-    delete l5;
-
-    // hide the info label
-    labelShowConnectionInfo->hide();
-    delete labelShowConnectionInfo;
+    // stop painting it
+    ui->connection_layer->remove(this);
 }
 
 /**
@@ -101,8 +364,9 @@ Connection::~Connection()
  * @param ui
  * @param pfrom
  * @param pto
+ * @param attach True if the connection is in the logic block scheme already (loading).
  */
-Connection::Connection(QWidget *parent, MainWindow *ui, Port* pfrom, Port* pto) : QWidget(parent), ui(ui), from(pfrom), to(pto)
+Connection::Connection(QWidget *parent, MainWindow *ui, Port* pfrom, Port* pto, bool attach) : QObject(parent), ui(ui), board(parent), from(pfrom), to(pto)
 {
     bool createConnection = true;
 
@@ -115,43 +379,40 @@ Connection::Connection(QWidget *parent, MainWindow *ui, Port* pfrom, Port* pto)
         this->to = pfrom;
     }
 
-    // remove port values
-    if (from->has_value())
-        from->remove_value();
-    if (to->has_value())
-        to->remove_value();
-
     // add the connection into the logic block shceme
-    try
-    {
-        ui->block_scheme->add_connection(from, to);
-    }
-    catch(BlockEditorLogic::CBlockEditorException& e)
+    if (!attach)
     {
-        QMessageBox err;
-        err.critical(0, "ERROR", e.what());
-        err.setFixedSize(500,200);
-        createConnection = false;
+        // remove port values
+        if (from->has_value())
+            from->remove_value();
+        if (to->has_value())
+            to->remove_value();
+
+        try
+        {
+            ui->block_scheme->add_connection(from, to);
+        }
+        catch(BlockEditorLogic::CBlockEditorException& e)
+        {
+            QMessageBox err;
+            err.critical(0, "ERROR", e.what());
+            err.setFixedSize(500,200);
+            createConnection = false;
+        }
     }
 
     // Because cannot return from constructor
     if (createConnection)
     {
+        created = true;
+
         // set ports as connected
         from->port_connect(to,this);
         to->port_connect(from,this);
 
-        // create lines that make up the connection
-        l1 = new Line(parent, ui, this);
-        l2 = new Line(parent, ui, this);
-        l3 = new Line(parent, ui, this);
-        l4 = new Line(parent, ui, this);
-        l5 = new Line(parent, ui, this);
+        // route the lines and paint them
         place_lines();
-
-        // create value info label
-        labelShowConnectionInfo = new QLabel( parent );
-        connect(&intervalShowConnectionInfo, SIGNAL(timeout()), labelShowConnectionInfo, SLOT(hide()));
+        ui->connection_layer->add(this);
     }
 }
 
@@ -160,13 +421,12 @@ Connection::Connection(QWidget *parent, MainWindow *ui, Port* pfrom, Port* pto)
  */
 void Connection::showLineInfo()
 {
-    QPoint p = l3->pos();
     QString value = "None";
     QString type = "--None"; // Dont remove --
 
     if (from && from->get_block()->has_result())
     {
-      value = from->get_block()->getValueString();
+      value = from->get_block()->getValueSummary();
       type = from->get_block()->getTypeString();
     }
 
@@ -175,221 +435,126 @@ void Connection::showLineInfo()
     //     to  TYPE
     type = type.mid(2, type.length());
 
-    labelShowConnectionInfo->setMargin(5);
-    labelShowConnectionInfo->setStyleSheet("background-color: white; border: 1px solid black; font-size:12px;");
-    labelShowConnectionInfo->setText("Value: " + value + "\n" + "Type: " + type);
-    labelShowConnectionInfo->setAlignment(Qt::AlignCenter);
-    labelShowConnectionInfo->adjustSize();
-    p.rx() -= labelShowConnectionInfo->width();
-    p.ry() -= labelShowConnectionInfo->height() / 2;
-    labelShowConnectionInfo->move(p);
-    labelShowConnectionInfo->show();
-    intervalShowConnectionInfo.start(1000);
+    // next to the middle line
+    ui->connection_layer->show_info("Value: " + value + "\n" + "Type: " + type, lines[2].topLeft());
+}
+
+/// @return True if the point is on one of the lines, a few pixels around count too.
+bool Connection::contains(QPoint p) const
+{
+    const int tolerance = 2;
+
+    if (!bounds.adjusted(-tolerance, -tolerance, tolerance, tolerance).contains(p))
+        return false;
+
+    for (auto& l : lines)
+    {
+        if (l.adjusted(-tolerance, -tolerance, tolerance, tolerance).contains(p))
+            return true;
+    }
+    return false;
 }
 
 /// Initiates line drawing
 void Connection::place_lines()
 {
-    l1->hide();
-    l2->hide();
-    l3->hide();
-    l4->hide();
-    l5->hide();
-
     QPoint pfrom = from->parentWidget()->mapToParent(from->pos());
     QPoint pto = to->parentWidget()->mapToParent(to->pos());
 
+    // extend the board the new line would go outside
+    if (pfrom.x() + PORT_SIZE >= pto.x() &&
+        board->minimumWidth() < pfrom.x() + PORT_SIZE + OFFSET_LINE_LEN + LINE_THICKNESS)
+        board->setMinimumWidth(board->minimumWidth() + OFFSET_LINE_LEN + LINE_THICKNESS);
+
+    lines = route(pfrom, pto, to->get_type() == TOP_IN);
+
+    bounds = QRect();
+    for (auto& l : lines)
+        bounds = bounds.united(l);
+}
+
+/**
+ * @brief Route lines of a connection between two ports.
+ * @param pfrom  Position of the output port.
+ * @param pto    Position of the input port.
+ * @param to_top True if the input port is the top one.
+ * @return Lines of the connection, the third one is the middle line.
+ */
+QVector<QRect> Connection::route(QPoint pfrom, QPoint pto, bool to_top)
+{
+    QVector<QRect> lines;
+
     pfrom.rx() += PORT_SIZE;
     pfrom.ry() += PORT_SIZE/2 - LINE_THICKNESS/2;
     pto.ry() += PORT_SIZE/2 - LINE_THICKNESS/2;
 
     // simple left to right connection
     if (pfrom.x() < pto.x())
-        draw_basic_line(pfrom, pto);
-    // connection looping backwards
+        draw_basic_line(lines, pfrom, pto);
+    // connection looping backwards, input ports have a different ofset to avoid colision
     else
-    {
-        // extend the board the new line would go outside
-        if (parentWidget()->minimumWidth() < pfrom.x() + OFFSET_LINE_LEN + LINE_THICKNESS)
-            parentWidget()->setMinimumWidth(parentWidget()->minimumWidth() + OFFSET_LINE_LEN + LINE_THICKNESS);
-        draw_complex_line(pfrom, pto);
-    }
+        draw_complex_line(lines, pfrom, pto, to_top ? OFFSET_LINE_LEN/2 : -OFFSET_LINE_LEN/2);
+
+    return lines;
 }
 
-/// Draw a line connecting blocks from left to right using only 3 lines.
-void Connection::draw_basic_line(QPoint pfrom, QPoint pto)
+/// Route a line connecting blocks from left to right using only 3 lines.
+void Connection::draw_basic_line(QVector<QRect>& lines, QPoint pfrom, QPoint pto)
 {
     int width = abs(pfrom.x() - pto.x());
     int height = abs(pfrom.y() - pto.y());
 
-    // not used
-    l4->hide();
-    l5->hide();
-
-    // draw horizontal lines
-    QPoint l1_start;
-    l1_start.rx() = pfrom.x();
-    l1_start.ry() = pfrom.y();
-    l1->setFixedHeight(LINE_THICKNESS);
-    l1->setFixedWidth(width/2);
-    l1->setStyleSheet(QString("background-color: rgb(0,0,0);"));
-    l1->move(l1_start);
-    l1->show();
-
-    QPoint l3_start;
-    l3_start.rx() = pto.x() - width/2;
-    l3_start.ry() = pto.y();
-    l3->setFixedHeight(LINE_THICKNESS);
-    l3->setFixedWidth(width/2);
-    l3->setStyleSheet(QString("background-color: rgb(0,0,0);"));
-    l3->move(l3_start);
-    l3->show();
-
-
-    // draw vertical line
+    // horizontal line from the output port
+    lines.push_back(QRect(pfrom.x(), pfrom.y(), width/2, LINE_THICKNESS));
+
+    // vertical line
     if (pfrom.y() < pto.y())
-    {
-        QPoint l2_start;
-        l2_start.rx() = pfrom.x() + width/2;
-        l2_start.ry() = pfrom.y();
-        l2->setFixedHeight(height);
-        l2->setFixedWidth(LINE_THICKNESS);
-        l2->setStyleSheet(QString("background-color: rgb(0,0,0);"));
-        l2->move(l2_start);
-        l2->show();
-    }
+        lines.push_back(QRect(pfrom.x() + width/2, pfrom.y(), LINE_THICKNESS, height));
     else
-    {
-        QPoint l2_start;
-        l2_start.rx() = pfrom.x() + width/2;
-        l2_start.ry() = pfrom.y() - height + LINE_THICKNESS;
-        l2->setFixedHeight(height);
-        l2->setFixedWidth(LINE_THICKNESS);
-        l2->setStyleSheet(QString("background-color: rgb(0,0,0);"));
-        l2->move(l2_start);
-        l2->show();
-    }
+        lines.push_back(QRect(pfrom.x() + width/2, pfrom.y() - height + LINE_THICKNESS, LINE_THICKNESS, height));
+
+    // horizontal line to the input port
+    lines.push_back(QRect(pto.x() - width/2, pto.y(), width/2, LINE_THICKNESS));
 }
 
-/// Draw a line connecting blocks from right to left using all 5 lines.
-void Connection::draw_complex_line(QPoint pfrom, QPoint pto)
+/// Route a line connecting blocks from right to left using all 5 lines.
+void Connection::draw_complex_line(QVector<QRect>& lines, QPoint pfrom, QPoint pto, int port_offset)
 {
     int width = abs(pfrom.x() - pto.x());
     int height = abs(pfrom.y() - pto.y());
 
-    // input ports have a different ofset to avoid colision
-    int port_offset = 0;
-    if (this->to->get_type() == TOP_IN)
-        port_offset = OFFSET_LINE_LEN/2;
-    else if (this->to->get_type() == BOT_IN)
-        port_offset = -OFFSET_LINE_LEN/2;
-
     // loop down
     if (pfrom.y() < pto.y())
     {
-        // draw horizontal lines
-        QPoint l1_start;
-        l1_start.rx() = pfrom.x();
-        l1_start.ry() = pfrom.y();
-        l1->setFixedHeight(LINE_THICKNESS);
-        l1->setFixedWidth(OFFSET_LINE_LEN);
-        l1->setStyleSheet(QString("background-color: rgb(0,0,0);"));
-        l1->move(l1_start);
-        l1->show();
-
-        QPoint l3_start;
-        l3_start.rx() = pfrom.x() - OFFSET_LINE_LEN - width + port_offset;
-        l3_start.ry() = pfrom.y() + height/2;
-        l3->setFixedHeight(LINE_THICKNESS);
-        l3->setFixedWidth(width + OFFSET_LINE_LEN * 2 - port_offset);
-        l3->setStyleSheet(QString("background-color: rgb(0,0,0);"));
-        l3->move(l3_start);
-        l3->show();
-
-        QPoint l5_start;
-        l5_start.rx() = pto.x() - OFFSET_LINE_LEN + port_offset;
-        l5_start.ry() = pto.y();
-        l5->setFixedHeight(LINE_THICKNESS);
-        l5->setFixedWidth(OFFSET_LINE_LEN - port_offset);
-        l5->setStyleSheet(QString("background-color: rgb(0,0,0);"));
-        l5->move(l5_start);
-        l5->show();
-
-        // draw vertical lines
-        QPoint l2_start;
-        l2_start.rx() = pfrom.x() + OFFSET_LINE_LEN - LINE_THICKNESS;
-        l2_start.ry() = pfrom.y();
-        l2->setFixedHeight(height/2);
-        l2->setFixedWidth(LINE_THICKNESS);
-        l2->setStyleSheet(QString("background-color: rgb(0,0,0);"));
-        l2->move(l2_start);
-        l2->show();
-
-        QPoint l4_start;
-        l4_start.rx() = pto.x() - OFFSET_LINE_LEN + port_offset;
-        l4_start.ry() = pto.y() - height/2;
-        l4->setFixedHeight(height/2);
-        l4->setFixedWidth(LINE_THICKNESS);
-        l4->setStyleSheet(QString("background-color: rgb(0,0,0);"));
-        l4->move(l4_start);
-        l4->show();
+        lines.push_back(QRect(pfrom.x(), pfrom.y(), OFFSET_LINE_LEN, LINE_THICKNESS));
+        lines.push_back(QRect(pfrom.x() + OFFSET_LINE_LEN - LINE_THICKNESS, pfrom.y(), LINE_THICKNESS, height/2));
+        lines.push_back(QRect(pfrom.x() - OFFSET_LINE_LEN - width + port_offset, pfrom.y() + height/2,
+                              width + OFFSET_LINE_LEN * 2 - port_offset, LINE_THICKNESS));
+        lines.push_back(QRect(pto.x() - OFFSET_LINE_LEN + port_offset, pto.y() - height/2, LINE_THICKNESS, height/2));
+        lines.push_back(QRect(pto.x() - OFFSET_LINE_LEN + port_offset, pto.y(), OFFSET_LINE_LEN - port_offset, LINE_THICKNESS));
     }
     // loop up
     else
     {
-        // draw horizontal lines
-        QPoint l1_start;
-        l1_start.rx() = pfrom.x();
-        l1_start.ry() = pfrom.y();
-        l1->setFixedHeight(LINE_THICKNESS);
-        l1->setFixedWidth(OFFSET_LINE_LEN);
-        l1->setStyleSheet(QString("background-color: rgb(0,0,0);"));
-        l1->move(l1_start);
-        l1->show();
-
-        QPoint l3_start;
-        l3_start.rx() = pfrom.x() - OFFSET_LINE_LEN - width - port_offset;
-        l3_start.ry() = pfrom.y() - height/2;
-        l3->setFixedHeight(LINE_THICKNESS);
-        l3->setFixedWidth(width + OFFSET_LINE_LEN * 2 + port_offset);
-        l3->setStyleSheet(QString("background-color: rgb(0,0,0);"));
-        l3->move(l3_start);
-        l3->show();
-
-        QPoint l5_start;
-        l5_start.rx() = pto.x() - OFFSET_LINE_LEN - port_offset;
-        l5_start.ry() = pto.y();
-        l5->setFixedHeight(LINE_THICKNESS);
-        l5->setFixedWidth(OFFSET_LINE_LEN + port_offset);
-        l5->setStyleSheet(QString("background-color: rgb(0,0,0);"));
-        l5->move(l5_start);
-        l5->show();
-
-        // draw vertical lines
-        QPoint l2_start;
-        l2_start.rx() = pfrom.x() + OFFSET_LINE_LEN - LINE_THICKNESS;
-        l2_start.ry() = pfrom.y() - height/2;
-        l2->setFixedHeight(height/2);
-        l2->setFixedWidth(LINE_THICKNESS);
-        l2->setStyleSheet(QString("background-color: rgb(0,0,0);"));
-        l2->move(l2_start);
-        l2->show();
-
-        QPoint l4_start;
-        l4_start.rx() = pto.x() - OFFSET_LINE_LEN - port_offset;
-        l4_start.ry() = pto.y() + LINE_THICKNESS;
-        l4->setFixedHeight(height/2);
-        l4->setFixedWidth(LINE_THICKNESS);
-        l4->setStyleSheet(QString("background-color: rgb(0,0,0);"));
-        l4->move(l4_start);
-        l4->show();
+        lines.push_back(QRect(pfrom.x(), pfrom.y(), OFFSET_LINE_LEN, LINE_THICKNESS));
+        lines.push_back(QRect(pfrom.x() + OFFSET_LINE_LEN - LINE_THICKNESS, pfrom.y() - height/2, LINE_THICKNESS, height/2));
+        lines.push_back(QRect(pfrom.x() - OFFSET_LINE_LEN - width - port_offset, pfrom.y() - height/2,
+                              width + OFFSET_LINE_LEN * 2 + port_offset, LINE_THICKNESS));
+        lines.push_back(QRect(pto.x() - OFFSET_LINE_LEN - port_offset, pto.y() + LINE_THICKNESS, LINE_THICKNESS, height/2));
+        lines.push_back(QRect(pto.x() - OFFSET_LINE_LEN - port_offset, pto.y(), OFFSET_LINE_LEN + port_offset, LINE_THICKNESS));
     }
 }
 
-/// Redraws all lines according to the current port positions.
-void Connection::reposition()
+/**
+ * @brief Routes all lines again according to the current port positions.
+ * @return Area of the old and the new lines, to be repainted.
+ */
+QRegion Connection::reposition()
 {
+    QRegion area(bounds);
     place_lines();
+
+    return area + bounds;
 }
 
 /// Slot for connection deletion
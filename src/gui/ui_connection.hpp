@@ -12,68 +12,126 @@
 #include <QLabel>
 #include <QTimer>
 #include <QMessageBox>
+#include <QVector>
+#include <QRect>
+#include <QRegion>
+#include <QElapsedTimer>
+#include <unordered_map>
+#include <vector>
 
 #include "ui_mainwindow.h"
 #include "ui_port.hpp"
 
 #define LINE_THICKNESS 3
 #define OFFSET_LINE_LEN 20
+#define GRID_CELL 256     ///< Size of cells of the connection index, in pixels
 
 namespace gui {
     class Connection;
 
-    /// Lines used to make a connection between blocks.
-    class Line : public QWidget
+    /// Layer under the blocks which paints all connections of the board.
+    /// Connections are not widgets, their lines are cached rectangles and
+    /// clicks and hovering are matched against them. Dragged blocks are
+    /// moved once per display refresh, connections of all blocks moved in
+    /// that time are routed again and repainted in one update. Connections
+    /// are indexed by grid cells their lines pass, so painting and hovering
+    /// visit only connections near the area instead of all of them.
+    class ConnectionLayer : public QWidget
     {
         Q_OBJECT
 
     public:
-        explicit Line(QWidget *parent, MainWindow *ui, Connection * part_of);
+        explicit ConnectionLayer(QWidget *board, MainWindow *ui);
+
+        void add(Connection *c);
+        void remove(Connection *c);
+        void clear();
+        void show_info(const QString& text, QPoint p);
+
+        void schedule_move(Block *b, QPoint p);
+        void cancel_move(Block *b);
+
+        /// @return Time from a move event to the repaint of its connections, the last one, in ms
+        double get_latency() const {return latency_last;}
+        /// @return The longest time from a move event to the repaint since reset_latency(), in ms
+        double get_latency_max() const {return latency_max;}
+        void reset_latency() {latency_last = latency_max = 0;}
+
+    public slots:
+        void flush_moves();
+
+    protected:
+        void paintEvent(QPaintEvent *event) override;
+        void mousePressEvent(QMouseEvent *event) override;
+        void mouseMoveEvent(QMouseEvent *event) override;
+        bool eventFilter(QObject *watched, QEvent *event) override;
 
     private:
         MainWindow *ui;
-        void paintEvent(QPaintEvent* event);
+        QWidget *board; ///< Frame with the blocks, the layer covers it whole
 
-        ///< Pointer to the object representing the whole connection.
-        Connection * part_of = NULL;
+        Connection *hit(QPoint p);
 
-    public slots:
-        void mousePressEvent(QMouseEvent *event);
-        void mouseMoveEvent(QMouseEvent *);
+        std::vector<Connection*> connections; ///< All connections of the board
+        std::unordered_map<quint64, std::vector<Connection*>> grid; ///< Connections with a line in the cell
+        unsigned paint_stamp = 0;   ///< Marks connections painted by the current paint
 
+        void index(Connection *c);
+        void unindex(Connection *c);
+
+        QLabel *labelShowConnectionInfo; ///< Hover over label, shared by all connections
+        QTimer intervalShowConnectionInfo; ///< Timer to hide the info label
+
+        std::unordered_map<Block*, QPoint> pending_moves; ///< New positions of dragged blocks
+        QTimer move_timer;          ///< Applies pending moves, once per display refresh
+        QElapsedTimer move_clock;   ///< Started by the first move event of a batch
+        bool measure_paint = false; ///< Next paint ends a batch of moves
+        double latency_last = 0;
+        double latency_max = 0;
+
+        void record_latency();
     };
 
-    /// Represents a connection by holding all the individual lines.
-    class Connection : public QWidget
+    /// Represents a connection by holding the rectangles of its lines.
+    class Connection : public QObject
     {
         Q_OBJECT
     public:
-        explicit Connection(QWidget *parent, MainWindow *ui, Port* from, Port* to);
+        explicit Connection(QWidget *parent, MainWindow *ui, Port* from, Port* to, bool attach = false);
         virtual ~Connection();
 
-        void reposition();
+        QRegion reposition();
         void showLineInfo();
+        bool contains(QPoint p) const;
+
+        /// @return Lines of the connection.
+        const QVector<QRect>& get_lines() const {return lines;}
+        /// @return Rectangle bounding all lines.
+        QRect get_bounds() const {return bounds;}
+
+        size_t layer_index = 0; ///< Position in the ConnectionLayer
+        std::vector<quint64> cells; ///< Cells of the ConnectionLayer grid with its lines
+        unsigned paint_stamp = 0;   ///< Paint of the ConnectionLayer which visited it last
+
+        static QVector<QRect> route(QPoint pfrom, QPoint pto, bool to_top);
 
     public slots:
         void delete_triggered();
 
     private:
         MainWindow *ui;
+        QWidget *board; ///< Frame the connection is drawn in
 
         void place_lines();
-        void draw_basic_line(QPoint, QPoint);
-        void draw_complex_line(QPoint, QPoint);
+        static void draw_basic_line(QVector<QRect>&, QPoint, QPoint);
+        static void draw_complex_line(QVector<QRect>&, QPoint, QPoint, int);
+
+        bool created = false; ///< Connection was added into the logic block scheme
 
-        Line *l1 = NULL;
-        Line *l2 = NULL;
-        Line *l3 = NULL;
-        Line *l4 = NULL;
-        Line *l5 = NULL;
+        QVector<QRect> lines; ///< Lines making the connection, 3 or 5
+        QRect bounds; ///< Rectangle bounding all lines
 
         Port* from = NULL; ///< Output port
         Port* to = NULL; ///< Input port
-
-        QLabel *labelShowConnectionInfo; ///< Hover over label
-        QTimer intervalShowConnectionInfo; ///< Timer to hide the info label
     };
 }
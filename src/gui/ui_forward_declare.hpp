@@ -18,5 +18,7 @@ namespace gui {
     class BlockList;
     class Compute;
     class Connection;
+    class ConnectionLayer;
+    class SchemeCanvas;
     class Cursor;
 }
@@ -9,14 +9,40 @@
 #include "mainwindow.hpp"
 #include <QApplication>
 #include <QFrame>
+#include <cstdlib>
+#include <iostream>
+
+#include "../SchemeTrace.hpp"
 
 using namespace gui;
 
 int main(int argc, char *argv[])
 {
+    // BLOCKEDITOR_TRACE_FILE=<file> records trace of the session into the file
+    const char *trace = std::getenv("BLOCKEDITOR_TRACE_FILE");
+    try
+    {
+        if (trace)
+            BlockEditorLogic::CTracer::start(trace);
+    }
+    catch(BlockEditorLogic::CBlockEditorException& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
 
-    return a.exec();
+    int ret = a.exec();
+
+    try
+    {
+        BlockEditorLogic::CTracer::stop();
+    }
+    catch(BlockEditorLogic::CBlockEditorException& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+    return ret;
 }
@@ -14,6 +14,8 @@
 #include <QAction>
 #include <QMessageBox>
 #include <QSpinBox>
+#include <QFileDialog>
+#include <QFileInfo>
 #include "ui_blockscheme.hpp"
 
 using namespace gui;
@@ -73,7 +75,7 @@ void Port::mousePressEvent(QMouseEvent *event)
             // delete block
             if (ui->cursor->get_ctype() == CURSOR_DELETE)
             {
-                delete parentWidget();
+                get_block()->delete_block();
             }
             // connection creation
             else
@@ -141,6 +143,7 @@ void Port::mousePressEvent(QMouseEvent *event)
 
             QAction a_unselect("Unselect port", this);
             QAction a_setval("Set value", this);
+            QAction a_setfile("Set values from file", this);
             QAction a_editval("Edit value", this);
             QAction a_remval("Remove value", this);
             QAction a_discon("Disconnect", this);
@@ -161,6 +164,9 @@ void Port::mousePressEvent(QMouseEvent *event)
                     {
                         connect(&a_setval, SIGNAL(triggered()), this, SLOT(set_value()));
                         contextMenu.addAction(&a_setval);
+
+                        connect(&a_setfile, SIGNAL(triggered()), this, SLOT(set_value_file()));
+                        contextMenu.addAction(&a_setfile);
                     }
                     else
                     {
@@ -190,13 +196,22 @@ void Port::enterEvent(QEvent *)
     {
         QPoint p = this->mapTo(ui, this->pos());
 
-        QString val = part_of->value_to_string(get_value());
+        QString text;
+
+        // summary of the array is made on the first hover
+        if (has_value_file() && value_summary.isEmpty())
+            value_summary = ui->block_scheme->port_value_summary(this);
+
+        if (has_value_file())
+            text = "File: " + QFileInfo(value_file).fileName() + "\nValues: " + value_summary;
+        else
+            text = "Value: " + part_of->value_to_string(get_value());
 
         p.ry() -= label_value_info->height();
         p.rx() += size;
 
         label_value_info->setStyleSheet("background-color: white; border: 1px solid black; font-size:12px;");
-        label_value_info->setText("Value: " + val);
+        label_value_info->setText(text);
         label_value_info->setMargin(5);
         label_value_info->adjustSize();
         label_value_info->setAlignment(Qt::AlignCenter);
@@ -272,6 +287,7 @@ void Port::set_value()
         return;
 
     this->value = in;
+    this->value_file.clear();
     this->in_port = true;
     this->setStyleSheet(color_has_value);
 
@@ -283,6 +299,7 @@ void Port::set_value()
 void Port::set_value(double val)
 {
     this->value = val;
+    this->value_file.clear();
     this->in_port = true;
     this->setStyleSheet(color_has_value);
 
@@ -290,10 +307,69 @@ void Port::set_value(double val)
     ui->block_scheme->set_port_value(this);
 }
 
+/// Set array of values loaded from a binary or CSV file to this port.
+void Port::set_value_file()
+{
+    if (port_selected == this)
+        unselect();
+
+    QString file = QFileDialog::getOpenFileName(this->parentWidget()->parentWidget(), "Set port values",
+                                                "", "Values (*.csv *.txt *.bin);;All files (*)");
+    if (file.isEmpty())
+        return;
+
+    set_value_file(file);
+}
+
+/**
+ * @brief Set array of values to this port. Also used when loading from a save file.
+ * @param file Binary or CSV file with the values.
+ * @return True if the file was loaded.
+ */
+bool Port::set_value_file(QString file)
+{
+    this->value = 0;
+    this->value_file = file;
+    this->value_summary.clear();
+    this->in_port = true;
+
+    // set port values in the logic block scheme
+    if (!ui->block_scheme->set_port_value(this))
+    {
+        this->value_file.clear();
+        this->in_port = false;
+        return false;
+    }
+
+    this->setStyleSheet(color_has_value);
+    return true;
+}
+
+/// Show a value which is already assigned in the logic block scheme. Used when loading from a save file.
+void Port::attach_value(double val)
+{
+    this->value = val;
+    this->value_file.clear();
+    this->in_port = true;
+    this->setStyleSheet(color_has_value);
+}
+
+/// Show values from a file which are already assigned in the logic block scheme. Used when loading from a save file.
+void Port::attach_value_file(QString file)
+{
+    this->value = 0;
+    this->value_file = file;
+    this->value_summary.clear();
+    this->in_port = true;
+    this->setStyleSheet(color_has_value);
+}
+
 /// Remove input value from this port.
 void Port::remove_value()
 {
     this->value = 0;
+    this->value_file.clear();
+    this->value_summary.clear();
     this->in_port = false;
     this->setStyleSheet(color_default);
 
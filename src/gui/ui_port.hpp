@@ -57,6 +57,14 @@ namespace gui {
 
         void set_value(double val);
 
+        /// @return True if the port has values from a file assigned.
+        bool has_value_file() {return !value_file.isEmpty();}
+        QString get_value_file() {return value_file;}	///< @return File with assigned values
+
+        bool set_value_file(QString file);
+
+        void attach_value(double val);
+        void attach_value_file(QString file);
 
 
     private:
@@ -71,6 +79,8 @@ namespace gui {
 
         double value;   ///< Set value. For input port without connection.
         bool in_port = false;   ///< If the port has a value set.
+        QString value_file;     ///< File with array of values. Empty for a single value.
+        QString value_summary;  ///< Summary of the array of values, shown instead of the values.
 
 
         Port *connected_to = NULL;      ///< The other side of a connection.
@@ -90,6 +100,7 @@ namespace gui {
         void leaveEvent(QEvent *);
 
         void set_value();
+        void set_value_file();
         void remove_value();
         void edit_value();
         void disconnect_triggered();
@@ -0,0 +1,551 @@
+/**
+ *		@file 		blockeditor.cpp
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    C interface of libblockeditor, calls are passed to
+ *              CBlockScheme and its exceptions turned to return codes
+ */
+
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "blockeditor.h"
+#include "../BlockScheme.hpp"
+
+using namespace BlockEditorLogic;
+
+static_assert(sizeof(be_id) == sizeof(ID), "be_id has to hold block ID");
+static_assert(BE_ERR_RUNTIME == static_cast<int>(EErrorCode::E_RUNTIME_ERROR)
+              && BE_ERR_CYCLE == static_cast<int>(EErrorCode::E_UI_CYCLE)
+              && BE_ERR_NOT_CONNECTED == static_cast<int>(EErrorCode::E_UI_NOT_CON)
+              && BE_ERR_BAD_TYPES == static_cast<int>(EErrorCode::E_UI_BAD_TYPES)
+              && BE_ERR_BAD_FILE == static_cast<int>(EErrorCode::E_UI_BAD_FILE)
+              && BE_ERR_INTERNAL == static_cast<int>(EErrorCode::E_INTERN)
+              && BE_ERR_BAD_SIZE == static_cast<int>(EErrorCode::E_UI_BAD_SIZE)
+              && BE_ERR_CANCELLED == static_cast<int>(EErrorCode::E_CANCELLED)
+              && BE_ERR_ARITHMETIC == static_cast<int>(EErrorCode::E_ARITHMETIC),
+              "be_status has to keep values of EErrorCode");
+static_assert(BE_BLOCK_ADD == static_cast<int>(BT_ADD) && BE_BLOCK_POW == static_cast<int>(BT_POW)
+              && BE_BLOCK_SUM == static_cast<int>(BT_SUM) && BE_BLOCK_MAX == static_cast<int>(BT_MAX)
+              && BE_REDUCE_KAHAN == static_cast<int>(RM_KAHAN) && BE_REDUCE_PAIRWISE == static_cast<int>(RM_PAIRWISE),
+              "be_block_type and be_reduce_mode have to keep values of the engine");
+
+///
+/// Scheme with everything its evaluation needs between calls
+///
+struct be_scheme
+{
+  CBlockScheme              m_scheme;
+  CEvalContext              m_ctx;          /**< Buffers of evaluation, reused */
+  std::vector<InputValue>   m_inputs;       /**< Values set by be_scheme_set_inputs */
+  SnapshotPtr               m_snapshot;     /**< Snapshot with inputs replaced, null after edit */
+  bool                      m_outputsValid = false;
+  std::vector<ID>           m_outputs;      /**< Output blocks, in order of results */
+  std::unordered_map<ID, size_t> m_outputIndex; /**< Position of block in m_outputs */
+  std::vector<const CBlockAction*> m_found; /**< Result of output block, by position */
+  std::string               m_error;        /**< Message of the last error */
+};
+
+namespace
+{
+  /**
+   * @brief Remembers message of error
+   * @return The status
+   */
+  be_status fail(be_scheme *scheme, be_status status, const char *message)
+  {
+    if (scheme)
+    {
+      scheme->m_error = message;
+    }
+    return status;
+  }
+
+  /**
+   * @brief Calls function, exceptions are turned to status and message
+   * @param scheme Scheme the message is kept in
+   * @param f Function returning status
+   * @return Status returned by function or code of its exception
+   */
+  template <typename F>
+  be_status guard(be_scheme *scheme, F f)
+  {
+    if (scheme == nullptr)
+    {
+      return BE_ERR_INVALID_ARGUMENT;
+    }
+
+    try
+    {
+      return f();
+    }
+    catch (const CBlockEditorException& e)
+    {
+      return fail(scheme, static_cast<be_status>(e.getErrCode()), e.what());
+    }
+    catch (const std::bad_alloc& e)
+    {
+      return fail(scheme, BE_ERR_NO_MEMORY, "Out of memory");
+    }
+    catch (const std::exception& e)
+    {
+      return fail(scheme, BE_ERR_RUNTIME, e.what());
+    }
+    catch (...)
+    {
+      return fail(scheme, BE_ERR_UNKNOWN, "Unknown error");
+    }
+  }
+
+  /**
+   * @brief Scheme was changed, snapshot and outputs have to be found again
+   */
+  void changed(be_scheme *scheme)
+  {
+    scheme->m_snapshot.reset();
+    scheme->m_outputsValid = false;
+  }
+
+  /**
+   * @brief Finds output blocks, if the scheme was changed since last time
+   */
+  void findOutputs(be_scheme *scheme)
+  {
+    if (!scheme->m_outputsValid)
+    {
+      scheme->m_outputs = scheme->m_scheme.getOutputBlocks();
+      scheme->m_outputIndex.clear();
+      for (size_t i = 0; i < scheme->m_outputs.size(); i++)
+      {
+        scheme->m_outputIndex.emplace(scheme->m_outputs[i], i);
+      }
+      scheme->m_outputsValid = true;
+    }
+  }
+
+  /// @return True if port is one of input ports, reductions have more of them
+  bool validPort(be_port port)
+  {
+    return port >= BE_PORT_INPUT1 && static_cast<size_t>(port) <= MAX_INPUTS;
+  }
+}
+
+extern "C"
+{
+  /// @return BE_API_VERSION the library was built with
+  int be_api_version(void)
+  {
+    return BE_API_VERSION;
+  }
+
+  /**
+   * @param status Status returned by a call
+   * @return Short description of the status
+   */
+  const char *be_status_string(be_status status)
+  {
+    switch (status)
+    {
+      case BE_OK:                   return "Success";
+      case BE_ERR_UNKNOWN:          return "Unknown error";
+      case BE_ERR_RUNTIME:          return "Runtime error";
+      case BE_ERR_CYCLE:            return "Cycle in the scheme";
+      case BE_ERR_NOT_CONNECTED:    return "Input port without connection or value";
+      case BE_ERR_BAD_TYPES:        return "Types of blocks differ";
+      case BE_ERR_BAD_FILE:         return "Bad file";
+      case BE_ERR_INTERNAL:         return "Wrong call";
+      case BE_ERR_BAD_SIZE:         return "Arrays differ in length";
+      case BE_ERR_CANCELLED:        return "Cancelled";
+      case BE_ERR_NO_MEMORY:        return "Out of memory";
+      case BE_ERR_INVALID_ARGUMENT: return "Invalid argument";
+      case BE_ERR_BUFFER_TOO_SMALL: return "Buffer too small";
+      case BE_ERR_ARITHMETIC:       return "Integer overflow or division by zero";
+    }
+    return "Unknown status";
+  }
+
+  /**
+   * @brief Creates empty scheme
+   * @param scheme Where the new scheme is stored
+   */
+  be_status be_scheme_create(be_scheme **scheme)
+  {
+    if (scheme == nullptr)
+    {
+      return BE_ERR_INVALID_ARGUMENT;
+    }
+
+    try
+    {
+      *scheme = new be_scheme;
+      return BE_OK;
+    }
+    catch (...)
+    {
+      *scheme = nullptr;
+      return BE_ERR_NO_MEMORY;
+    }
+  }
+
+  /**
+   * @brief Frees the scheme, NULL is ignored
+   */
+  void be_scheme_destroy(be_scheme *scheme)
+  {
+    delete scheme;
+  }
+
+  /// @return Message of the last error of the scheme, empty if there wasnt any
+  const char *be_scheme_error(const be_scheme *scheme)
+  {
+    return scheme ? scheme->m_error.c_str() : "";
+  }
+
+  /**
+   * @brief Loads scheme saved in the file, edits saved to its journal too
+   * @param path Scheme file
+   */
+  be_status be_scheme_load_file(be_scheme *scheme, const char *path)
+  {
+    return guard(scheme, [&] {
+      if (path == nullptr)
+      {
+        return fail(scheme, BE_ERR_INVALID_ARGUMENT, "Path is NULL");
+      }
+      std::string file(path);
+      changed(scheme);
+      scheme->m_inputs.clear();
+      scheme->m_scheme.openScheme(file);
+      return BE_OK;
+    });
+  }
+
+  /**
+   * @brief Loads scheme in the save file format from memory
+   * @param data Text of the scheme, not needed after the call
+   * @param size Length of the text
+   */
+  be_status be_scheme_load_buffer(be_scheme *scheme, const char *data, size_t size)
+  {
+    return guard(scheme, [&] {
+      if (data == nullptr && size != 0)
+      {
+        return fail(scheme, BE_ERR_INVALID_ARGUMENT, "Data is NULL");
+      }
+      changed(scheme);
+      scheme->m_inputs.clear();
+      scheme->m_scheme.readScheme(data, size);
+      return BE_OK;
+    });
+  }
+
+  /**
+   * @brief Adds block without connections
+   * @param type Operation of block
+   * @param value_type Type of values on its ports
+   * @param block Where ID of the new block is stored
+   */
+  be_status be_scheme_add_block(be_scheme *scheme, be_block_type type,
+                                be_value_type value_type, be_id *block)
+  {
+    return guard(scheme, [&] {
+      if (block == nullptr || type < BE_BLOCK_ADD || type > BE_BLOCK_MAX)
+      {
+        return fail(scheme, BE_ERR_INVALID_ARGUMENT, "Bad block type or NULL block");
+      }
+      const std::string *tn = value_type == BE_VALUE_FLOAT ? &TN_FLOAT
+                            : value_type == BE_VALUE_INT ? &TN_INTEGER
+                            : value_type == BE_VALUE_HEX ? &TN_HEXA : nullptr;
+      if (tn == nullptr)
+      {
+        return fail(scheme, BE_ERR_INVALID_ARGUMENT, "Bad value type");
+      }
+      changed(scheme);
+      *block = scheme->m_scheme.addBlock(static_cast<EBlockType>(type), *tn);
+      return BE_OK;
+    });
+  }
+
+  /**
+   * @brief Connects output of one block to input port of other
+   * @param from Block whose output is connected
+   * @param to Block whose input is connected
+   * @param port Which input port
+   */
+  be_status be_scheme_connect(be_scheme *scheme, be_id from, be_id to, be_port port)
+  {
+    return guard(scheme, [&] {
+      if (!validPort(port))
+      {
+        return fail(scheme, BE_ERR_INVALID_ARGUMENT, "Bad port");
+      }
+      changed(scheme);
+      scheme->m_scheme.addPort(from, to, inputPort(port));
+      return BE_OK;
+    });
+  }
+
+  /**
+   * @brief Assigns value to input port which isnt connected
+   * @param block Block with the port
+   * @param port Which input port
+   * @param value The value
+   */
+  be_status be_scheme_set_value(be_scheme *scheme, be_id block, be_port port, double value)
+  {
+    return guard(scheme, [&] {
+      if (!validPort(port))
+      {
+        return fail(scheme, BE_ERR_INVALID_ARGUMENT, "Bad port");
+      }
+      if (!scheme->m_scheme.hasBlock(block))
+      {
+        return fail(scheme, BE_ERR_INTERNAL, ("Block " + std::to_string(block) + " doesnt exist").c_str());
+      }
+      changed(scheme);
+      scheme->m_scheme.addInputValue(block, value, inputPort(port));
+      return BE_OK;
+    });
+  }
+
+  /**
+   * @brief Sets count of input ports of reduction block
+   * @param block Reduction block
+   * @param count Count of inputs, 2 at least
+   */
+  be_status be_scheme_set_input_count(be_scheme *scheme, be_id block, size_t count)
+  {
+    return guard(scheme, [&] {
+      changed(scheme);
+      scheme->m_scheme.setInputCount(block, count);
+      return BE_OK;
+    });
+  }
+
+  /**
+   * @brief Sets order in which SUM block adds its inputs
+   * @param block SUM block
+   * @param mode Order of summation
+   */
+  be_status be_scheme_set_reduce_mode(be_scheme *scheme, be_id block, be_reduce_mode mode)
+  {
+    return guard(scheme, [&] {
+      if (mode < BE_REDUCE_PLAIN || mode > BE_REDUCE_PAIRWISE)
+      {
+        return fail(scheme, BE_ERR_INVALID_ARGUMENT, "Bad reduce mode");
+      }
+      changed(scheme);
+      scheme->m_scheme.setReduceMode(block, static_cast<EReduceMode>(mode));
+      return BE_OK;
+    });
+  }
+
+  /**
+   * @brief Collapses chains of ADD and MUL blocks, see
+   *        CBlockScheme::collapseReductions. Values set by
+   *        be_scheme_set_inputs are removed, their blocks may be gone.
+   * @param removed Where count of removed blocks is stored, may be NULL
+   */
+  be_status be_scheme_collapse(be_scheme *scheme, size_t *removed)
+  {
+    return guard(scheme, [&] {
+      changed(scheme);
+      scheme->m_inputs.clear();
+      size_t count = scheme->m_scheme.collapseReductions();
+      if (removed)
+      {
+        *removed = count;
+      }
+      return BE_OK;
+    });
+  }
+
+  /**
+   * @brief Defines macro from blocks of the scheme, see
+   *        CBlockScheme::defineMacro
+   * @param name Name of macro
+   * @param blocks Blocks of the body
+   * @param count Count of blocks
+   * @param inputs Where count of inputs of macro is stored, may be NULL
+   */
+  be_status be_scheme_define_macro(be_scheme *scheme, const char *name,
+                                   const be_id *blocks, size_t count, size_t *inputs)
+  {
+    return guard(scheme, [&] {
+      if (name == nullptr || (blocks == nullptr && count != 0))
+      {
+        return fail(scheme, BE_ERR_INVALID_ARGUMENT, "Name or blocks are NULL");
+      }
+      size_t n = scheme->m_scheme.defineMacro(name, std::vector<ID>(blocks, blocks + count));
+      if (inputs)
+      {
+        *inputs = n;
+      }
+      return BE_OK;
+    });
+  }
+
+  /**
+   * @brief Adds instance of macro
+   * @param name Name of defined macro
+   * @param block Where ID of new block is stored
+   */
+  be_status be_scheme_add_macro(be_scheme *scheme, const char *name, be_id *block)
+  {
+    return guard(scheme, [&] {
+      if (name == nullptr || block == nullptr)
+      {
+        return fail(scheme, BE_ERR_INVALID_ARGUMENT, "NULL name or block");
+      }
+      changed(scheme);
+      *block = scheme->m_scheme.addMacroBlock(name);
+      return BE_OK;
+    });
+  }
+
+  /**
+   * @brief Sets values replacing the assigned ones in following evaluations,
+   *        see CBlockScheme::withInputs. Inputs stay as they were on error.
+   * @param inputs Ports and their values
+   * @param count Count of inputs, 0 removes all
+   */
+  be_status be_scheme_set_inputs(be_scheme *scheme, const be_input *inputs, size_t count)
+  {
+    return guard(scheme, [&] {
+      if (inputs == nullptr && count != 0)
+      {
+        return fail(scheme, BE_ERR_INVALID_ARGUMENT, "Inputs are NULL");
+      }
+
+      std::vector<InputValue> values(count);
+      for (size_t i = 0; i < count; i++)
+      {
+        if (!validPort(inputs[i].port))
+        {
+          return fail(scheme, BE_ERR_INVALID_ARGUMENT, "Bad port");
+        }
+        values[i] = InputValue{inputs[i].block, inputPort(inputs[i].port), inputs[i].value};
+      }
+
+      scheme->m_scheme.snapshot();
+      scheme->m_snapshot = scheme->m_scheme.withInputs(values);
+      scheme->m_inputs = std::move(values);
+      return BE_OK;
+    });
+  }
+
+  /**
+   * @brief Lists output blocks
+   * @param blocks Where IDs are written, may be NULL if capacity is 0
+   * @param capacity Size of blocks
+   * @param count Where count of output blocks is stored
+   */
+  be_status be_scheme_outputs(be_scheme *scheme, be_id *blocks, size_t capacity, size_t *count)
+  {
+    return guard(scheme, [&] {
+      if (count == nullptr || (blocks == nullptr && capacity != 0))
+      {
+        return fail(scheme, BE_ERR_INVALID_ARGUMENT, "Bad buffer");
+      }
+      findOutputs(scheme);
+      *count = scheme->m_outputs.size();
+      if (capacity < scheme->m_outputs.size())
+      {
+        return fail(scheme, BE_ERR_BUFFER_TOO_SMALL, "Buffer of output blocks is too small");
+      }
+      std::copy(scheme->m_outputs.begin(), scheme->m_outputs.end(), blocks);
+      return BE_OK;
+    });
+  }
+
+  /**
+   * @brief Evaluates the scheme, results are written in order of output
+   *        blocks, values of arrays one after another
+   * @param results Where results are written
+   * @param result_capacity Size of results
+   * @param values Where values of results are written
+   * @param value_capacity Size of values
+   * @param result_count Where count of results is stored, may be NULL
+   * @param value_count Where count of values is stored, may be NULL
+   */
+  be_status be_scheme_evaluate(be_scheme *scheme,
+                               be_result *results, size_t result_capacity,
+                               double *values, size_t value_capacity,
+                               size_t *result_count, size_t *value_count)
+  {
+    return guard(scheme, [&] {
+      if ((results == nullptr && result_capacity != 0) || (values == nullptr && value_capacity != 0))
+      {
+        return fail(scheme, BE_ERR_INVALID_ARGUMENT, "Bad buffer");
+      }
+
+      findOutputs(scheme);
+      size_t outputs = scheme->m_outputs.size();
+      if (!scheme->m_snapshot)
+      {
+        scheme->m_scheme.snapshot();
+        scheme->m_snapshot = scheme->m_scheme.withInputs(scheme->m_inputs);
+      }
+      scheme->m_snapshot->run(scheme->m_ctx);
+
+      // Results of output blocks, in order of outputs
+      std::vector<const CBlockAction*>& found = scheme->m_found;
+      found.assign(outputs, nullptr);
+      for (auto& it : scheme->m_ctx.getActions())
+      {
+        auto index = scheme->m_outputIndex.find(it.getID());
+        if (index != scheme->m_outputIndex.end())
+        {
+          found[index->second] = &it;
+        }
+      }
+
+      size_t needed = 0;
+      for (size_t i = 0; i < outputs; i++)
+      {
+        if (found[i] == nullptr)
+        {
+          throw CBlockEditorException("Block " + std::to_string(scheme->m_outputs[i]) + " has no result",
+                                      EErrorCode::E_INTERN);
+        }
+        needed += found[i]->hasArray() ? found[i]->getArray()->size() : 1;
+      }
+
+      if (result_count)
+      {
+        *result_count = outputs;
+      }
+      if (value_count)
+      {
+        *value_count = needed;
+      }
+      if (result_capacity < outputs || value_capacity < needed)
+      {
+        return fail(scheme, BE_ERR_BUFFER_TOO_SMALL, "Buffer of results is too small");
+      }
+
+      size_t offset = 0;
+      for (size_t i = 0; i < outputs; i++)
+      {
+        const CBlockAction& a = *found[i];
+        results[i].block = a.getID();
+        results[i].offset = offset;
+        if (a.hasArray())
+        {
+          const PortArray& array = *a.getArray();
+          std::copy(array.begin(), array.end(), values + offset);
+          results[i].count = array.size();
+        }
+        else
+        {
+          values[offset] = a.getValue();
+          results[i].count = 1;
+        }
+        offset += results[i].count;
+      }
+      return BE_OK;
+    });
+  }
+}
@@ -0,0 +1,171 @@
+/**
+ *		@file 		blockeditor.h
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    C interface of libblockeditor, the block engine without GUI
+ *              for embedding in other programs
+ *
+ * All functions return BE_OK or a negative error code, C++ exceptions never
+ * leave the library. Codes of the engine keep their values (see EErrorCode),
+ * be_scheme_error() describes the last error of a scheme.
+ *
+ * A scheme may be used by one thread at a time, different schemes by
+ * different threads at once. Evaluation reuses buffers of the scheme, so
+ * repeated calls allocate only for the results.
+ */
+
+#ifndef BLOCKEDITOR_H
+#define BLOCKEDITOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__GNUC__)
+#define BE_API __attribute__((visibility("default")))
+#else
+#define BE_API
+#endif
+
+/** Version of this interface, incremented by incompatible changes */
+#define BE_API_VERSION 1
+
+/** Results of calls */
+typedef enum be_status
+{
+  BE_OK                   =   0,
+  BE_ERR_UNKNOWN          =  -1,  /**< Error not known to the engine */
+  BE_ERR_RUNTIME          =  -2,
+  BE_ERR_CYCLE            =  -3,  /**< There is a cycle in the scheme */
+  BE_ERR_NOT_CONNECTED    =  -4,  /**< Input port has neither a connection nor a value */
+  BE_ERR_BAD_TYPES        =  -5,  /**< Connected blocks have different value types */
+  BE_ERR_BAD_FILE         =  -6,  /**< Scheme or array file cant be read */
+  BE_ERR_INTERNAL         =  -7,  /**< Wrong call, e.g. block doesnt exist */
+  BE_ERR_BAD_SIZE         =  -8,  /**< Arrays on inputs of block differ in length */
+  BE_ERR_CANCELLED        =  -9,
+  BE_ERR_NO_MEMORY        = -10,
+  BE_ERR_INVALID_ARGUMENT = -11,  /**< NULL pointer or value out of range */
+  BE_ERR_BUFFER_TOO_SMALL = -12,  /**< Results dont fit, sizes needed are returned */
+  BE_ERR_ARITHMETIC       = -13   /**< Overflow or division by zero in INT or HEX block */
+} be_status;
+
+/** Operation of block */
+typedef enum be_block_type
+{
+  BE_BLOCK_ADD = 1,
+  BE_BLOCK_SUB,
+  BE_BLOCK_MUL,
+  BE_BLOCK_DIV,
+  BE_BLOCK_POW,
+  BE_BLOCK_SUM,                 /**< Reductions of any number of inputs, 2 by default */
+  BE_BLOCK_PRODUCT,
+  BE_BLOCK_MIN,
+  BE_BLOCK_MAX
+} be_block_type;
+
+/** Order in which SUM block adds its inputs */
+typedef enum be_reduce_mode
+{
+  BE_REDUCE_PLAIN = 0,          /**< Left to right */
+  BE_REDUCE_KAHAN,              /**< Compensated summation */
+  BE_REDUCE_PAIRWISE
+} be_reduce_mode;
+
+/** Type of values on ports of block. INT and HEX blocks compute in 64 bit
+ *  integers (operands truncated, division rounds toward zero), values are
+ *  returned as doubles, so they are exact up to 2^53. */
+typedef enum be_value_type
+{
+  BE_VALUE_FLOAT = 0,
+  BE_VALUE_INT,
+  BE_VALUE_HEX
+} be_value_type;
+
+/** Input port of block, input n of reduction block is port n */
+typedef enum be_port
+{
+  BE_PORT_INPUT1 = 1,
+  BE_PORT_INPUT2 = 2
+} be_port;
+
+typedef uint32_t be_id;
+
+/** Value replacing the one assigned to input port, see be_scheme_set_inputs */
+typedef struct be_input
+{
+  be_id         block;
+  be_port       port;
+  double        value;
+} be_input;
+
+/** Result of output block, values[offset] to values[offset + count - 1] */
+typedef struct be_result
+{
+  be_id         block;
+  size_t        offset;
+  size_t        count;          /**< 1 for scalar results */
+} be_result;
+
+typedef struct be_scheme be_scheme;
+
+BE_API int          be_api_version(void);
+BE_API const char  *be_status_string(be_status status);
+
+BE_API be_status    be_scheme_create(be_scheme **scheme);
+BE_API void         be_scheme_destroy(be_scheme *scheme);
+BE_API const char  *be_scheme_error(const be_scheme *scheme);
+
+/* Loading replaces all blocks of the scheme */
+BE_API be_status    be_scheme_load_file(be_scheme *scheme, const char *path);
+BE_API be_status    be_scheme_load_buffer(be_scheme *scheme, const char *data, size_t size);
+
+/* Editing */
+BE_API be_status    be_scheme_add_block(be_scheme *scheme, be_block_type type,
+                                        be_value_type value_type, be_id *block);
+BE_API be_status    be_scheme_connect(be_scheme *scheme, be_id from, be_id to, be_port port);
+BE_API be_status    be_scheme_set_value(be_scheme *scheme, be_id block, be_port port, double value);
+
+/* Reduction blocks. Ports dropped by set_input_count must not be connected,
+ * collapse replaces left-deep chains of FLOAT ADD (MUL) blocks by SUM (PRODUCT) blocks
+ * and stores count of removed blocks to removed (if not NULL), it removes
+ * values set by be_scheme_set_inputs too. */
+BE_API be_status    be_scheme_set_input_count(be_scheme *scheme, be_id block, size_t count);
+BE_API be_status    be_scheme_set_reduce_mode(be_scheme *scheme, be_id block, be_reduce_mode mode);
+BE_API be_status    be_scheme_collapse(be_scheme *scheme, size_t *removed);
+
+/* Macros, sub-schemes stored once and instanced by macro blocks. Body is
+ * defined from blocks of the scheme, which are kept: values of their ports
+ * become constants, ports free or connected to other blocks become inputs
+ * 1 to n of the macro in order of blocks and ports, the block whose output
+ * isnt connected to the others is the output. Count of inputs is stored to
+ * inputs (if not NULL). Instances connect like other blocks. */
+BE_API be_status    be_scheme_define_macro(be_scheme *scheme, const char *name,
+                                           const be_id *blocks, size_t count, size_t *inputs);
+BE_API be_status    be_scheme_add_macro(be_scheme *scheme, const char *name, be_id *block);
+
+/* Values used by following evaluations instead of the ones assigned to the
+ * ports, the scheme isnt changed. Ports must have a value assigned. Count 0
+ * removes them. */
+BE_API be_status    be_scheme_set_inputs(be_scheme *scheme, const be_input *inputs, size_t count);
+
+/* Blocks whose output isnt connected, in order of their results */
+BE_API be_status    be_scheme_outputs(be_scheme *scheme, be_id *blocks, size_t capacity,
+                                      size_t *count);
+
+/* Evaluates the scheme. Results of all output blocks are written to
+ * results, their values to values. If either doesnt fit, nothing is written,
+ * BE_ERR_BUFFER_TOO_SMALL is returned and result_count/value_count (if not
+ * NULL) hold the sizes needed. */
+BE_API be_status    be_scheme_evaluate(be_scheme *scheme,
+                                       be_result *results, size_t result_capacity,
+                                       double *values, size_t value_capacity,
+                                       size_t *result_count, size_t *value_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLOCKEDITOR_H */
@@ -0,0 +1,128 @@
+/**
+ *		@file 		libbench_main.c
+ *		@date 		19/10/2026
+ *		@author 	Filip Kocica <xkocic01@fit.vutbr.cz>
+ *		@brief    Micro-benchmark of calls of libblockeditor, written in C
+ *              so it uses the library the same way embedding programs do
+ *
+ * For chains of growing length it measures one evaluation, and one
+ * evaluation after replacing an input value. Time of the shortest chain is
+ * the fixed cost of a call, the rest grows with blocks.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "blockeditor.h"
+
+/** Results of the longest chain */
+#define MAX_BLOCKS 4096
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void check(be_scheme *scheme, be_status status, const char *what)
+{
+  if (status != BE_OK)
+  {
+    fprintf(stderr, "%s: %s (%s)\n", what, be_status_string(status), be_scheme_error(scheme));
+    exit(1);
+  }
+}
+
+/**
+ * @brief Builds chain of ADD blocks, the first gets values on both ports,
+ *        the others on port 2
+ */
+static be_scheme *make_chain(size_t blocks, be_id *first)
+{
+  be_scheme *scheme;
+  be_id prev = 0, id;
+  size_t i;
+
+  check(NULL, be_scheme_create(&scheme), "create");
+  for (i = 0; i < blocks; i++)
+  {
+    check(scheme, be_scheme_add_block(scheme, BE_BLOCK_ADD, BE_VALUE_FLOAT, &id), "add block");
+    if (i == 0)
+    {
+      *first = id;
+      check(scheme, be_scheme_set_value(scheme, id, BE_PORT_INPUT1, 1.0), "set value");
+    }
+    else
+    {
+      check(scheme, be_scheme_connect(scheme, prev, id, BE_PORT_INPUT1), "connect");
+    }
+    check(scheme, be_scheme_set_value(scheme, id, BE_PORT_INPUT2, 0.5), "set value");
+    prev = id;
+  }
+  return scheme;
+}
+
+/**
+ * @brief Evaluates the scheme until at least 0.2s passed
+ * @param inputs Value of the first input is replaced before each evaluation
+ * @return Nanoseconds per evaluation
+ */
+static double measure(be_scheme *scheme, be_id first, int inputs)
+{
+  be_result result;
+  double value;
+  be_input in;
+  long calls = 0, batch = 16, i;
+  double start = now(), elapsed;
+
+  in.block = first;
+  in.port = BE_PORT_INPUT1;
+  do
+  {
+    for (i = 0; i < batch; i++, calls++)
+    {
+      if (inputs)
+      {
+        in.value = (double) calls;
+        check(scheme, be_scheme_set_inputs(scheme, &in, 1), "set inputs");
+      }
+      check(scheme, be_scheme_evaluate(scheme, &result, 1, &value, 1, NULL, NULL), "evaluate");
+    }
+    batch *= 2;
+    elapsed = now() - start;
+  } while (elapsed < 0.2e9);
+
+  return elapsed / calls;
+}
+
+int main(void)
+{
+  size_t blocks;
+  long i, calls = 10000000;
+  volatile int sink = 0;
+  double start;
+
+  start = now();
+  for (i = 0; i < calls; i++)
+  {
+    sink += be_api_version();
+  }
+  printf("be_api_version: %.1f ns/call\n\n", (now() - start) / calls);
+
+  printf("%8s %14s %14s %16s\n", "blocks", "evaluate ns", "ns/block", "with input ns");
+  for (blocks = 1; blocks <= MAX_BLOCKS; blocks *= 4)
+  {
+    be_id first;
+    be_scheme *scheme = make_chain(blocks, &first);
+    double plain = measure(scheme, first, 0);
+    double inputs = measure(scheme, first, 1);
+
+    printf("%8zu %14.0f %14.1f %16.0f\n", blocks, plain, plain / blocks, inputs);
+    be_scheme_destroy(scheme);
+  }
+  return 0;
+}